@@ -92,6 +92,17 @@ outputs:
 - domain: message
   id: async_msgs
   optional: true
+- domain: message
+  id: command
+  optional: true
+% endif
+- domain: message
+  id: status
+  optional: true
+% if sourk == 'source':
+- domain: message
+  id: spectrum
+  optional: true
 % endif
 
 templates:
@@ -171,6 +182,8 @@ documentation: |-
   % if sourk == 'sink':
    * gnuradio .cfile output through libgnuradio-blocks
   % endif
+   * Other local flowgraphs through shared memory
+   * VITA-49 signal data packets over UDP
    * CCCamp 2015 rad1o Badge through libhackrf
    * Great Scott Gadgets HackRF through libhackrf
    * Nuand LLC bladeRF through libbladeRF library
@@ -202,6 +215,7 @@ documentation: |-
     rtl_tcp=127.0.0.1:1234[,psize=16384][,direct_samp=0|1|2][,offset_tune=0|1][,bias=0|1] ...
     osmosdr=0[,buffers=32][,buflen=N*512] ...
     file='/path/to/your file',rate=1e6[,freq=100e6][,repeat=true][,throttle=true] ...
+    file='/path/to/archive',archive[,begin=-600][,end=0][,throttle=true] ...
     netsdr=127.0.0.1[:50000][,nchan=2]
     sdr-ip=127.0.0.1[:50000]
     cloudiq=127.0.0.1[:50000]
@@ -209,9 +223,26 @@ documentation: |-
     airspy=0[,bias=0|1][,linearity][,sensitivity]
     airspyhf=0[,bias=0|1][,linearity][,sensitivity]
     spyserver=0,ip=192.168.0.10[,port=5555]
+    rtl|hackrf|airspy|miri|osmosdr=0,record='/path/to/capture.sigmf-data'[,record_only=0|1]
+    rtl|hackrf|airspy|bladerf=0[,fast][,timing] ...
+    rtl|hackrf|airspy=0[,linger=5] ...
+    rtl|hackrf|airspy|bladerf|soapy=0,hop[,settle=0.005] ...
+    rtl|hackrf|airspy|bladerf|soapy=0,nco[=0.8] ...
+    rtl|hackrf|airspy|bladerf|soapy=0,channels=-300e3:25e3;125e3:12.5e3[;...] ...
+    rtl|hackrf|airspy|bladerf|soapy=0,rate_mode=native|exact ...
+    rtl|rtl_tcp|hackrf|airspy|osmosdr=0,decim=1|2|4|8|16|32|64 ...
+    rtl|hackrf=0[,soft_agc=0|1][,stats=0|1] ...
+    rtl|hackrf|airspy|bladerf|soapy=0,squelch=-40[,hang=0.1][,preroll=0.01] ...
+    rtl|hackrf|airspy|bladerf|soapy=0,spectrum=1024[,spectrum_rate=10][,spectrum_avg=4] ...
+    shm=name[,control=0|1]
+    vrt|udp=[host:]49152[,nchan=2][,stream=0][,format=sc16|sc8|cf32][,mtu=9000][,batch=32][,buffer=1048576] ...
   % endif
   % if sourk == 'sink':
     file='/path/to/your file',rate=1e6[,freq=100e6][,append=true][,throttle=true] ...
+    file='/path/to/capture.cf32',rate=1e6,pre=2,post=10[,tag=trigger][,threshold=-30][,format=cf32|sc16|sc8] ...
+    file='/path/to/archive',archive,rate=1e6[,freq=100e6][,segment=60][,retain=86400][,retain_bytes=100e9][,format=cf32|sc16|sc8] ...
+    shm=name,rate=1e6[,freq=100e6][,size=4194304][,format=cf32|sc16|sc8] ...
+    vrt|udp=host:49152,rate=1e6[,freq=100e6][,nchan=2][,stream=0][,format=sc16|sc8|cf32][,mtu=1500][,context=1] ...
   % endif
     redpitaya=192.168.1.100[:1001]
     freesrp=0[,fx3='path/to/fx3.img',fpga='path/to/fpga.bin',loopback]
@@ -219,6 +250,44 @@ documentation: |-
     bladerf=0[,tamer=internal|external|external_1pps][,smb=25e6]
     uhd[,serial=...][,lo_offset=0][,mcr=52e6][,nchan=2][,subdev='\\\\'B:0 A:0\\\\''] ...
 
+  % if sourk == 'sink':
+  With pre and/or post given, the file sink keeps the last pre seconds in memory and writes them together with the following post seconds to a new numbered file whenever it is triggered by a stream tag (key given by tag), a 'trigger' message on the command port or the input power exceeding threshold (in dBFS).
+
+  With archive, the file sink keeps a rolling recording in segments of the given duration (in seconds) inside the given directory. The oldest segments are overwritten once retain seconds or retain_bytes bytes are reached. A file source with archive plays back the time range between begin and end (seconds since the epoch, 0 for the oldest/newest sample, negative values count back from the newest sample).
+
+  With shm, the sink publishes the samples, tags, rate and frequency in a shared memory ring (size in samples) which any number of shm sources in other local processes can read from. Requests of sources opened with control=1 are emitted as dictionaries on the command output, connect it to the command input of the block owning the device.
+
+  % endif
+  % if sourk == 'source':
+  The record argument writes the samples in the native format of the device (before conversion to complex float) to the given file, along with a SigMF metadata file. A change of the sample rate continues the recording in a new file numbered -1, -2 and so on. With record_only=1 the block produces no samples and only records.
+
+  With fast, rtl, hackrf and airspy devices hold back their default settings until the flowgraph starts and skip those set explicitly until then. Devices opened with fast are also opened in parallel. With timing, the time spent opening, loading firmware, configuring and waiting for the first sample is printed on the console.
+
+  With linger, an rtl, hackrf or airspy device stays open for the given number of seconds after its block is destroyed. A block created for the same device within that time takes it over without reopening it, and settings already sent to the device are not sent again.
+
+  With hop, each channel can be given a frequency hopping schedule through set_hop_schedule(). Samples received while the tuner settles after a hop are dropped, the settle time being a typical one for the tuner of the device unless given in seconds with settle.
+
+  With nco, a center frequency within the given share of the passband around the frequency the hardware is tuned to is reached by mixing the samples in software, which takes microseconds instead of a PLL retune. The first sample mixed with the new frequency is tagged with rx_freq. The hardware is only retuned once the frequency leaves that window.
+
+  With channels, the device feeds a filterbank producing one output per channel given as offset:bandwidth (in Hz, the offset relative to the center frequency), so set the number of channels accordingly. Each output is decimated by the largest power of two leaving at least 1.25 times its bandwidth, its rate is given by an rx_rate tag on its first sample. All channels are filtered out of one FFT of the wideband stream, with many channels the work is spread over several threads. Settings of any of the channels apply to the device.
+
+  With decim, the samples are decimated by the given power of two with a cascade of half-band filters working on the integers delivered by the device, so only the decimated samples are converted to complex float. The device runs at the sample rate set multiplied by decim. An airspy device opened with decim streams its raw real samples, which are translated by a quarter of their rate and decimated to complex ones by the same filters instead of by libairspy, and records them in that form.
+
+  rtl, rtl_tcp, hackrf, airspy and miri devices remove the DC offset and correct the IQ imbalance in software while converting their samples, as set by the DC offset and IQ balance modes. The automatic modes estimate the corrections on one buffer out of eight.
+
+  With soft_agc=1, the automatic gain mode of rtl and hackrf devices is run on the host from the peak and the clipping of the raw samples, measured over windows of 50 ms. The gain steps down through the gains of the tuner (rtl) or the LNA and VGA gains (hackrf) as soon as samples clip and steps up while the peak stays below -12 dBFS, waiting 250 ms after each step. Each step is tagged with rx_gain, which carries the total of the amplifier, LNA and VGA gains on a hackrf. With stats=1, the stream is tagged with rx_stats once per window, a dictionary of the peak and mean power in dBFS and the share of clipped samples.
+
+  With squelch, each channel only outputs bursts of activity: a burst starts with the first millisecond of samples whose mean power reaches the given threshold (in dBFS) and ends once the power stayed below it for hang seconds. The preroll seconds of samples ahead of it are included. The first sample of a burst is tagged with burst_start and its rx_time, the last one with burst_end. Tags of the samples dropped in between are repeated at the start of the next burst.
+
+  With spectrum, power spectra of the given FFT size are published on the spectrum output, spectrum_rate times a second for each device channel, each averaged over spectrum_avg FFTs. Only the samples of those FFTs are taken from the stream, and the FFTs are computed on a thread of their own. Each message is a pair of a dictionary of chan, freq, rate and size and of the power of the bins in dBFS, from the lowest frequency to the highest.
+
+  % endif
+  With rate_mode=exact, any sample rate can be set: the device runs at the lowest rate it supports at or above it, and each channel is resampled to the exact rate asked for. Devices of a group may differ in the rates they support and still run at a common rate. Resampled channels tag their rate with rx_rate.
+
+  Settings can also be sent as dictionaries to the command input, with any of freq, rate, gain (of the stage given by gain_name, overall otherwise), antenna, bw, chan (0 by default) and time (device time in seconds to apply them at). They are applied in order on a thread of their own, and the values the device settled on are reported on the status output, or an error.
+
+  The vrt (or udp) device exchanges VITA-49 IF data packets, one stream id per channel counting up from stream, with context packets carrying frequency, rate and sample format. The source binds to the given port (joining the group for multicast hosts), reports packet timestamps as rx_time tags and reports lost packets with a D on the console. mtu limits the packet size in bytes.
+
   Num Channels:
   Selects the total number of channels in this multi-device configuration. Required when specifying multiple device arguments.
 
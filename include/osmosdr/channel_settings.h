@@ -0,0 +1,63 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_OSMOSDR_CHANNEL_SETTINGS_H
+#define INCLUDED_OSMOSDR_CHANNEL_SETTINGS_H
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace osmosdr {
+
+  /*!
+   * The operating point of a channel, applied in one go by configure().
+   * Settings left at NaN (or an empty antenna) are not changed. The
+   * settings returned by configure() carry the actual values of the
+   * settings that were given.
+   */
+  struct channel_settings
+  {
+    channel_settings() :
+      sample_rate( std::numeric_limits< double >::quiet_NaN() ),
+      center_freq( std::numeric_limits< double >::quiet_NaN() ),
+      gain( std::numeric_limits< double >::quiet_NaN() ),
+      if_gain( std::numeric_limits< double >::quiet_NaN() ),
+      bb_gain( std::numeric_limits< double >::quiet_NaN() ),
+      bandwidth( std::numeric_limits< double >::quiet_NaN() )
+    {
+    }
+
+    double sample_rate; //!< in Sps, shared by all channels of a device
+    double center_freq; //!< in Hz
+    double gain;        //!< overall gain in dB
+    double if_gain;     //!< IF gain in dB
+    double bb_gain;     //!< baseband gain in dB
+    double bandwidth;   //!< in Hz, 0 selects the filter automatically
+    std::string antenna;
+
+    static bool is_set( double value ) { return ! std::isnan( value ); }
+  };
+
+} // namespace osmosdr
+
+#endif /* INCLUDED_OSMOSDR_CHANNEL_SETTINGS_H */
@@ -104,6 +104,12 @@ namespace osmosdr {
      * The device hint "nofake" switches off dummy devices created
      * by "file" (and other) implementations.
      *
+     * Backends are probed in parallel. A hint naming device types
+     * (e.g. "rtl" or "uhd") only probes those, "nosoftware" skips the
+     * software-only ones. Probes are given "timeout=<seconds>" to
+     * answer, their results are cached for "ttl=<seconds>" or until
+     * a usb device is plugged, and "nocache" forces a fresh search.
+     *
      * \param hint a partially (or fully) filled in logical device
      * \return a vector of logical devices for all radios on the system
      */
@@ -0,0 +1,55 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_OSMOSDR_HOP_H
+#define INCLUDED_OSMOSDR_HOP_H
+
+#include <limits>
+#include <vector>
+
+#include <cstddef>
+
+namespace osmosdr {
+
+  /*!
+   * One step of a frequency hopping schedule: the channel is tuned to freq
+   * and, once the tuner has settled, passes dwell samples tagged with
+   * rx_freq before moving on to the next step.
+   */
+  struct hop_t
+  {
+    hop_t( double freq = 0, size_t dwell = 0,
+           double gain = std::numeric_limits< double >::quiet_NaN() ) :
+      freq( freq ), dwell( dwell ), gain( gain )
+    {
+    }
+
+    double freq;  //!< center frequency in Hz
+    size_t dwell; //!< number of samples to pass at freq
+    double gain;  //!< overall gain in dB, NaN to keep the current one
+  };
+
+  typedef std::vector< hop_t > hop_schedule_t;
+
+} // namespace osmosdr
+
+#endif /* INCLUDED_OSMOSDR_HOP_H */
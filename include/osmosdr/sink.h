@@ -23,6 +23,7 @@
 #include <osmosdr/api.h>
 #include <osmosdr/ranges.h>
 #include <osmosdr/time_spec.h>
+#include <osmosdr/channel_settings.h>
 #include <gnuradio/hier_block2.h>
 
 namespace osmosdr {
@@ -34,6 +35,11 @@ class sink;
  * \ingroup block
  *
  * This uses the preferred technique: subclassing gr::hier_block2.
+ *
+ * Settings can also be sent as a dictionary (freq, rate, gain, gain_name,
+ * antenna, bw, chan, time) to the "command" message port. They are applied
+ * on a thread of their own, and the values the device settled on are
+ * published as a dictionary on the "status" message port.
  */
 class OSMOSDR_API sink : virtual public gr::hier_block2
 {
@@ -67,6 +73,10 @@ public:
   /*!
    * Set the sample rate for the underlying radio hardware.
    * This also will select the appropriate IF bandpass, if applicable.
+   *
+   * With the rate_mode=exact device argument any rate is accepted, the
+   * hardware runs at the closest native rate above it and the samples
+   * are resampled to there.
    * \param rate a new rate in Sps
    */
   virtual double set_sample_rate( double rate ) = 0;
@@ -275,6 +285,17 @@ public:
    */
   virtual osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 ) = 0;
 
+  /*!
+   * Apply several settings of a channel as one transaction. Devices able
+   * to do so program them in a single pass and skip values they already
+   * have, the others have them applied one after the other.
+   * \param settings the settings to change, the others are left alone
+   * \param chan the channel index 0 to N-1
+   * \return the actual values of the given settings
+   */
+  virtual osmosdr::channel_settings configure( const osmosdr::channel_settings &settings,
+                                               size_t chan = 0 ) = 0;
+
   /*!
    * Set the time source for the device.
    * This sets the method of time synchronization,
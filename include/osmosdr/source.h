@@ -23,8 +23,12 @@
 #include <osmosdr/api.h>
 #include <osmosdr/ranges.h>
 #include <osmosdr/time_spec.h>
+#include <osmosdr/channel_settings.h>
+#include <osmosdr/hop.h>
 #include <gnuradio/hier_block2.h>
 
+#include <boost/thread/future.hpp>
+
 namespace osmosdr {
 
 class source;
@@ -34,6 +38,17 @@ class source;
  * \ingroup block
  *
  * This uses the preferred technique: subclassing gr::hier_block2.
+ *
+ * The rtl, hackrf, airspy, airspyhf, miri, rfspace, spyserver and file
+ * devices tag the first sample received after a change of the center
+ * frequency, sample rate or overall gain with rx_freq, rx_rate or rx_gain,
+ * carrying the new value as a double. The hackrf tags its LNA and VGA gains
+ * with rx_if_gain and rx_bb_gain in the same way.
+ *
+ * Settings can also be sent as a dictionary (freq, rate, gain, gain_name,
+ * antenna, bw, chan, time) to the "command" message port. They are applied
+ * on a thread of their own, and the values the device settled on are
+ * published as a dictionary on the "status" message port.
  */
 class OSMOSDR_API source : virtual public gr::hier_block2
 {
@@ -76,6 +91,10 @@ public:
   /*!
    * Set the sample rate for the underlying radio hardware.
    * This also will select the appropriate IF bandpass, if applicable.
+   *
+   * With the rate_mode=exact device argument any rate is accepted, the
+   * hardware runs at the closest native rate above it and the samples
+   * are resampled from there.
    * \param rate a new rate in Sps
    */
   virtual double set_sample_rate( double rate ) = 0;
@@ -97,6 +116,10 @@ public:
   /*!
    * Tune the underlying radio hardware to the desired center frequency.
    * This also will select the appropriate RF bandpass.
+   *
+   * With the nco device argument, frequencies close enough to the one the
+   * hardware is tuned to are reached with a digital oscillator instead,
+   * without retuning the hardware.
    * \param freq the desired frequency in Hz
    * \param chan the channel index 0 to N-1
    * \return the actual frequency in Hz
@@ -319,6 +342,22 @@ public:
    */
   virtual osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 ) = 0;
 
+  /*!
+   * Apply several settings of a channel as one transaction. Devices able
+   * to do so program them in a single pass and skip values they already
+   * have, the others have them applied one after the other. The rtl,
+   * hackrf, airspy, bladerf and soapy devices tag the following output
+   * with a single rx_retune tag carrying a dictionary of the actual values,
+   * in place of the rx_freq, rx_rate and rx_gain tags of the individual
+   * setters. The rtl, hackrf and airspy devices put it on the first sample
+   * received after the settings were applied.
+   * \param settings the settings to change, the others are left alone
+   * \param chan the channel index 0 to N-1
+   * \return the actual values of the given settings
+   */
+  virtual osmosdr::channel_settings configure( const osmosdr::channel_settings &settings,
+                                               size_t chan = 0 ) = 0;
+
   /*!
    * Set the time source for the device.
    * This sets the method of time synchronization,
@@ -416,6 +455,33 @@ public:
    */
   virtual void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec) = 0;
 
+  /*!
+   * Set the sample rate without waiting for the hardware.
+   * Every device of a group is set in parallel, the future becomes ready
+   * once all of them are done. Its get() returns the actual rate in Sps
+   * or throws the error a device reported.
+   * \param rate a new rate in Sps
+   */
+  virtual boost::shared_future< double > set_sample_rate_async( double rate ) = 0;
+
+  /*!
+   * Asynchronous counterparts of the setters above, taking the same
+   * arguments. Calls to one device are carried out in the order they
+   * were made, calls to different devices run in parallel. With chan
+   * set to ALL_CHANS the value is applied to every channel and the
+   * future becomes ready once all devices are done, carrying the actual
+   * value of the first channel. The synchronous setters are equivalent
+   * to calling get() on the returned future.
+   */
+  virtual boost::shared_future< double > set_center_freq_async( double freq, size_t chan = 0 ) = 0;
+  virtual boost::shared_future< double > set_freq_corr_async( double ppm, size_t chan = 0 ) = 0;
+  virtual boost::shared_future< double > set_gain_async( double gain, size_t chan = 0 ) = 0;
+  virtual boost::shared_future< double > set_gain_async( double gain,
+                                                         const std::string & name,
+                                                         size_t chan = 0 ) = 0;
+  virtual boost::shared_future< double > set_if_gain_async( double gain, size_t chan = 0 ) = 0;
+  virtual boost::shared_future< double > set_bb_gain_async( double gain, size_t chan = 0 ) = 0;
+  virtual boost::shared_future< double > set_bandwidth_async( double bandwidth, size_t chan = 0 ) = 0;
 
   /*!
    * Enabled the Bias T (Power Injection) for supported radios.
@@ -428,6 +494,17 @@ public:
    */
   virtual bool get_biast() = 0;
 
+  /*!
+   * Cycle a channel through a hop schedule. Each step retunes the channel
+   * (and sets its gain if given), drops the samples received while the
+   * tuner settles, then passes the dwell samples of the step with an rx_freq
+   * tag on the first one. The device has to be opened with the hop argument.
+   * \param schedule the steps to cycle through, empty to stop hopping
+   * \param chan the channel index 0 to N-1
+   */
+  virtual void set_hop_schedule( const osmosdr::hop_schedule_t &schedule,
+                                 size_t chan = 0 ) = 0;
+
 };
 
 } /* namespace osmosdr */
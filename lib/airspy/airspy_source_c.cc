@@ -32,6 +32,7 @@
 #include <algorithm>
 
 #include <boost/assign.hpp>
+#include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/thread/thread.hpp>
@@ -39,6 +40,7 @@
 #include <gnuradio/io_signature.h>
 
 #include "airspy_source_c.h"
+#include "driver_registry.h"
 #include "airspy_fir_kernels.h"
 
 #include "arg_helpers.h"
@@ -85,23 +87,52 @@ airspy_source_c::airspy_source_c (const std::string &args)
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
     _dev(NULL),
+    _samp_in(0),
     _sample_rate(0),
+    _raw(false),
+    _decim(1),
     _center_freq(0),
     _freq_corr(0),
     _auto_gain(false),
+    _gain(0),
     _gain_policy(linearity),
     _lna_gain(0),
     _mix_gain(0),
     _vga_gain(0),
-    _bandwidth(0)
+    _bandwidth(0),
+    _record_only(false)
 {
   int ret;
 
   dict_t dict = params_to_dict(args);
 
-  _dev = NULL;
-  ret = airspy_open( &_dev );
-  AIRSPY_THROW_ON_ERROR(ret, "Failed to open AirSpy device")
+  _timer.init( dict, "airspy" );
+  _defaults.init( dict );
+
+  /* airspy_open() takes the first free device, so there is a single key */
+  _pool_key = "airspy";
+  _linger = pool_linger( dict );
+
+  _dev = (struct airspy_device *)device_pool::instance().claim( _pool_key, _settings );
+  if ( ! _dev ) {
+    ret = airspy_open( &_dev );
+    AIRSPY_THROW_ON_ERROR(ret, "Failed to open AirSpy device")
+    _settings.reset( new device_settings );
+  }
+
+  _timer.phase( "open" );
+
+  /* with decim, the raw real samples are translated and decimated here */
+  if ( dict.count( "decim" ) ) {
+    _raw = true;
+    _decim = parse_decimation( dict["decim"] );
+    _ddc.set_decimation( 2 * _decim );
+  }
+
+  /* a device taken over may have been left in the other mode */
+  ret = airspy_set_sample_type( _dev, _raw ? AIRSPY_SAMPLE_INT16_REAL
+                                           : AIRSPY_SAMPLE_FLOAT32_IQ );
+  AIRSPY_THROW_ON_ERROR(ret, "Failed to set sample type")
 
   uint8_t board_id;
   ret = airspy_board_id_read( _dev, &board_id );
@@ -135,8 +166,17 @@ airspy_source_c::airspy_source_c (const std::string &args)
 
   std::cerr << std::endl;
 
-  set_center_freq( (get_freq_range().start() + get_freq_range().stop()) / 2.0 );
-  set_sample_rate( get_sample_rates().start() );
+  /* what the deferred defaults will apply, should setters refer to it */
+  if ( _defaults.deferred() ) {
+    _center_freq = (get_freq_range().start() + get_freq_range().stop()) / 2.0;
+    _lna_gain = 8;
+    _mix_gain = 5;
+    _vga_gain = 5;
+  }
+
+  _defaults.add( "freq", [this]() {
+    set_center_freq( (get_freq_range().start() + get_freq_range().stop()) / 2.0 ); } );
+  _defaults.add( "rate", [this]() { set_sample_rate( get_sample_rates().start() ); } );
   set_bandwidth( 0 );
 
   if ( dict.count( "linearity" ) )
@@ -145,11 +185,10 @@ airspy_source_c::airspy_source_c (const std::string &args)
   if ( dict.count( "sensitivity" ) )
     _gain_policy = sensitivity;
 
-  set_lna_gain( 8 ); /* preset to a reasonable default (non-GRC use case) */
-
-  set_mix_gain( 5 ); /* preset to a reasonable default (non-GRC use case) */
-
-  set_if_gain( 5 ); /* preset to a reasonable default (non-GRC use case) */
+  /* preset to a reasonable default (non-GRC use case) */
+  _defaults.add( "lna_gain", [this]() { set_lna_gain( 8 ); } );
+  _defaults.add( "mix_gain", [this]() { set_mix_gain( 5 ); } );
+  _defaults.add( "if_gain", [this]() { set_if_gain( 5 ); } );
 
   if ( dict.count( "bias" ) )
   {
@@ -173,6 +212,35 @@ airspy_source_c::airspy_source_c (const std::string &args)
     throw std::runtime_error( std::string(__FUNCTION__) + " " +
                               "Failed to allocate a sample FIFO!" );
   }
+
+  if ( dict.count( "record_only" ) )
+    _record_only = boost::lexical_cast<bool>( dict["record_only"] );
+
+  /* libairspy hands out converted float IQ, that is what gets recorded,
+   * unless it hands out the real samples at twice the rate */
+  if ( dict.count( "record" ) ) {
+    if ( _raw )
+      _recorder.reset( new raw_recorder( dict["record"], "ri16_le",
+                                         sizeof(int16_t), "AirSpy" ) );
+    else
+      _recorder.reset( new raw_recorder( dict["record"], "cf32_le",
+                                         2 * sizeof(float), "AirSpy" ) );
+    _recorder->set_sample_rate( _raw ? 2 * _sample_rate : _sample_rate );
+    _recorder->set_center_freq( get_center_freq() );
+  } else if ( _record_only ) {
+    throw std::runtime_error("Parameter 'record_only' requires 'record'.");
+  }
+
+  _timer.phase( "configure" );
+}
+
+void airspy_source_c::close_device( void *dev )
+{
+  int ret = airspy_close( (struct airspy_device *)dev );
+  if ( ret != AIRSPY_SUCCESS )
+  {
+    std::cerr << AIRSPY_FORMAT_ERROR(ret, "Failed to close AirSpy") << std::endl;
+  }
 }
 
 /*
@@ -192,11 +260,8 @@ airspy_source_c::~airspy_source_c ()
       }
     }
 
-    ret = airspy_close( _dev );
-    if ( ret != AIRSPY_SUCCESS )
-    {
-      std::cerr << AIRSPY_FORMAT_ERROR(ret, "Failed to close AirSpy") << std::endl;
-    }
+    device_pool::instance().release( _pool_key, _dev, close_device,
+                                     _settings, _linger );
     _dev = NULL;
   }
 
@@ -219,6 +284,22 @@ int airspy_source_c::airspy_rx_callback(void *samples, int sample_count)
   size_t i, n_avail, to_copy, num_samples = sample_count;
   float *sample = (float *)samples;
 
+  _timer.first_sample();
+
+  if (_recorder) {
+    _recorder->push(samples, num_samples * (_raw ? sizeof(int16_t) : 2 * sizeof(float)));
+
+    if (_record_only) /* work() stays idle, no conversion takes place */
+      return 0;
+  }
+
+  if (_raw) {
+    _converted.resize( num_samples / 2 + 1 );
+    num_samples = _ddc.decimate_real( (const int16_t *)samples, num_samples,
+                                      &_converted[0], 32768.0f );
+    sample = (float *)&_converted[0];
+  }
+
   _fifo_lock.lock();
 
   n_avail = _fifo->capacity() - _fifo->size();
@@ -228,6 +309,7 @@ int airspy_source_c::airspy_rx_callback(void *samples, int sample_count)
   {
     /* Push sample to the fifo */
     _fifo->push_back( gr_complex( *sample, *(sample+1) ) );
+    _samp_in++;
 
     /* offset to the next I+Q sample */
     sample += 2;
@@ -248,11 +330,23 @@ int airspy_source_c::airspy_rx_callback(void *samples, int sample_count)
   return 0; // TODO: return -1 on error/stop
 }
 
+/* the position of the first sample of the next transfer */
+uint64_t airspy_source_c::samples_received()
+{
+  boost::mutex::scoped_lock lock( _fifo_lock );
+
+  return _samp_in;
+}
+
 bool airspy_source_c::start()
 {
   if ( ! _dev )
     return false;
 
+  _timer.phase( "idle" );
+
+  _defaults.apply();
+
   int ret = airspy_start_rx( _dev, _airspy_rx_callback, (void *)this );
   if ( ret != AIRSPY_SUCCESS ) {
     std::cerr << "Failed to start RX streaming (" << ret << ")" << std::endl;
@@ -300,13 +394,24 @@ int airspy_source_c::work( int noutput_items,
     n_samples_avail = _fifo->size();
   }
 
+  uint64_t pos = _samp_in - n_samples_avail;
+
   for(int i = 0; i < noutput_items; ++i) {
     out[i] = _fifo->at(0);
     _fifo->pop_front();
   }
 
+  lock.unlock();
+
+  /* libairspy (or the callback) converted them, correct the copy */
+  if (_corrector.enabled())
+    _corrector.correct(out, noutput_items);
+
   //std::cerr << "-" << std::flush;
 
+  BOOST_FOREACH( const gr::tag_t &change, _changes.take( pos, noutput_items, nitems_written( 0 ) ) )
+    add_item_tag( 0, change );
+
   return noutput_items;
 }
 
@@ -352,13 +457,18 @@ osmosdr::meta_range_t airspy_source_c::get_sample_rates()
   for (size_t i = 0; i < _sample_rates.size(); i++)
     range += osmosdr::range_t( _sample_rates[i].first );
 
-  return range;
+  return decimate_rates( range, _decim );
 }
 
 double airspy_source_c::set_sample_rate( double rate )
 {
   int ret = AIRSPY_SUCCESS;
 
+  _defaults.cancel( "rate" );
+
+  /* the device runs at the rate before decimation */
+  rate *= _decim;
+
   if (_dev) {
     bool found_supported_rate = false;
     uint32_t samp_rate_index = 0;
@@ -379,9 +489,16 @@ double airspy_source_c::set_sample_rate( double rate )
         boost::str( boost::format("Unsupported samplerate: %gM") % (rate/1e6) ) );
     }
 
-    ret = airspy_set_samplerate( _dev, samp_rate_index );
+    ret = AIRSPY_SUCCESS;
+    if ( ! _settings->cached( "rate", samp_rate_index ) )
+      ret = airspy_set_samplerate( _dev, samp_rate_index );
     if ( AIRSPY_SUCCESS == ret ) {
+      _settings->store( "rate", samp_rate_index );
+      if ( rate != _sample_rate )
+        _changes.post( "rx_rate", rate / _decim, samples_received() );
       _sample_rate = rate;
+      if (_recorder)
+        _recorder->set_sample_rate( _raw ? 2 * rate : rate );
     } else {
       AIRSPY_THROW_ON_ERROR( ret, AIRSPY_FUNC_STR( "airspy_set_samplerate", rate ) )
     }
@@ -392,7 +509,7 @@ double airspy_source_c::set_sample_rate( double rate )
 
 double airspy_source_c::get_sample_rate()
 {
-  return _sample_rate;
+  return _sample_rate / _decim;
 }
 
 osmosdr::freq_range_t airspy_source_c::get_freq_range( size_t chan )
@@ -408,13 +525,22 @@ double airspy_source_c::set_center_freq( double freq, size_t chan )
 {
   int ret;
 
+  _defaults.cancel( "freq" );
+
   #define APPLY_PPM_CORR(val, ppm) ((val) * (1.0 + (ppm) * 0.000001))
 
   if (_dev) {
     double corr_freq = APPLY_PPM_CORR( freq, _freq_corr );
-    ret = airspy_set_freq( _dev, uint64_t(corr_freq) );
+    ret = AIRSPY_SUCCESS;
+    if ( ! _settings->cached( "freq", uint64_t(corr_freq) ) )
+      ret = airspy_set_freq( _dev, uint64_t(corr_freq) );
     if ( AIRSPY_SUCCESS == ret ) {
+      _settings->store( "freq", uint64_t(corr_freq) );
+      if ( freq != _center_freq )
+        _changes.post( "rx_freq", freq, samples_received() );
       _center_freq = freq;
+      if (_recorder)
+        _recorder->set_center_freq( freq );
     } else {
       AIRSPY_THROW_ON_ERROR( ret, AIRSPY_FUNC_STR( "airspy_set_freq", corr_freq ) )
     }
@@ -505,25 +631,47 @@ double airspy_source_c::set_gain( double gain, size_t chan )
   int ret = AIRSPY_SUCCESS;
   osmosdr::gain_range_t gains = get_gain_range( chan );
 
+  /* the combined gain sets all stages */
+  _defaults.cancel( "lna_gain" );
+  _defaults.cancel( "mix_gain" );
+  _defaults.cancel( "if_gain" );
+
   if (_dev) {
     double clip_gain = gains.clip( gain, true );
     uint8_t value = clip_gain;
+    double prev_gain = _gain;
+
+    /* the combined gains program all three stages */
+    _settings->forget( "lna" );
+    _settings->forget( "mix" );
+    _settings->forget( "vga" );
 
     if ( _gain_policy == linearity ) {
-        ret = airspy_set_linearity_gain( _dev, value );
+        ret = AIRSPY_SUCCESS;
+        if ( ! _settings->cached( "linearity", value ) )
+          ret = airspy_set_linearity_gain( _dev, value );
         if ( AIRSPY_SUCCESS == ret ) {
+          _settings->forget( "sensitivity" );
+          _settings->store( "linearity", value );
           _gain = clip_gain;
         } else {
           AIRSPY_THROW_ON_ERROR( ret, AIRSPY_FUNC_STR( "airspy_set_linearity_gain", value ) )
         }
     } else if ( _gain_policy == sensitivity ) {
-        ret = airspy_set_sensitivity_gain( _dev, value );
+        ret = AIRSPY_SUCCESS;
+        if ( ! _settings->cached( "sensitivity", value ) )
+          ret = airspy_set_sensitivity_gain( _dev, value );
         if ( AIRSPY_SUCCESS == ret ) {
+          _settings->forget( "linearity" );
+          _settings->store( "sensitivity", value );
           _gain = clip_gain;
         } else {
           AIRSPY_THROW_ON_ERROR( ret, AIRSPY_FUNC_STR( "airspy_set_sensitivity_gain", value ) )
         }
     }
+
+    if ( _gain != prev_gain )
+      _changes.post( "rx_gain", _gain, samples_received() );
   }
 
   return _gain;
@@ -573,12 +721,19 @@ double airspy_source_c::set_lna_gain( double gain, size_t chan )
   int ret = AIRSPY_SUCCESS;
   osmosdr::gain_range_t gains = get_gain_range( "LNA", chan );
 
+  _defaults.cancel( "lna_gain" );
+
   if (_dev) {
     double clip_gain = gains.clip( gain, true );
     uint8_t value = clip_gain;
 
-    ret = airspy_set_lna_gain( _dev, value );
+    ret = AIRSPY_SUCCESS;
+    if ( ! _settings->cached( "lna", value ) )
+      ret = airspy_set_lna_gain( _dev, value );
     if ( AIRSPY_SUCCESS == ret ) {
+      _settings->forget( "linearity" );
+      _settings->forget( "sensitivity" );
+      _settings->store( "lna", value );
       _lna_gain = clip_gain;
     } else {
       AIRSPY_THROW_ON_ERROR( ret, AIRSPY_FUNC_STR( "airspy_set_lna_gain", value ) )
@@ -593,12 +748,19 @@ double airspy_source_c::set_mix_gain(double gain, size_t chan)
   int ret;
   osmosdr::gain_range_t gains = get_gain_range( "MIX", chan );
 
+  _defaults.cancel( "mix_gain" );
+
   if (_dev) {
     double clip_gain = gains.clip( gain, true );
     uint8_t value = clip_gain;
 
-    ret = airspy_set_mixer_gain( _dev, value );
+    ret = AIRSPY_SUCCESS;
+    if ( ! _settings->cached( "mix", value ) )
+      ret = airspy_set_mixer_gain( _dev, value );
     if ( AIRSPY_SUCCESS == ret ) {
+      _settings->forget( "linearity" );
+      _settings->forget( "sensitivity" );
+      _settings->store( "mix", value );
       _mix_gain = clip_gain;
     } else {
       AIRSPY_THROW_ON_ERROR( ret, AIRSPY_FUNC_STR( "airspy_set_mixer_gain", value ) )
@@ -613,12 +775,19 @@ double airspy_source_c::set_if_gain(double gain, size_t chan)
   int ret;
   osmosdr::gain_range_t gains = get_gain_range( "MIX", chan );
 
+  _defaults.cancel( "if_gain" );
+
   if (_dev) {
     double clip_gain = gains.clip( gain, true );
     uint8_t value = clip_gain;
 
-    ret = airspy_set_vga_gain( _dev, value );
+    ret = AIRSPY_SUCCESS;
+    if ( ! _settings->cached( "vga", value ) )
+      ret = airspy_set_vga_gain( _dev, value );
     if ( AIRSPY_SUCCESS == ret ) {
+      _settings->forget( "linearity" );
+      _settings->forget( "sensitivity" );
+      _settings->store( "vga", value );
       _vga_gain = clip_gain;
     } else {
       AIRSPY_THROW_ON_ERROR( ret, AIRSPY_FUNC_STR( "airspy_set_vga_gain", value ) )
@@ -647,9 +816,30 @@ std::string airspy_source_c::get_antenna( size_t chan )
   return "RX";
 }
 
+void airspy_source_c::set_dc_offset_mode( int mode, size_t chan )
+{
+  _corrector.set_dc_offset_mode( mode );
+}
+
+void airspy_source_c::set_dc_offset( const std::complex<double> &offset, size_t chan )
+{
+  _corrector.set_dc_offset( offset );
+}
+
+void airspy_source_c::set_iq_balance_mode( int mode, size_t chan )
+{
+  _corrector.set_iq_balance_mode( mode );
+}
+
+void airspy_source_c::set_iq_balance( const std::complex<double> &balance, size_t chan )
+{
+  _corrector.set_iq_balance( balance );
+}
+
 double airspy_source_c::set_bandwidth( double bandwidth, size_t chan )
 {
-  if (bandwidth == 0.f)
+  /* the conversion filter of libairspy is not used on raw samples */
+  if (bandwidth == 0.f || _raw)
     return get_bandwidth( chan );
 
   {
@@ -700,7 +890,7 @@ double airspy_source_c::set_bandwidth( double bandwidth, size_t chan )
 
 double airspy_source_c::get_bandwidth( size_t chan )
 {
-  return _sample_rate;
+  return _sample_rate / _decim;
 }
 
 osmosdr::freq_range_t airspy_source_c::get_bandwidth_range( size_t chan )
@@ -712,6 +902,28 @@ osmosdr::freq_range_t airspy_source_c::get_bandwidth_range( size_t chan )
   return bandwidths;
 }
 
+double airspy_source_c::get_settle_time( size_t chan )
+{
+  return tuner_settle_time( "R820T" );
+}
+
+osmosdr::channel_settings airspy_source_c::configure( const osmosdr::channel_settings &settings,
+                                                  size_t chan )
+{
+  /* one pass with the rate ahead of the filter and the frequency, values
+   * the device already has are skipped through the settings cache */
+  osmosdr::channel_settings actual;
+  {
+    /* one rx_retune tag instead of the tags of each setter */
+    change_tags::hold hold( _changes );
+    actual = apply_channel_settings( this, settings, chan );
+  }
+
+  _changes.post_retune( actual, samples_received() );
+
+  return actual;
+}
+
 void airspy_source_c::set_biast( bool enabled ) {
   airspy_set_rf_bias(_dev, enabled ? 1 : 0);
   _biasT = enabled;
@@ -720,3 +932,6 @@ void airspy_source_c::set_biast( bool enabled ) {
 bool airspy_source_c::get_biast() {
   return _biasT;
 }
+
+OSMOSDR_REGISTER_SOURCE( airspy, "airspy", PROBE_USB,
+                         make_airspy_source_c, airspy_source_c::get_devices() );
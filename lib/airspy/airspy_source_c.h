@@ -31,6 +31,11 @@
 #include <libairspy/airspy.h>
 
 #include "source_iface.h"
+#include "iq_corrector.h"
+#include "raw_recorder.h"
+#include "device_startup.h"
+#include "device_pool.h"
+#include "halfband_decim.h"
 
 class airspy_source_c;
 
@@ -96,6 +101,7 @@ public:
   osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
   double set_center_freq( double freq, size_t chan = 0 );
   double get_center_freq( size_t chan = 0 );
+  bool tags_changes() { return true; }
   double set_freq_corr( double ppm, size_t chan = 0 );
   double get_freq_corr( size_t chan = 0 );
 
@@ -118,25 +124,44 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  void set_dc_offset_mode( int mode, size_t chan = 0 );
+  void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
+
+  void set_iq_balance_mode( int mode, size_t chan = 0 );
+  void set_iq_balance( const std::complex<double> &balance, size_t chan = 0 );
+
   double set_bandwidth( double bandwidth, size_t chan = 0 );
   double get_bandwidth( size_t chan = 0 );
   osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
 
+  osmosdr::channel_settings configure( const osmosdr::channel_settings &settings,
+                                       size_t chan = 0 );
+
+  double get_settle_time( size_t chan = 0 );
+
   void set_biast( bool enabled );
   bool get_biast();
 
 private:
   static int _airspy_rx_callback(airspy_transfer* transfer);
+  static void close_device(void *dev);
   int airspy_rx_callback(void *samples, int sample_count);
+  uint64_t samples_received();
 
   airspy_device *_dev;
 
   boost::circular_buffer<gr_complex> *_fifo;
   boost::mutex _fifo_lock;
   boost::condition_variable _samp_avail;
+  uint64_t _samp_in; /* samples put into the fifo since opening */
 
   std::vector< std::pair<double, uint32_t> > _sample_rates;
-  double _sample_rate;
+  double _sample_rate; /* of the device, before decimation */
+  bool _raw; /* real samples converted here instead of by libairspy */
+  size_t _decim;
+  halfband_decim _ddc;
+  std::vector<gr_complex> _converted;
+  iq_corrector _corrector;
   double _center_freq;
   double _freq_corr;
   bool _auto_gain;
@@ -152,6 +177,17 @@ private:
   double _vga_gain;
   double _bandwidth;
   bool _biasT;
+
+  boost::shared_ptr<raw_recorder> _recorder;
+  bool _record_only;
+
+  startup_timer _timer;
+  deferred_defaults _defaults;
+  change_tags _changes;
+
+  std::string _pool_key;
+  double _linger;
+  device_settings_sptr _settings;
 };
 
 #endif /* INCLUDED_AIRSPY_SOURCE_C_H */
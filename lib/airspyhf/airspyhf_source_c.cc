@@ -32,6 +32,7 @@
 #include <algorithm>
 
 #include <boost/assign.hpp>
+#include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/thread/thread.hpp>
@@ -39,6 +40,7 @@
 #include <gnuradio/io_signature.h>
 
 #include "airspyhf_source_c.h"
+#include "driver_registry.h"
 #include "arg_helpers.h"
 
 using namespace boost::assign;
@@ -82,6 +84,7 @@ airspyhf_source_c::airspyhf_source_c (const std::string &args)
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
     _dev(NULL),
+    _samp_in(0),
     _sample_rate(0),
     _center_freq(0),
     _freq_corr(0)
@@ -176,6 +179,7 @@ int airspyhf_source_c::airspyhf_rx_callback(void *samples, int sample_count)
   {
     /* Push sample to the fifo */
     _fifo->push_back( gr_complex( *sample, *(sample+1) ) );
+    _samp_in++;
 
     /* offset to the next I+Q sample */
     sample += 2;
@@ -196,6 +200,14 @@ int airspyhf_source_c::airspyhf_rx_callback(void *samples, int sample_count)
   return 0; // TODO: return -1 on error/stop
 }
 
+/* the position of the first sample of the next transfer */
+uint64_t airspyhf_source_c::samples_received()
+{
+  boost::mutex::scoped_lock lock( _fifo_lock );
+
+  return _samp_in;
+}
+
 bool airspyhf_source_c::start()
 {
   if ( ! _dev )
@@ -248,11 +260,16 @@ int airspyhf_source_c::work( int noutput_items,
     n_samples_avail = _fifo->size();
   }
 
+  uint64_t pos = _samp_in - n_samples_avail;
+
   for(int i = 0; i < noutput_items; ++i) {
     out[i] = _fifo->at(0);
     _fifo->pop_front();
   }
 
+  BOOST_FOREACH( const gr::tag_t &change, _changes.take( pos, noutput_items, nitems_written( 0 ) ) )
+    add_item_tag( 0, change );
+
   return noutput_items;
 }
 
@@ -315,6 +332,8 @@ double airspyhf_source_c::set_sample_rate( double rate )
 
     ret = airspyhf_set_samplerate( _dev, samp_rate_index );
     if ( AIRSPYHF_SUCCESS == ret ) {
+      if ( rate != _sample_rate )
+        _changes.post( "rx_rate", rate, samples_received() );
       _sample_rate = rate;
     } else {
       AIRSPYHF_THROW_ON_ERROR( ret, AIRSPYHF_FUNC_STR( "airspyhf_set_samplerate", rate ) )
@@ -345,6 +364,8 @@ double airspyhf_source_c::set_center_freq( double freq, size_t chan )
   if (_dev) {
     ret = airspyhf_set_freq( _dev, freq );
     if ( AIRSPYHF_SUCCESS == ret ) {
+      if ( freq != _center_freq )
+        _changes.post( "rx_freq", freq, samples_received() );
       _center_freq = freq;
     } else {
       AIRSPYHF_THROW_ON_ERROR( ret, AIRSPYHF_FUNC_STR( "airspyhf_set_freq", freq ) )
@@ -435,3 +456,6 @@ std::string airspyhf_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+OSMOSDR_REGISTER_SOURCE( airspyhf, "airspyhf", PROBE_USB,
+                         make_airspyhf_source_c, airspyhf_source_c::get_devices() );
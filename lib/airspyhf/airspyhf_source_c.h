@@ -82,6 +82,7 @@ public:
   osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
   double set_center_freq( double freq, size_t chan = 0 );
   double get_center_freq( size_t chan = 0 );
+  bool tags_changes() { return true; }
   double set_freq_corr( double ppm, size_t chan = 0 );
   double get_freq_corr( size_t chan = 0 );
 
@@ -101,17 +102,21 @@ public:
 private:
   static int _airspyhf_rx_callback(airspyhf_transfer_t* transfer);
   int airspyhf_rx_callback(void *samples, int sample_count);
+  uint64_t samples_received();
 
   airspyhf_device *_dev;
 
   boost::circular_buffer<gr_complex> *_fifo;
   boost::mutex _fifo_lock;
   boost::condition_variable _samp_avail;
+  uint64_t _samp_in; /* samples put into the fifo since opening */
 
   std::vector< std::pair<double, uint32_t> > _sample_rates;
   double _sample_rate;
   double _center_freq;
   double _freq_corr;
+
+  change_tags _changes;
 };
 
 #endif /* INCLUDED_AIRSPY_SOURCE_C_H */
@@ -144,7 +144,13 @@ inline gr::io_signature::sptr args_to_io_signature( const std::string &args )
   BOOST_FOREACH( std::string arg, arg_list )
   {
     dict_t dict = params_to_dict(arg);
-    if (dict.count("nchan"))
+    if (dict.count("channels")) // one output per channelized channel
+    {
+      boost::char_separator<char> separator(";");
+      boost::tokenizer< boost::char_separator<char> > tokens(dict["channels"], separator);
+      dev_nchan += std::distance(tokens.begin(), tokens.end());
+    }
+    else if (dict.count("nchan"))
     {
       dev_nchan += boost::lexical_cast<size_t>( dict["nchan"] );
     }
@@ -160,6 +160,8 @@ void bladerf_common::init(dict_t const &dict, bladerf_direction direction)
   _pfx = boost::str(boost::format("[bladeRF %s] ")
           % (direction == BLADERF_TX ? "sink" : "source"));
 
+  _timer.init(dict, direction == BLADERF_TX ? "bladeRF sink" : "bladeRF");
+
   /* libbladeRF verbosity */
   if (dict.count("verbosity")) {
     set_verbosity(_get(dict, "verbosity"));
@@ -221,6 +223,8 @@ void bladerf_common::init(dict_t const &dict, bladerf_direction direction)
                   "'%s': _dev is NULL") % device_name));
   }
 
+  _timer.phase("open");
+
   /* Load a FPGA */
   if (dict.count("fpga")) {
     if (dict.count("fpga-reload") == 0 &&
@@ -248,6 +252,8 @@ void bladerf_common::init(dict_t const &dict, bladerf_direction direction)
                   "fpga=/path/to/the/bitstream.rbf to load it.");
   }
 
+  _timer.phase("firmware");
+
   /* XB-200 Transverter Board */
   if (dict.count("xb200")) {
     status = bladerf_expansion_attach(_dev.get(), BLADERF_XB_200);
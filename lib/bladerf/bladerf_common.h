@@ -33,6 +33,7 @@
 
 #include "osmosdr/ranges.h"
 #include "arg_helpers.h"
+#include "device_startup.h"
 
 #include "bladerf_compat.h"
 
@@ -258,6 +259,8 @@ protected:
   bladerf_channel_map _chanmap; /**< map of antennas to channels */
   bladerf_channel_enable_map _enables;  /**< enabled channels */
 
+  startup_timer _timer;         /**< time spent bringing the device up */
+
   /*****************************************************************************
    * Protected constants
    ****************************************************************************/
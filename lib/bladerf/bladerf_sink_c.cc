@@ -40,6 +40,7 @@
 
 #include "arg_helpers.h"
 #include "bladerf_sink_c.h"
+#include "driver_registry.h"
 #include "osmosdr/sink.h"
 
 using namespace boost::assign;
@@ -607,3 +608,6 @@ void bladerf_sink_c::set_biastee_mode(const std::string &mode)
     BLADERF_THROW_STATUS(status, "Failed to set bias-tee");
   }
 }
+
+OSMOSDR_REGISTER_SINK( bladerf, "bladerf", PROBE_USB,
+                         make_bladerf_sink_c, bladerf_sink_c::get_devices() );
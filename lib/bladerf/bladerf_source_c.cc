@@ -40,6 +40,7 @@
 
 #include "arg_helpers.h"
 #include "bladerf_source_c.h"
+#include "driver_registry.h"
 #include "osmosdr/source.h"
 
 using namespace boost::assign;
@@ -175,6 +176,8 @@ bladerf_source_c::bladerf_source_c(const std::string &args) :
     _chanmap[BLADERF_CHANNEL_RX(ch)] = ch;
   }
 
+  _timer.phase("configure");
+
   BLADERF_DEBUG("initialization complete");
 }
 
@@ -219,6 +222,8 @@ bool bladerf_source_c::start()
 
   BLADERF_DEBUG("starting source");
 
+  _timer.phase("idle");
+
   gr::thread::scoped_lock guard(d_mutex);
 
   status = bladerf_sync_config(_dev.get(), _layout, _format, _num_buffers,
@@ -320,6 +325,7 @@ int bladerf_source_c::work(int noutput_items,
     }
   } else {
     _failures = 0;
+    _timer.first_sample();
   }
 
   // convert from int16_t to float
@@ -344,6 +350,13 @@ int bladerf_source_c::work(int noutput_items,
     memcpy(out[0], _32fcbuf, sizeof(gr_complex) * noutput_items);
   }
 
+  for (size_t n = 0; n < nstreams; ++n) {
+    gr::tag_t tag;
+    if (_retune.take(n, nitems_written(n), tag)) {
+      add_item_tag(n, tag);
+    }
+  }
+
   return noutput_items;
 }
 
@@ -537,6 +550,32 @@ double bladerf_source_c::get_bandwidth(size_t chan)
   return bladerf_common::get_bandwidth(chan2channel(BLADERF_RX, chan));
 }
 
+double bladerf_source_c::get_settle_time(size_t chan)
+{
+  switch (get_board_type()) {
+    case BOARD_TYPE_BLADERF_1:
+      return tuner_settle_time("LMS6002D");
+    case BOARD_TYPE_BLADERF_2:
+      return tuner_settle_time("AD9361");
+    default:
+      return tuner_settle_time("");
+  }
+}
+
+osmosdr::channel_settings bladerf_source_c::configure(
+  const osmosdr::channel_settings &settings, size_t chan)
+{
+  // keep work() from reading samples while only part of the settings
+  // has been applied
+  gr::thread::scoped_lock guard(d_mutex);
+
+  osmosdr::channel_settings actual = apply_channel_settings(this, settings,
+                                                            chan);
+  _retune.arm(chan, actual);
+
+  return actual;
+}
+
 std::vector<std::string> bladerf_source_c::get_clock_sources(size_t mboard)
 {
   return bladerf_common::get_clock_sources(mboard);
@@ -678,3 +717,6 @@ void bladerf_source_c::set_agc_mode(const std::string &agcmode)
   }
 #endif
 }
+
+OSMOSDR_REGISTER_SOURCE( bladerf, "bladerf", PROBE_USB,
+                         make_bladerf_source_c, bladerf_source_c::get_devices() );
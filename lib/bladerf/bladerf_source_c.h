@@ -116,6 +116,11 @@ public:
   double set_bandwidth(double bandwidth, size_t chan = 0);
   double get_bandwidth(size_t chan = 0);
 
+  osmosdr::channel_settings configure(const osmosdr::channel_settings &settings,
+                                      size_t chan = 0);
+
+  double get_settle_time(size_t chan = 0);
+
   std::vector<std::string> get_clock_sources(size_t mboard);
   void set_clock_source(const std::string &source, size_t mboard = 0);
   std::string get_clock_source(size_t mboard);
@@ -136,6 +141,7 @@ private:
   bladerf_gain_mode _agcmode;     /**< gain mode when AGC is enabled */
 
   gr::thread::mutex d_mutex;      /**< mutex to protect set/work access */
+  retune_tags _retune;            /**< rx_retune tags of configure() */
 
   /* Scaling factor used when converting from int16_t to float */
   const float SCALING_FACTOR = 2048.0f;
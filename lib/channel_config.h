@@ -0,0 +1,228 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_CHANNEL_CONFIG_H
+#define OSMOSDR_CHANNEL_CONFIG_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include <gnuradio/tags.h>
+#include <pmt/pmt.h>
+
+#include <osmosdr/channel_settings.h>
+
+/*
+ * Applies settings through the individual setters of a source or sink
+ * interface. The rate goes first since the filters and the tuning may
+ * depend on it, the gains last.
+ */
+template< typename iface_t >
+osmosdr::channel_settings apply_channel_settings( iface_t *dev,
+                                                  const osmosdr::channel_settings &settings,
+                                                  size_t chan )
+{
+  typedef osmosdr::channel_settings cs;
+  cs actual;
+
+  if ( cs::is_set( settings.sample_rate ) )
+    actual.sample_rate = dev->set_sample_rate( settings.sample_rate );
+
+  if ( cs::is_set( settings.bandwidth ) )
+    actual.bandwidth = dev->set_bandwidth( settings.bandwidth, chan );
+
+  if ( ! settings.antenna.empty() )
+    actual.antenna = dev->set_antenna( settings.antenna, chan );
+
+  if ( cs::is_set( settings.center_freq ) )
+    actual.center_freq = dev->set_center_freq( settings.center_freq, chan );
+
+  if ( cs::is_set( settings.gain ) )
+    actual.gain = dev->set_gain( settings.gain, chan );
+
+  if ( cs::is_set( settings.if_gain ) )
+    actual.if_gain = dev->set_if_gain( settings.if_gain, chan );
+
+  if ( cs::is_set( settings.bb_gain ) )
+    actual.bb_gain = dev->set_bb_gain( settings.bb_gain, chan );
+
+  return actual;
+}
+
+/* the value of the rx_retune tag of a configure() call, a dict of actual */
+inline pmt::pmt_t retune_value( const osmosdr::channel_settings &actual )
+{
+  typedef osmosdr::channel_settings cs;
+  pmt::pmt_t dict = pmt::make_dict();
+
+  if ( cs::is_set( actual.sample_rate ) )
+    dict = pmt::dict_add( dict, pmt::mp("rate"), pmt::from_double( actual.sample_rate ) );
+  if ( cs::is_set( actual.center_freq ) )
+    dict = pmt::dict_add( dict, pmt::mp("freq"), pmt::from_double( actual.center_freq ) );
+  if ( cs::is_set( actual.gain ) )
+    dict = pmt::dict_add( dict, pmt::mp("gain"), pmt::from_double( actual.gain ) );
+  if ( cs::is_set( actual.if_gain ) )
+    dict = pmt::dict_add( dict, pmt::mp("if_gain"), pmt::from_double( actual.if_gain ) );
+  if ( cs::is_set( actual.bb_gain ) )
+    dict = pmt::dict_add( dict, pmt::mp("bb_gain"), pmt::from_double( actual.bb_gain ) );
+  if ( cs::is_set( actual.bandwidth ) )
+    dict = pmt::dict_add( dict, pmt::mp("bandwidth"), pmt::from_double( actual.bandwidth ) );
+  if ( ! actual.antenna.empty() )
+    dict = pmt::dict_add( dict, pmt::mp("antenna"), pmt::mp( actual.antenna ) );
+
+  return dict;
+}
+
+/*
+ * Holds the rx_retune tag of a configure() call until the work function
+ * of the driver produces the next samples of the channel. A later call
+ * replaces a tag not emitted yet. For drivers which don't track the
+ * position of the samples received, the others post the tag through
+ * change_tags.
+ */
+class retune_tags
+{
+public:
+  void arm( size_t chan, const osmosdr::channel_settings &actual )
+  {
+    pmt::pmt_t dict = retune_value( actual );
+
+    boost::mutex::scoped_lock lock( _mutex );
+    _pending[ chan ] = dict;
+  }
+
+  /* the pending tag of chan placed at offset, false if there is none */
+  bool take( size_t chan, uint64_t offset, gr::tag_t &tag )
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    std::map< size_t, pmt::pmt_t >::iterator it = _pending.find( chan );
+    if ( it == _pending.end() )
+      return false;
+
+    tag.offset = offset;
+    tag.key = pmt::mp("rx_retune");
+    tag.value = it->second;
+    tag.srcid = pmt::PMT_F;
+    _pending.erase( it );
+
+    return true;
+  }
+
+private:
+  boost::mutex _mutex;
+  std::map< size_t, pmt::pmt_t > _pending;
+};
+
+/*
+ * Tags the first sample a setting change applies to with rx_freq, rx_rate
+ * or rx_gain. Positions count the samples in the order the driver received
+ * them from the device. A change is posted with the position of the first
+ * sample of the next buffer (USB transfer, packet, ...) to arrive, and
+ * tagged once work() converts that sample.
+ *
+ * configure() posts a single rx_retune change instead, the changes of the
+ * individual setters it calls are dropped while a hold is in place.
+ */
+class change_tags
+{
+public:
+  class hold
+  {
+  public:
+    hold( change_tags &tags ) : _tags( tags ) { _tags.set_held( 1 ); }
+    ~hold() { _tags.set_held( -1 ); }
+
+  private:
+    change_tags &_tags;
+  };
+
+  change_tags() : _held( 0 ) {}
+
+  void post( const std::string &key, double value, uint64_t pos )
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    if ( _held )
+      return;
+
+    change c = { pmt::mp( key ), pmt::from_double( value ), pos };
+    _pending.push_back( c );
+  }
+
+  /* posts the rx_retune change of a configure() call */
+  void post_retune( const osmosdr::channel_settings &actual, uint64_t pos )
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    change c = { pmt::mp("rx_retune"), retune_value( actual ), pos };
+    _pending.push_back( c );
+  }
+
+  /*
+   * The tags of the changes applying to the count samples from position
+   * first on, those being produced from item offset on. Changes falling
+   * in a gap the driver dropped go on the first sample after it.
+   */
+  std::vector< gr::tag_t > take( uint64_t first, size_t count, uint64_t offset )
+  {
+    std::vector< gr::tag_t > tags;
+
+    boost::mutex::scoped_lock lock( _mutex );
+
+    while ( ! _pending.empty() && count && _pending.front().pos < first + count ) {
+      const change &c = _pending.front();
+      gr::tag_t tag;
+
+      tag.offset = offset + (c.pos > first ? c.pos - first : 0);
+      tag.key = c.key;
+      tag.value = c.value;
+      tag.srcid = pmt::PMT_F;
+      tags.push_back( tag );
+
+      _pending.erase( _pending.begin() );
+    }
+
+    return tags;
+  }
+
+private:
+  struct change {
+    pmt::pmt_t key;
+    pmt::pmt_t value;
+    uint64_t pos;
+  };
+
+  void set_held( int delta )
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+    _held += delta;
+  }
+
+  boost::mutex _mutex;
+  std::vector< change > _pending;
+  int _held;
+};
+
+#endif // OSMOSDR_CHANNEL_CONFIG_H
@@ -0,0 +1,139 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_CHANNEL_ROUTES_H
+#define OSMOSDR_CHANNEL_ROUTES_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+
+/*
+ * Maps the channel numbers of a source or sink block to the device
+ * owning each channel and its channel number there. Built once when the
+ * devices are opened, so lookups don't walk the devices every time.
+ */
+template< typename iface_t >
+class channel_routes
+{
+public:
+  struct route
+  {
+    iface_t *dev;
+    size_t dev_chan;
+    size_t dev_index; /* position of dev in the device list */
+  };
+
+  void add_device( iface_t *dev, size_t dev_index )
+  {
+    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+      add_route( dev, dev_chan, dev_index );
+  }
+
+  /* the next channel, more than one may lead to the same device channel */
+  void add_route( iface_t *dev, size_t dev_chan, size_t dev_index )
+  {
+    route r = { dev, dev_chan, dev_index };
+    _routes.push_back( r );
+  }
+
+  /* the first channel leading to the device at dev_index */
+  size_t first( size_t dev_index ) const
+  {
+    for (size_t i = 0; i < _routes.size(); i++)
+      if ( _routes[i].dev_index == dev_index )
+        return i;
+    return _routes.size();
+  }
+
+  /* the number of channels leading to the device at dev_index */
+  size_t count( size_t dev_index ) const
+  {
+    size_t n = 0;
+    for (size_t i = 0; i < _routes.size(); i++)
+      if ( _routes[i].dev_index == dev_index )
+        n++;
+    return n;
+  }
+
+  /* the route of chan, NULL if there is no such channel */
+  const route *find( size_t chan ) const
+  {
+    return chan < _routes.size() ? &_routes[chan] : NULL;
+  }
+
+  size_t size() const { return _routes.size(); }
+
+private:
+  std::vector< route > _routes;
+};
+
+/*
+ * Capabilities of the channels (ranges, gain and antenna names) which
+ * only change on rare events. Each is fetched from the device on first
+ * use and kept until the channel is invalidated.
+ */
+template< typename value_t >
+class caps_cache
+{
+public:
+  typedef boost::function< value_t () > fetch_t;
+
+  value_t get( size_t chan, const std::string &what, const fetch_t &fetch )
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    key_t key( chan, what );
+    typename std::map< key_t, value_t >::iterator it = _values.find( key );
+    if ( it == _values.end() )
+      it = _values.insert( std::make_pair( key, fetch() ) ).first;
+
+    return it->second;
+  }
+
+  void invalidate( size_t chan )
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    typename std::map< key_t, value_t >::iterator it =
+      _values.lower_bound( key_t( chan, std::string() ) );
+    while ( it != _values.end() && it->first.first == chan )
+      _values.erase( it++ );
+  }
+
+  void invalidate()
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+    _values.clear();
+  }
+
+private:
+  typedef std::pair< size_t, std::string > key_t;
+
+  boost::mutex _mutex;
+  std::map< key_t, value_t > _values;
+};
+
+#endif // OSMOSDR_CHANNEL_ROUTES_H
@@ -0,0 +1,435 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <gnuradio/io_signature.h>
+
+#include <volk/volk.h>
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/tokenizer.hpp>
+
+#include "channelizer_cc.h"
+
+/* the fastest channel produces at most that much per FFT */
+#define MAX_OUTPUTS_PER_FFT 4096
+#define MIN_FFT_SIZE 1024
+
+/* channels spread over the pool of threads */
+#define MIN_CHANNELS_PER_THREAD 4
+
+subchannels_t parse_subchannels( const std::string &list )
+{
+  subchannels_t channels;
+
+  boost::char_separator< char > separator( ";" );
+  boost::tokenizer< boost::char_separator< char > > tokens( list, separator );
+
+  BOOST_FOREACH( const std::string &token, tokens ) {
+    size_t colon = token.find( ':' );
+    subchannel_t chan;
+
+    try {
+      if ( colon == std::string::npos )
+        throw std::runtime_error( token );
+
+      chan.offset = boost::lexical_cast< double >( token.substr( 0, colon ) );
+      chan.bandwidth = boost::lexical_cast< double >( token.substr( colon + 1 ) );
+    } catch ( std::exception & ) {
+      throw std::runtime_error( "Invalid channel '" + token +
+                                "', expected offset:bandwidth in Hz." );
+    }
+
+    if ( chan.bandwidth <= 0 )
+      throw std::runtime_error( "Invalid channel '" + token +
+                                "', the bandwidth must be positive." );
+
+    channels.push_back( chan );
+  }
+
+  if ( channels.empty() )
+    throw std::runtime_error( "No channels given to channelize." );
+
+  return channels;
+}
+
+channelizer_cc_sptr make_channelizer_cc( const subchannels_t &channels, double rate )
+{
+  return gnuradio::get_initial_sptr( new channelizer_cc( channels, rate ) );
+}
+
+channelizer_cc::channelizer_cc( const subchannels_t &channels, double rate ) :
+  gr::block( "channelizer_cc",
+             gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+             gr::io_signature::make( channels.size(), channels.size(), sizeof(gr_complex) ) ),
+  _rate( rate ),
+  _replan( true ),
+  _size( 0 ),
+  _step( 0 ),
+  _outputs( 1 ),
+  _busy( 0 ),
+  _job( 0 ),
+  _stop( true ),
+  _blocks( 0 )
+{
+  /* every output runs at a rate of its own */
+  set_tag_propagation_policy( TPP_DONT );
+
+  _channels.resize( channels.size() );
+  for (size_t i = 0; i < channels.size(); i++)
+    _channels[i].spec = channels[i];
+
+  unsigned int cores = boost::thread::hardware_concurrency();
+  _shares = std::max< size_t >( 1, std::min< size_t >( cores,
+                                  channels.size() / MIN_CHANNELS_PER_THREAD ) );
+
+  boost::mutex::scoped_lock lock( _mutex );
+  plan();
+}
+
+channelizer_cc::~channelizer_cc()
+{
+  stop();
+}
+
+bool channelizer_cc::start()
+{
+  boost::mutex::scoped_lock lock( _pool_mutex );
+
+  if ( _stop ) {
+    _stop = false;
+
+    for (size_t share = 1; share < _shares; share++)
+      _pool.push_back( boost::thread( boost::bind( &channelizer_cc::worker, this,
+                                                   share, _job ) ) );
+  }
+
+  return true;
+}
+
+bool channelizer_cc::stop()
+{
+  {
+    boost::mutex::scoped_lock lock( _pool_mutex );
+    _stop = true;
+  }
+
+  _pool_cond.notify_all();
+
+  BOOST_FOREACH( boost::thread &thread, _pool )
+    thread.join();
+
+  /* start() creates them again */
+  _pool.clear();
+
+  return true;
+}
+
+void channelizer_cc::set_sample_rate( double rate )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( rate != _rate ) {
+    _rate = rate;
+    _replan = true;
+  }
+}
+
+double channelizer_cc::get_output_rate( size_t chan )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( _replan )
+    plan();
+
+  if ( ! _size || chan >= _channels.size() )
+    return 0;
+
+  return _rate / _channels[ chan ].decim;
+}
+
+/*
+ * Picks the decimation of every channel and an FFT long enough for the
+ * steepest filter, then precomputes the bins and responses of the channels.
+ * Called with _mutex held.
+ */
+void channelizer_cc::plan()
+{
+  _replan = false;
+  _size = 0;
+
+  if ( _rate <= 0 )
+    return;
+
+  size_t min_decim = 0, max_decim = 1;
+  double transition = _rate;
+
+  BOOST_FOREACH( channel &chan, _channels ) {
+    chan.decim = 1;
+    while ( _rate / (chan.decim * 2) >= 1.25 * chan.spec.bandwidth )
+      chan.decim *= 2;
+
+    /* the bins kept end at half of the output rate, the stopband has to
+     * be reached there */
+    transition = std::min( transition, (_rate / chan.decim - chan.spec.bandwidth) / 2 );
+    min_decim = min_decim ? std::min( min_decim, chan.decim ) : chan.decim;
+    max_decim = std::max( max_decim, chan.decim );
+
+    if ( std::abs( chan.spec.offset ) + chan.spec.bandwidth / 2 > _rate / 2 )
+      std::cerr << "Channel at " << chan.spec.offset << " Hz lies outside of the "
+                << _rate << " Hz captured, it will alias." << std::endl;
+  }
+
+  /* a hamming windowed filter needs about 3.3 / transition taps, the
+   * overlap of half the FFT leaves room for as many */
+  transition = std::max( transition, _rate * 1e-6 );
+  size_t size = MIN_FFT_SIZE;
+  while ( size < 4 * max_decim || size < 6.6 * _rate / transition )
+    size *= 2;
+
+  size = std::min( size, size_t(2 * MAX_OUTPUTS_PER_FFT) * min_decim );
+
+  _size = size;
+  _step = size / 2;
+  _outputs = _step / min_decim;
+  _fft.reset( new gr::fft::fft_complex( _size, true ) );
+
+  set_output_multiple( _outputs );
+
+  size_t ntaps = _step + 1;
+  std::vector< gr_complex > response( _size );
+
+  BOOST_FOREACH( channel &chan, _channels ) {
+    chan.decim = std::min( chan.decim, _size / 4 );
+    chan.size = _size / chan.decim;
+
+    /* low pass with the cutoff between the passband and half of the
+     * output rate */
+    double cutoff = (chan.spec.bandwidth / _rate + 1.0 / chan.decim) / 4;
+    double sum = 0;
+    gr_complex *taps = _fft->get_inbuf();
+
+    for (size_t n = 0; n < _size; n++) {
+      double tap = 0;
+
+      if ( n < ntaps ) {
+        double t = n - (ntaps - 1) / 2.0;
+        tap = t == 0 ? 2 * cutoff : std::sin( 2 * M_PI * cutoff * t ) / (M_PI * t);
+        tap *= 0.54 - 0.46 * std::cos( 2 * M_PI * n / (ntaps - 1) );
+        sum += tap;
+      }
+
+      taps[n] = gr_complex( tap, 0 );
+    }
+
+    _fft->execute();
+    memcpy( &response[0], _fft->get_outbuf(), _size * sizeof(gr_complex) );
+
+    /* only even bins keep the phase of the overlapping FFTs aligned */
+    long center = 2 * lround( chan.spec.offset / _rate * _size / 2 );
+    double residual = chan.spec.offset - center * _rate / _size;
+    double step = -2.0 * M_PI * residual / (_rate / chan.decim);
+
+    chan.bins.resize( chan.size );
+    chan.response.resize( chan.size );
+
+    for (size_t j = 0; j < chan.size; j++) {
+      long bin = j < chan.size / 2 ? long(j) : long(j) - long(chan.size);
+
+      chan.bins[j] = size_t( ((center + bin) % long(_size) + long(_size)) % long(_size) );
+      chan.response[j] = response[ (bin + _size) % _size ] / float(sum * _size);
+    }
+
+    chan.ifft.reset( new gr::fft::fft_complex( chan.size, false ) );
+    chan.phase = gr_complex( 1, 0 );
+    chan.increment = gr_complex( std::cos( step ), std::sin( step ) );
+    chan.tag_rate = true;
+  }
+}
+
+/* runs the inverse FFTs of channels first to last over the current job */
+void channelizer_cc::filter( size_t first, size_t last )
+{
+  for (size_t k = first; k < last; k++) {
+    channel &chan = _channels[k];
+    gr_complex *out = (gr_complex *) _out[k];
+    size_t half = chan.size / 2;
+
+    for (size_t b = 0; b < _blocks; b++) {
+      const gr_complex *spectrum = &_spectra[ b * _size ];
+      gr_complex *in = chan.ifft->get_inbuf();
+
+      for (size_t j = 0; j < chan.size; j++)
+        in[j] = spectrum[ chan.bins[j] ] * chan.response[j];
+
+      chan.ifft->execute();
+
+      /* the first half is wrapped around by the circular convolution */
+      memcpy( out + b * half, chan.ifft->get_outbuf() + half, half * sizeof(gr_complex) );
+    }
+
+    if ( chan.increment != gr_complex( 1, 0 ) )
+      volk_32fc_s32fc_x2_rotator_32fc( out, out, chan.increment, &chan.phase,
+                                       _blocks * half );
+  }
+}
+
+/* job is the last one posted before the worker was started */
+void channelizer_cc::worker( size_t share, unsigned int job )
+{
+  boost::mutex::scoped_lock lock( _pool_mutex );
+
+  while ( true ) {
+    while ( ! _stop && _job == job )
+      _pool_cond.wait( lock );
+
+    if ( _stop )
+      break;
+
+    job = _job;
+
+    lock.unlock();
+    filter( share * _channels.size() / _shares,
+            (share + 1) * _channels.size() / _shares );
+    lock.lock();
+
+    if ( --_busy == 0 )
+      _done_cond.notify_all();
+  }
+}
+
+void channelizer_cc::forecast( int noutput_items, gr_vector_int &ninput_items_required )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( ! _size ) {
+    ninput_items_required[0] = noutput_items;
+    return;
+  }
+
+  size_t blocks = std::max< size_t >( 1, noutput_items / _outputs );
+  ninput_items_required[0] = blocks * _step + _size - _step;
+}
+
+int channelizer_cc::general_work( int noutput_items,
+                                  gr_vector_int &ninput_items,
+                                  gr_vector_const_void_star &input_items,
+                                  gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( _replan )
+    plan();
+
+  if ( ! _size ) { /* nothing can be filtered without a rate */
+    consume_each( ninput_items[0] );
+    return 0;
+  }
+
+  size_t blocks = noutput_items / _outputs;
+  size_t ninput = ninput_items[0];
+
+  if ( ninput < _size )
+    blocks = 0;
+  else
+    blocks = std::min( blocks, (ninput - _size) / _step + 1 );
+
+  if ( ! blocks )
+    return 0;
+
+  _spectra.resize( blocks * _size );
+
+  for (size_t b = 0; b < blocks; b++) {
+    memcpy( _fft->get_inbuf(), in + b * _step, _size * sizeof(gr_complex) );
+    _fft->execute();
+    memcpy( &_spectra[ b * _size ], _fft->get_outbuf(), _size * sizeof(gr_complex) );
+  }
+
+  /* an output sample lags its input by the filter delay, a quarter of
+   * the FFT. Tags from before the first output go on the first one */
+  std::vector< gr::tag_t > tags;
+  uint64_t start = nitems_read( 0 );
+  uint64_t delay = _step / 2;
+  get_tags_in_range( tags, 0, start ? start + delay : 0,
+                     start + blocks * _step + delay );
+
+  for (size_t k = 0; k < _channels.size(); k++) {
+    channel &chan = _channels[k];
+
+    if ( chan.tag_rate ) {
+      add_item_tag( k, nitems_written( k ), pmt::mp("rx_rate"),
+                    pmt::from_double( _rate / chan.decim ) );
+      chan.tag_rate = false;
+    }
+
+    BOOST_FOREACH( gr::tag_t tag, tags ) {
+      if ( pmt::eq( tag.key, pmt::mp("rx_rate") ) )
+        continue;
+
+      if ( pmt::eq( tag.key, pmt::mp("rx_freq") ) && pmt::is_real( tag.value ) )
+        tag.value = pmt::from_double( pmt::to_double( tag.value ) + chan.spec.offset );
+
+      uint64_t lag = tag.offset > start + delay ? tag.offset - start - delay : 0;
+      tag.offset = nitems_written( k ) + lag / chan.decim;
+      add_item_tag( k, tag );
+    }
+  }
+
+  _blocks = blocks;
+  _out = output_items;
+
+  /* the workers cover the shares of the channels past the first one */
+  size_t shares = _pool.empty() ? 1 : _shares;
+
+  if ( shares > 1 ) {
+    {
+      boost::mutex::scoped_lock pool_lock( _pool_mutex );
+      _busy = shares - 1;
+      _job++;
+    }
+    _pool_cond.notify_all();
+  }
+
+  filter( 0, _channels.size() / shares );
+
+  if ( shares > 1 ) {
+    boost::mutex::scoped_lock pool_lock( _pool_mutex );
+    while ( _busy )
+      _done_cond.wait( pool_lock );
+  }
+
+  for (size_t k = 0; k < _channels.size(); k++)
+    produce( k, blocks * _channels[k].size / 2 );
+
+  consume_each( blocks * _step );
+
+  return WORK_CALLED_PRODUCE;
+}
@@ -0,0 +1,136 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_CHANNELIZER_CC_H
+#define OSMOSDR_CHANNELIZER_CC_H
+
+#include <string>
+#include <vector>
+
+#include <gnuradio/block.h>
+#include <gnuradio/fft/fft.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+/* a narrowband channel, offset from the center frequency of the device */
+struct subchannel_t
+{
+  double offset;    /* Hz */
+  double bandwidth; /* Hz */
+};
+
+typedef std::vector< subchannel_t > subchannels_t;
+
+/* parses "offset:bandwidth;offset:bandwidth;..." */
+subchannels_t parse_subchannels( const std::string &list );
+
+class channelizer_cc;
+
+typedef boost::shared_ptr< channelizer_cc > channelizer_cc_sptr;
+
+channelizer_cc_sptr make_channelizer_cc( const subchannels_t &channels, double rate );
+
+/*!
+ * \brief Splits a wideband stream into narrowband channels.
+ *
+ * Each output carries one channel, mixed down to 0 Hz and decimated by
+ * the largest power of two leaving at least 1.25 times its bandwidth.
+ * The channels are filtered in the frequency domain out of a single
+ * forward FFT of the input (overlap-save), so each one only costs a
+ * small inverse FFT at its own rate. With many channels the inverse
+ * FFTs are spread over a pool of threads.
+ *
+ * The first sample of each output after a rate change is tagged with the
+ * rate of the channel, rx_freq tags of the device are moved to the center
+ * of each channel and its other tags are passed on.
+ */
+class channelizer_cc : public gr::block
+{
+private:
+  friend channelizer_cc_sptr make_channelizer_cc( const subchannels_t &channels,
+                                                  double rate );
+
+  channelizer_cc( const subchannels_t &channels, double rate );
+
+public:
+  ~channelizer_cc();
+
+  void set_sample_rate( double rate );
+
+  /* the rate of output chan, 0 as long as the input rate is unknown */
+  double get_output_rate( size_t chan );
+
+  bool start();
+  bool stop();
+
+  void forecast( int noutput_items, gr_vector_int &ninput_items_required );
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+private:
+  struct channel
+  {
+    subchannel_t spec;
+    size_t decim;
+    size_t size;                 /* of the inverse FFT */
+    std::vector< size_t > bins;  /* input bins, in the order of the inverse FFT */
+    std::vector< gr_complex > response;
+    boost::shared_ptr< gr::fft::fft_complex > ifft;
+    gr_complex phase;            /* mixes out what the bins can't resolve */
+    gr_complex increment;
+    bool tag_rate;
+  };
+
+  void plan();
+  void filter( size_t first, size_t last );
+  void worker( size_t share, unsigned int job );
+
+  boost::mutex _mutex;
+  double _rate;
+  bool _replan;
+
+  std::vector< channel > _channels;
+  boost::shared_ptr< gr::fft::fft_complex > _fft;
+  size_t _size;    /* of the forward FFT */
+  size_t _step;    /* input samples per FFT, half of it */
+  size_t _outputs; /* produced per FFT by the fastest channel */
+  std::vector< gr_complex > _spectra;
+
+  /* the current job of the pool */
+  boost::mutex _pool_mutex;
+  boost::condition_variable _pool_cond;
+  boost::condition_variable _done_cond;
+  std::vector< boost::thread > _pool;
+  size_t _shares;
+  size_t _busy;
+  unsigned int _job;
+  bool _stop;
+  size_t _blocks;
+  gr_vector_void_star _out;
+};
+
+#endif // OSMOSDR_CHANNELIZER_CC_H
@@ -0,0 +1,139 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gnuradio/io_signature.h>
+
+#include <boost/bind.hpp>
+
+#include "command_handler.h"
+
+static double to_time( const pmt::pmt_t &value )
+{
+  /* (full seconds, fractional seconds) as used for timed commands elsewhere */
+  if ( pmt::is_tuple( value ) && pmt::length( value ) == 2 )
+    return double( pmt::to_uint64( pmt::tuple_ref( value, 0 ) ) ) +
+           pmt::to_double( pmt::tuple_ref( value, 1 ) );
+
+  return pmt::to_double( value );
+}
+
+command_t parse_command( const pmt::pmt_t &msg )
+{
+  command_t cmd;
+  pmt::pmt_t dict = msg;
+
+  if ( pmt::is_pair( msg ) && pmt::is_symbol( pmt::car( msg ) ) )
+    dict = pmt::dict_add( pmt::make_dict(), pmt::car( msg ), pmt::cdr( msg ) );
+  else if ( ! pmt::is_dict( msg ) )
+    return cmd;
+
+  pmt::pmt_t items = pmt::dict_items( dict );
+
+  for ( size_t i = 0; i < pmt::length( items ); i++ ) {
+    pmt::pmt_t item = pmt::nth( i, items );
+    std::string key = pmt::symbol_to_string( pmt::car( item ) );
+    pmt::pmt_t value = pmt::cdr( item );
+
+    if ( "freq" == key )
+      cmd.settings.center_freq = pmt::to_double( value );
+    else if ( "rate" == key )
+      cmd.settings.sample_rate = pmt::to_double( value );
+    else if ( "gain" == key )
+      cmd.settings.gain = pmt::to_double( value );
+    else if ( "gain_name" == key )
+      cmd.gain_name = pmt::symbol_to_string( value );
+    else if ( "antenna" == key )
+      cmd.settings.antenna = pmt::symbol_to_string( value );
+    else if ( "bw" == key )
+      cmd.settings.bandwidth = pmt::to_double( value );
+    else if ( "chan" == key )
+      cmd.chan = pmt::to_long( value );
+    else if ( "time" == key )
+      cmd.time = to_time( value );
+    else
+      continue;
+
+    cmd.known = true;
+  }
+
+  if ( ! cmd.gain_name.empty() ) {
+    cmd.stage_gain = cmd.settings.gain;
+    cmd.settings.gain = NAN;
+
+    if ( ! osmosdr::channel_settings::is_set( cmd.stage_gain ) )
+      throw std::runtime_error( "Command has a gain_name but no gain." );
+  }
+
+  return cmd;
+}
+
+pmt::pmt_t command_status( const command_t &cmd,
+                           const osmosdr::channel_settings &actual,
+                           double named_gain )
+{
+  typedef osmosdr::channel_settings cs;
+  pmt::pmt_t status = pmt::make_dict();
+
+  status = pmt::dict_add( status, pmt::mp("chan"), pmt::from_long( cmd.chan ) );
+
+  if ( cs::is_set( actual.center_freq ) )
+    status = pmt::dict_add( status, pmt::mp("freq"), pmt::from_double( actual.center_freq ) );
+  if ( cs::is_set( actual.sample_rate ) )
+    status = pmt::dict_add( status, pmt::mp("rate"), pmt::from_double( actual.sample_rate ) );
+  if ( cs::is_set( actual.gain ) )
+    status = pmt::dict_add( status, pmt::mp("gain"), pmt::from_double( actual.gain ) );
+  if ( ! cmd.gain_name.empty() ) {
+    status = pmt::dict_add( status, pmt::mp("gain"), pmt::from_double( named_gain ) );
+    status = pmt::dict_add( status, pmt::mp("gain_name"), pmt::mp( cmd.gain_name ) );
+  }
+  if ( ! actual.antenna.empty() )
+    status = pmt::dict_add( status, pmt::mp("antenna"), pmt::mp( actual.antenna ) );
+  if ( cs::is_set( actual.bandwidth ) )
+    status = pmt::dict_add( status, pmt::mp("bw"), pmt::from_double( actual.bandwidth ) );
+
+  return status;
+}
+
+command_handler_sptr make_command_handler( const command_apply_t &apply )
+{
+  return gnuradio::get_initial_sptr( new command_handler( apply ) );
+}
+
+command_handler::command_handler( const command_apply_t &apply ) :
+  gr::block( "command_handler",
+             gr::io_signature::make( 0, 0, 0 ),
+             gr::io_signature::make( 0, 0, 0 ) ),
+  _apply( apply )
+{
+  message_port_register_in( pmt::mp("command") );
+  message_port_register_out( pmt::mp("status") );
+  set_msg_handler( pmt::mp("command"),
+                   boost::bind( &command_handler::handle, this, _1 ) );
+}
+
+void command_handler::handle( pmt::pmt_t msg )
+{
+  pmt::pmt_t status = _apply( msg );
+
+  if ( ! pmt::is_null( status ) )
+    message_port_pub( pmt::mp("status"), status );
+}
@@ -0,0 +1,124 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_COMMAND_HANDLER_H
+#define OSMOSDR_COMMAND_HANDLER_H
+
+#include <cmath>
+#include <string>
+#include <stdexcept>
+
+#include <gnuradio/block.h>
+#include <pmt/pmt.h>
+
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <osmosdr/channel_settings.h>
+#include <osmosdr/time_spec.h>
+
+/*
+ * A command message: a dictionary with any of freq, rate, gain, gain_name,
+ * antenna, bw, chan and time, or a single (key . value) pair of it.
+ */
+struct command_t
+{
+  command_t() : stage_gain( NAN ), chan( 0 ), time( -1 ), known( false ) {}
+
+  osmosdr::channel_settings settings;
+  std::string gain_name;  /* with it, gain goes to stage_gain instead */
+  double stage_gain;
+  size_t chan;
+  double time;            /* device time to apply at, negative for now */
+  bool known;             /* whether any key was for us */
+};
+
+command_t parse_command( const pmt::pmt_t &msg );
+
+/* the values applied in reply to cmd, keyed like the command */
+pmt::pmt_t command_status( const command_t &cmd,
+                           const osmosdr::channel_settings &actual,
+                           double named_gain );
+
+/*
+ * Applies a command to a source or sink interface and returns its status,
+ * or PMT_NIL if the message wasn't meant for it. Timed commands wait for
+ * the device clock, keeping later ones queued behind them.
+ */
+template< typename iface_t >
+pmt::pmt_t apply_command( iface_t *dev, const pmt::pmt_t &msg )
+{
+  command_t cmd;
+
+  try {
+    cmd = parse_command( msg );
+    if ( ! cmd.known )
+      return pmt::PMT_NIL;
+
+    if ( cmd.time >= 0 ) {
+      double delay = cmd.time - dev->get_time_now( 0 ).get_real_secs();
+
+      if ( delay > 0 )
+        boost::this_thread::sleep( boost::posix_time::microseconds( long(delay * 1e6) ) );
+    }
+
+    osmosdr::channel_settings actual = dev->configure( cmd.settings, cmd.chan );
+
+    double named_gain = NAN;
+    if ( ! cmd.gain_name.empty() )
+      named_gain = dev->set_gain( cmd.stage_gain, cmd.gain_name, cmd.chan );
+
+    return command_status( cmd, actual, named_gain );
+  } catch ( std::exception &ex ) {
+    pmt::pmt_t status = pmt::make_dict();
+    status = pmt::dict_add( status, pmt::mp("chan"), pmt::from_long( cmd.chan ) );
+    status = pmt::dict_add( status, pmt::mp("error"), pmt::mp( ex.what() ) );
+    return status;
+  }
+}
+
+class command_handler;
+
+typedef boost::shared_ptr< command_handler > command_handler_sptr;
+
+typedef boost::function< pmt::pmt_t ( const pmt::pmt_t &msg ) > command_apply_t;
+
+command_handler_sptr make_command_handler( const command_apply_t &apply );
+
+/*!
+ * \brief Applies the messages of its "command" port on its own thread.
+ *
+ * Keeps retuning off the threads of the caller and of work(), and reports
+ * the values the device settled on on its "status" port.
+ */
+class command_handler : public gr::block
+{
+private:
+  friend command_handler_sptr make_command_handler( const command_apply_t &apply );
+
+  command_handler( const command_apply_t &apply );
+
+  void handle( pmt::pmt_t msg );
+
+  command_apply_t _apply;
+};
+
+#endif // OSMOSDR_COMMAND_HANDLER_H
@@ -30,75 +30,8 @@
 #include "config.h"
 #endif
 
-#ifdef ENABLE_OSMOSDR
-#include <osmosdr_src_c.h>
-#endif
-
-#ifdef ENABLE_FCD
-#include <fcd_source_c.h>
-#endif
-
-#ifdef ENABLE_FILE
-#include <file_source_c.h>
-#endif
-
-#ifdef ENABLE_RTL
-#include <rtl_source_c.h>
-#endif
-
-#ifdef ENABLE_RTL_TCP
-#include <rtl_tcp_source_c.h>
-#endif
-
-#ifdef ENABLE_UHD
-#include <uhd_source_c.h>
-#endif
-
-#ifdef ENABLE_MIRI
-#include <miri_source_c.h>
-#endif
-
-#ifdef ENABLE_SDRPLAY
-#include <sdrplay_source_c.h>
-#endif
-
-#ifdef ENABLE_HACKRF
-#include <hackrf_source_c.h>
-#endif
-
-#ifdef ENABLE_BLADERF
-#include <bladerf_source_c.h>
-#endif
-
-#ifdef ENABLE_RFSPACE
-#include <rfspace_source_c.h>
-#endif
-
-#ifdef ENABLE_AIRSPY
-#include <airspy_source_c.h>
-#endif
-
-#ifdef ENABLE_AIRSPYHF
-#include <airspyhf_source_c.h>
-#endif
-
-#ifdef ENABLE_SOAPY
-#include <soapy_source_c.h>
-#endif
-
-#ifdef ENABLE_REDPITAYA
-#include <redpitaya_source_c.h>
-#endif
-
-#ifdef ENABLE_FREESRP
-#include <freesrp_source_c.h>
-#endif
-
-#ifdef ENABLE_SPYSERVER
-#include <spyserver_source_c.h>
-#endif
-
 #include "arg_helpers.h"
+#include "driver_registry.h"
 
 using namespace osmosdr;
 
@@ -147,86 +80,10 @@ devices_t device::find(const device_t &hint)
 {
   boost::mutex::scoped_lock lock(_device_mutex);
 
-  bool fake = true;
-
-  if ( hint.count("nofake") )
-    fake = false;
-
   devices_t devices;
 
-#ifdef ENABLE_OSMOSDR
-  BOOST_FOREACH( std::string dev, osmosdr_src_c::get_devices() )
+  BOOST_FOREACH( std::string dev, probe_devices( source_probes(), hint ) )
     devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_FCD
-  BOOST_FOREACH( std::string dev, fcd_source_c::get_devices() )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_RTL
-  BOOST_FOREACH( std::string dev, rtl_source_c::get_devices() )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_UHD
-  BOOST_FOREACH( std::string dev, uhd_source_c::get_devices() )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_MIRI
-  BOOST_FOREACH( std::string dev, miri_source_c::get_devices() )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_SDRPLAY
-  BOOST_FOREACH( std::string dev, sdrplay_source_c::get_devices() )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_BLADERF
-  BOOST_FOREACH( std::string dev, bladerf_source_c::get_devices() )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_HACKRF
-  BOOST_FOREACH( std::string dev, hackrf_source_c::get_devices() )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_RFSPACE
-  BOOST_FOREACH( std::string dev, rfspace_source_c::get_devices( fake ) )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_AIRSPY
-  BOOST_FOREACH( std::string dev, airspy_source_c::get_devices() )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_AIRSPYHF
-  BOOST_FOREACH( std::string dev, airspyhf_source_c::get_devices() )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_FREESRP
-  BOOST_FOREACH( std::string dev, freesrp_source_c::get_devices() )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_SOAPY
-  BOOST_FOREACH( std::string dev, soapy_source_c::get_devices() )
-    devices.push_back( device_t(dev) );
-#endif
-
-  /* software-only sources should be appended at the very end,
-   * hopefully resulting in hardware sources to be shown first
-   * in a graphical interface etc... */
-
-#ifdef ENABLE_RTL_TCP
-  BOOST_FOREACH( std::string dev, rtl_tcp_source_c::get_devices( fake ) )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_SPYSERVER
-  BOOST_FOREACH( std::string dev, spyserver_source_c::get_devices( fake ) )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_REDPITAYA
-  BOOST_FOREACH( std::string dev, redpitaya_source_c::get_devices( fake ) )
-    devices.push_back( device_t(dev) );
-#endif
-#ifdef ENABLE_FILE
-  BOOST_FOREACH( std::string dev, file_source_c::get_devices( fake ) )
-    devices.push_back( device_t(dev) );
-#endif
 
   return devices;
 }
@@ -0,0 +1,155 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/exception_ptr.hpp>
+
+#include "device_executor.h"
+
+device_executor::device_executor() :
+  _stop(false)
+{
+}
+
+device_executor::~device_executor()
+{
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+    _stop = true;
+  }
+
+  _cond.notify_all();
+
+  if ( _thread.joinable() )
+    _thread.join();
+}
+
+void device_executor::post( const job_t &job )
+{
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    _jobs.push_back( job );
+
+    if ( ! _thread.joinable() )
+      _thread = boost::thread( &device_executor::run, this );
+  }
+
+  _cond.notify_one();
+}
+
+static double run_job( const device_executor::job_t &job )
+{
+  job();
+  return 0;
+}
+
+void device_executor::call( const job_t &job )
+{
+  std::vector< task_t > tasks;
+  tasks.push_back( task_t( this, boost::bind( run_job, job ) ) );
+
+  run_all( tasks ).get();
+}
+
+void device_executor::run()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  while ( true ) {
+    while ( _jobs.empty() && ! _stop )
+      _cond.wait( lock );
+
+    if ( _jobs.empty() )
+      break;
+
+    job_t job = _jobs.front();
+    _jobs.pop_front();
+
+    lock.unlock();
+    job();
+    lock.lock();
+  }
+}
+
+struct fan_out
+{
+  boost::mutex mutex;
+  size_t remaining;
+  double value;
+  boost::exception_ptr error;
+  boost::promise< double > promise;
+};
+
+static void run_task( boost::shared_ptr< fan_out > fan, size_t index,
+                      const device_executor::setting_t &setting )
+{
+  double value = 0;
+  boost::exception_ptr error;
+
+  try {
+    value = setting();
+  } catch ( ... ) {
+    error = boost::current_exception();
+  }
+
+  boost::mutex::scoped_lock lock( fan->mutex );
+
+  if ( index == 0 )
+    fan->value = value;
+
+  if ( error && ! fan->error )
+    fan->error = error;
+
+  if ( --fan->remaining == 0 ) {
+    if ( fan->error )
+      fan->promise.set_exception( fan->error );
+    else
+      fan->promise.set_value( fan->value );
+  }
+}
+
+boost::shared_future< double > device_executor::run_all( const std::vector< task_t > &tasks )
+{
+  if ( tasks.empty() )
+    return ready( 0 );
+
+  boost::shared_ptr< fan_out > fan = boost::make_shared< fan_out >();
+  fan->remaining = tasks.size();
+  fan->value = 0;
+
+  boost::shared_future< double > future( fan->promise.get_future() );
+
+  for ( size_t i = 0; i < tasks.size(); i++ )
+    tasks[i].first->post( boost::bind( run_task, fan, i, tasks[i].second ) );
+
+  return future;
+}
+
+boost::shared_future< double > device_executor::ready( double value )
+{
+  boost::promise< double > promise;
+  promise.set_value( value );
+
+  return boost::shared_future< double >( promise.get_future() );
+}
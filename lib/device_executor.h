@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_DEVICE_EXECUTOR_H
+#define OSMOSDR_DEVICE_EXECUTOR_H
+
+#include <deque>
+#include <vector>
+#include <utility>
+
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/future.hpp>
+
+#include <osmosdr/api.h>
+
+/*
+ * Runs the control calls of one device on its own thread, one after the
+ * other, so callers don't block on USB or network round trips and calls
+ * on different devices of a group overlap.
+ */
+class OSMOSDR_API device_executor
+{
+public:
+  typedef boost::function< void () > job_t;
+  typedef boost::function< double () > setting_t;
+  typedef std::pair< device_executor *, setting_t > task_t;
+
+  device_executor();
+
+  /* finishes the jobs already queued */
+  ~device_executor();
+
+  void post( const job_t &job );
+
+  /* runs job on the executor and waits for it, rethrowing its errors */
+  void call( const job_t &job );
+
+  /*
+   * Queues every setting on its executor. The future is ready once all of
+   * them are done and carries the value of the first one, or the first
+   * error thrown.
+   */
+  static boost::shared_future< double > run_all( const std::vector< task_t > &tasks );
+
+  static boost::shared_future< double > ready( double value );
+
+private:
+  void run();
+
+  boost::mutex _mutex;
+  boost::condition_variable _cond;
+  std::deque< job_t > _jobs;
+  boost::thread _thread;
+  bool _stop;
+};
+
+#endif // OSMOSDR_DEVICE_EXECUTOR_H
@@ -0,0 +1,134 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <vector>
+#include <iostream>
+
+#include <boost/foreach.hpp>
+
+#include "device_pool.h"
+
+device_pool &device_pool::instance()
+{
+  static device_pool pool;
+  return pool;
+}
+
+device_pool::device_pool() :
+  _stop(false)
+{
+}
+
+device_pool::~device_pool()
+{
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+    _stop = true;
+  }
+
+  _cond.notify_all();
+
+  if ( _reaper.joinable() )
+    _reaper.join();
+
+  typedef std::multimap< std::string, entry >::value_type idle_t;
+  BOOST_FOREACH( idle_t &idle, _idle )
+    idle.second.close( idle.second.handle );
+}
+
+void *device_pool::claim( const std::string &key, device_settings_sptr &settings )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  std::multimap< std::string, entry >::iterator it = _idle.find( key );
+  if ( it == _idle.end() )
+    return NULL;
+
+  void *handle = it->second.handle;
+  settings = it->second.settings;
+  _idle.erase( it );
+
+  std::cerr << "Reusing open device " << key << std::endl;
+
+  return handle;
+}
+
+void device_pool::release( const std::string &key, void *handle, close_fn_t close,
+                           device_settings_sptr settings, double linger )
+{
+  if ( linger <= 0 ) {
+    close( handle );
+    return;
+  }
+
+  entry e;
+  e.handle = handle;
+  e.close = close;
+  e.settings = settings;
+  e.expires = osmosdr::time_spec_t::get_system_time() + osmosdr::time_spec_t( linger );
+
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    _idle.insert( std::make_pair( key, e ) );
+
+    if ( ! _reaper.joinable() )
+      _reaper = boost::thread( &device_pool::reap, this );
+  }
+
+  _cond.notify_all();
+}
+
+void device_pool::reap()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  while ( ! _stop ) {
+    osmosdr::time_spec_t now = osmosdr::time_spec_t::get_system_time();
+    osmosdr::time_spec_t next = now + osmosdr::time_spec_t( 1.0 );
+    std::vector< entry > expired;
+
+    std::multimap< std::string, entry >::iterator it = _idle.begin();
+    while ( it != _idle.end() ) {
+      if ( it->second.expires <= now ) {
+        expired.push_back( it->second );
+        _idle.erase( it++ );
+      } else {
+        if ( it->second.expires < next )
+          next = it->second.expires;
+        ++it;
+      }
+    }
+
+    if ( ! expired.empty() ) {
+      /* closing may take a while, don't hold up claims meanwhile */
+      lock.unlock();
+      BOOST_FOREACH( entry &e, expired )
+        e.close( e.handle );
+      lock.lock();
+      continue;
+    }
+
+    _cond.timed_wait( lock, boost::posix_time::microseconds(
+                        long((next - now).get_real_secs() * 1e6) + 1 ) );
+  }
+}
@@ -0,0 +1,115 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_DEVICE_POOL_H
+#define OSMOSDR_DEVICE_POOL_H
+
+#include <map>
+#include <string>
+
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <osmosdr/api.h>
+#include <osmosdr/time_spec.h>
+
+#include "arg_helpers.h"
+
+/*
+ * The settings last sent to a device, kept along with its handle so a
+ * block claiming a warm handle does not send the same values again.
+ */
+class device_settings
+{
+public:
+  bool cached( const std::string &key, double value )
+  {
+    std::map< std::string, double >::iterator it = _values.find( key );
+    return it != _values.end() && it->second == value;
+  }
+
+  void store( const std::string &key, double value ) { _values[key] = value; }
+  void forget( const std::string &key ) { _values.erase( key ); }
+
+private:
+  std::map< std::string, double > _values;
+};
+
+typedef boost::shared_ptr< device_settings > device_settings_sptr;
+
+/*
+ * Keeps the handles of closed blocks open for a grace period, given with
+ * the "linger" argument in seconds, so a block re-created for the same
+ * device (keyed by driver and serial) takes it over instead of reopening
+ * the hardware. Handles nobody claimed in time are closed in the
+ * background, the remaining ones when the process exits.
+ */
+class OSMOSDR_API device_pool
+{
+public:
+  typedef boost::function< void ( void * ) > close_fn_t;
+
+  static device_pool &instance();
+
+  ~device_pool();
+
+  /* a warm handle for key along with its settings, NULL if there is none */
+  void *claim( const std::string &key, device_settings_sptr &settings );
+
+  /* hands a handle back, it is closed right away when linger is not positive */
+  void release( const std::string &key, void *handle, close_fn_t close,
+                device_settings_sptr settings, double linger );
+
+private:
+  device_pool();
+
+  struct entry
+  {
+    void *handle;
+    close_fn_t close;
+    device_settings_sptr settings;
+    osmosdr::time_spec_t expires;
+  };
+
+  void reap();
+
+  boost::mutex _mutex;
+  boost::condition_variable _cond;
+  std::multimap< std::string, entry > _idle;
+  boost::thread _reaper;
+  bool _stop;
+};
+
+/* the "linger" device argument */
+inline double pool_linger( const dict_t &dict )
+{
+  dict_t::const_iterator it = dict.find( "linger" );
+
+  if ( it == dict.end() || it->second.empty() )
+    return 0;
+
+  return boost::lexical_cast< double >( it->second );
+}
+
+#endif // OSMOSDR_DEVICE_POOL_H
@@ -0,0 +1,260 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <map>
+#include <sstream>
+#include <iostream>
+
+#include <dirent.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <osmosdr/time_spec.h>
+
+#include "device_probe.h"
+
+#define PROBE_TIMEOUT           2.0
+#define PROBE_NETWORK_TIMEOUT   5.0
+#define PROBE_CACHE_TTL         5.0
+
+struct probe_job
+{
+  probe_job() : done(false) {}
+
+  boost::mutex lock;
+  boost::condition_variable finished;
+  bool done;
+  std::vector< std::string > devices;
+  std::string error;
+};
+
+typedef boost::shared_ptr< probe_job > probe_job_sptr;
+
+struct probe_cache_entry
+{
+  double stamp;
+  std::string usb_state;
+  std::vector< std::string > devices;
+};
+
+/* source and sink backends share type names, tell them apart by function */
+typedef std::pair< uintptr_t, bool > probe_key_t;
+
+static boost::mutex _probe_mutex;
+static std::map< probe_key_t, probe_cache_entry > _probe_cache;
+/* probes that did not finish in time keep running, don't start them twice */
+static std::map< probe_key_t, probe_job_sptr > _probe_jobs;
+
+static double now()
+{
+  return osmosdr::time_spec_t::get_system_time().get_real_secs();
+}
+
+/* changes whenever a usb device comes or goes */
+static std::string usb_state()
+{
+  std::ostringstream state;
+
+#ifdef __linux__
+  DIR *dir = opendir( "/dev/bus/usb" );
+  if ( ! dir )
+    return "";
+
+  struct dirent *ent;
+  while ( (ent = readdir( dir )) != NULL ) {
+    std::string path = std::string( "/dev/bus/usb/" ) + ent->d_name;
+    struct stat st;
+
+    if ( ent->d_name[0] != '.' && stat( path.c_str(), &st ) == 0 )
+      state << ent->d_name << ":" << st.st_mtim.tv_sec << "."
+            << st.st_mtim.tv_nsec << " ";
+  }
+
+  closedir( dir );
+#endif
+
+  return state.str();
+}
+
+static void run_probe( probe_job_sptr job, probe_fn_t get_devices, bool fake )
+{
+  std::vector< std::string > devices;
+  std::string error;
+
+  try {
+    devices = get_devices( fake );
+  } catch ( std::exception &ex ) {
+    error = ex.what();
+  }
+
+  boost::mutex::scoped_lock lock( job->lock );
+
+  job->devices.swap( devices );
+  job->error = error;
+  job->done = true;
+
+  job->finished.notify_all();
+}
+
+static bool wanted( const device_probe &probe, const osmosdr::device_t &hint,
+                    bool typed )
+{
+  if ( hint.count("nosoftware") && (probe.flags & PROBE_SOFTWARE) )
+    return false;
+
+  if ( ! typed )
+    return true;
+
+  std::vector< std::string > types;
+  boost::algorithm::split( types, probe.types, boost::is_any_of(" ") );
+
+  BOOST_FOREACH( std::string &type, types )
+    if ( hint.count( type ) )
+      return true;
+
+  return false;
+}
+
+std::vector< std::string > probe_devices( const std::vector< device_probe > &probes,
+                                          const osmosdr::device_t &hint )
+{
+  boost::mutex::scoped_lock probe_lock( _probe_mutex );
+
+  bool fake = ! hint.count("nofake");
+  bool cache = ! hint.count("nocache");
+  double ttl = hint.cast< double >( "ttl", PROBE_CACHE_TTL );
+  double timeout = hint.cast< double >( "timeout", 0 );
+
+  /* a hint naming device types narrows the search down to them */
+  bool typed = false;
+  BOOST_FOREACH( const device_probe &probe, probes ) {
+    std::vector< std::string > types;
+    boost::algorithm::split( types, probe.types, boost::is_any_of(" ") );
+
+    BOOST_FOREACH( std::string &type, types )
+      typed |= ( hint.count( type ) > 0 );
+  }
+
+  std::string usb = usb_state();
+  double start = now();
+
+  std::vector< std::vector< std::string > > results( probes.size() );
+  std::vector< probe_job_sptr > jobs( probes.size() );
+
+  for ( size_t i = 0; i < probes.size(); i++ ) {
+    const device_probe &probe = probes[i];
+
+    if ( ! wanted( probe, hint, typed ) )
+      continue;
+
+    /* cheap enough to be asked inline, every time */
+    if ( probe.flags & PROBE_SOFTWARE ) {
+      try {
+        results[i] = probe.get_devices( fake );
+      } catch ( std::exception &ex ) {
+        std::cerr << "Probing " << probe.types << " failed: " << ex.what() << std::endl;
+      }
+      continue;
+    }
+
+    probe_key_t key( uintptr_t( probe.get_devices ), fake );
+
+    if ( cache && _probe_cache.count( key ) ) {
+      probe_cache_entry &entry = _probe_cache[key];
+
+      if ( start - entry.stamp < ttl &&
+           ( ! (probe.flags & PROBE_USB) || entry.usb_state == usb ) ) {
+        results[i] = entry.devices;
+        continue;
+      }
+    }
+
+    if ( _probe_jobs.count( key ) ) {
+      jobs[i] = _probe_jobs[key]; /* still busy from an earlier call */
+      continue;
+    }
+
+    jobs[i] = probe_job_sptr( new probe_job );
+    _probe_jobs[key] = jobs[i];
+
+    boost::thread( boost::bind( run_probe, jobs[i], probe.get_devices, fake ) ).detach();
+  }
+
+  for ( size_t i = 0; i < probes.size(); i++ ) {
+    if ( ! jobs[i] )
+      continue;
+
+    const device_probe &probe = probes[i];
+    probe_key_t key( uintptr_t( probe.get_devices ), fake );
+
+    double limit = timeout;
+    if ( limit <= 0 )
+      limit = (probe.flags & PROBE_NETWORK) ? PROBE_NETWORK_TIMEOUT : PROBE_TIMEOUT;
+
+    /* all probes run at once, so the deadlines count from the start */
+    boost::system_time deadline = boost::get_system_time() +
+      boost::posix_time::microseconds( int64_t( (start + limit - now()) * 1e6 ) );
+
+    boost::mutex::scoped_lock lock( jobs[i]->lock );
+
+    while ( ! jobs[i]->done )
+      if ( ! jobs[i]->finished.timed_wait( lock, deadline ) )
+        break;
+
+    if ( ! jobs[i]->done ) {
+      std::cerr << "Probing " << probe.types << " timed out after "
+                << limit << " s" << std::endl;
+      continue;
+    }
+
+    _probe_jobs.erase( key );
+
+    if ( jobs[i]->error.length() ) {
+      std::cerr << "Probing " << probe.types << " failed: "
+                << jobs[i]->error << std::endl;
+      continue;
+    }
+
+    results[i] = jobs[i]->devices;
+
+    probe_cache_entry &entry = _probe_cache[key];
+    entry.stamp = now();
+    entry.usb_state = usb;
+    entry.devices = results[i];
+  }
+
+  std::vector< std::string > devices;
+
+  BOOST_FOREACH( std::vector< std::string > &result, results )
+    devices.insert( devices.end(), result.begin(), result.end() );
+
+  return devices;
+}
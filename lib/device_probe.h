@@ -0,0 +1,63 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_DEVICE_PROBE_H
+#define OSMOSDR_DEVICE_PROBE_H
+
+#include <string>
+#include <vector>
+
+#include <osmosdr/device.h>
+
+#define PROBE_USB       0x1 /* local hardware, results go stale on hotplug */
+#define PROBE_NETWORK   0x2 /* discovers devices over the network */
+#define PROBE_SOFTWARE  0x4 /* no hardware involved, cheap to ask */
+
+typedef std::vector< std::string > (*probe_fn_t)( bool fake );
+
+/*
+ * A backend taking part in device enumeration.
+ */
+struct device_probe
+{
+  device_probe( const char *types = "", int flags = 0, probe_fn_t get_devices = NULL ) :
+    types(types), flags(flags), get_devices(get_devices) {}
+
+  const char *types;        /* device type keys it answers to, space separated */
+  int flags;
+  probe_fn_t get_devices;
+};
+
+/*
+ * Asks the given backends for their devices, in parallel, and returns the
+ * results in the order of the backends.
+ *
+ * Backends are skipped if the hint names device types of other backends
+ * only, or if it holds "nosoftware" and they are software-only. Hardware
+ * backends are given 2 s (5 s when discovering over the network) unless
+ * the hint overrides it with "timeout=<seconds>", late ones are reported
+ * and left out. Their results are cached for "ttl=<seconds>" (5 s by
+ * default), until the usb bus changes, or ignored with "nocache".
+ */
+std::vector< std::string > probe_devices( const std::vector< device_probe > &probes,
+                                          const osmosdr::device_t &hint );
+
+#endif // OSMOSDR_DEVICE_PROBE_H
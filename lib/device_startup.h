@@ -0,0 +1,195 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_DEVICE_STARTUP_H
+#define OSMOSDR_DEVICE_STARTUP_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+
+#include <boost/foreach.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <osmosdr/time_spec.h>
+
+#include "arg_helpers.h"
+
+/* "key" alone counts as set, "key=0" does not */
+inline bool dict_flag( const dict_t &dict, const std::string &key )
+{
+  dict_t::const_iterator it = dict.find( key );
+
+  if ( it == dict.end() )
+    return false;
+
+  return it->second.empty() || boost::lexical_cast< bool >( it->second );
+}
+
+/*
+ * Measures how long the phases of bringing up a device take, from the
+ * construction of the driver block up to its first sample. Each phase()
+ * call closes the phase that just ended, first_sample() closes the last
+ * one and prints the breakdown when enabled with the "timing" argument.
+ */
+class startup_timer
+{
+public:
+  startup_timer() : _enabled(false), _done(false)
+  {
+    _last = osmosdr::time_spec_t::get_system_time();
+  }
+
+  void init( const dict_t &dict, const std::string &name )
+  {
+    _name = name;
+    _enabled = dict_flag( dict, "timing" );
+  }
+
+  void phase( const std::string &name )
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    osmosdr::time_spec_t now = osmosdr::time_spec_t::get_system_time();
+    _phases.push_back( std::make_pair( name, (now - _last).get_real_secs() ) );
+    _last = now;
+  }
+
+  /* cheap enough to be called from the streaming path */
+  void first_sample()
+  {
+    if ( _done )
+      return;
+
+    _done = true;
+    phase( "first sample" );
+
+    if ( _enabled )
+      std::cerr << report() << std::endl;
+  }
+
+  std::string report()
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    std::ostringstream ss;
+    double total = 0;
+
+    ss << _name << " startup:";
+    for ( size_t i = 0; i < _phases.size(); i++ ) {
+      ss << (i ? ", " : " ") << _phases[i].first << " "
+         << int(_phases[i].second * 1e3 + 0.5) << " ms";
+      total += _phases[i].second;
+    }
+    ss << " (total " << int(total * 1e3 + 0.5) << " ms)";
+
+    return ss.str();
+  }
+
+private:
+  boost::mutex _mutex;
+  std::string _name;
+  bool _enabled;
+  bool _done;
+  osmosdr::time_spec_t _last;
+  std::vector< std::pair< std::string, double > > _phases;
+};
+
+/*
+ * Default settings a driver applies right after opening its device. With
+ * the "fast" argument they are held back until start() instead, and those
+ * the caller sets explicitly in the meantime are never sent to the device.
+ */
+class deferred_defaults
+{
+public:
+  deferred_defaults() : _deferred(false) {}
+
+  void init( const dict_t &dict ) { _deferred = dict_flag( dict, "fast" ); }
+  bool deferred( void ) { return _deferred; }
+
+  /* runs fn right away, unless deferred */
+  void add( const std::string &key, const boost::function< void () > &fn )
+  {
+    if ( ! _deferred ) {
+      fn();
+      return;
+    }
+
+    boost::mutex::scoped_lock lock( _mutex );
+    _pending.push_back( std::make_pair( key, fn ) );
+  }
+
+  /* the setting has been made explicitly */
+  void cancel( const std::string &key )
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    for ( size_t i = 0; i < _pending.size(); )
+      if ( _pending[i].first == key )
+        _pending.erase( _pending.begin() + i );
+      else
+        i++;
+  }
+
+  /* applies a default now if still pending, for settings depending on it */
+  void flush( const std::string &key )
+  {
+    boost::function< void () > fn;
+
+    {
+      boost::mutex::scoped_lock lock( _mutex );
+
+      for ( size_t i = 0; i < _pending.size(); i++ )
+        if ( _pending[i].first == key ) {
+          fn = _pending[i].second;
+          _pending.erase( _pending.begin() + i );
+          break;
+        }
+    }
+
+    if ( fn )
+      fn();
+  }
+
+  /* applies what is still pending, in the order it was added */
+  void apply( void )
+  {
+    std::vector< std::pair< std::string, boost::function< void () > > > pending;
+
+    {
+      boost::mutex::scoped_lock lock( _mutex );
+      pending.swap( _pending );
+    }
+
+    for ( size_t i = 0; i < pending.size(); i++ )
+      pending[i].second();
+  }
+
+private:
+  boost::mutex _mutex;
+  bool _deferred;
+  std::vector< std::pair< std::string, boost::function< void () > > > _pending;
+};
+
+#endif // OSMOSDR_DEVICE_STARTUP_H
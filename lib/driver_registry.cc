@@ -0,0 +1,273 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <set>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+
+#include "config.h"
+
+#ifdef ENABLE_PLUGINS
+#include <dlfcn.h>
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#include "driver_registry.h"
+
+#define PLUGIN_PREFIX "libgnuradio-osmosdr-"
+#define PLUGIN_SUFFIX ".so"
+
+/* recursive, as loading a plugin registers its drivers */
+static boost::recursive_mutex &registry_mutex()
+{
+  static boost::recursive_mutex mutex;
+  return mutex;
+}
+
+/* function-local, drivers register during static initialization */
+static std::vector< source_driver > &source_registry()
+{
+  static std::vector< source_driver > drivers;
+  return drivers;
+}
+
+static std::vector< sink_driver > &sink_registry()
+{
+  static std::vector< sink_driver > drivers;
+  return drivers;
+}
+
+static std::vector< std::string > split_types( const char *types )
+{
+  std::vector< std::string > list;
+  boost::algorithm::split( list, types, boost::is_any_of(" ") );
+  return list;
+}
+
+void register_source_driver( const source_driver &driver )
+{
+  boost::recursive_mutex::scoped_lock lock( registry_mutex() );
+
+  source_registry().push_back( driver );
+}
+
+void register_sink_driver( const sink_driver &driver )
+{
+  boost::recursive_mutex::scoped_lock lock( registry_mutex() );
+
+  sink_registry().push_back( driver );
+}
+
+#ifdef ENABLE_PLUGINS
+static std::set< std::string > _plugins_tried;
+static bool _plugins_all_tried = false;
+
+static std::vector< std::string > plugin_dirs()
+{
+  std::vector< std::string > dirs;
+
+  const char *path = getenv( "OSMOSDR_PLUGIN_PATH" );
+  if ( path && *path )
+    boost::algorithm::split( dirs, path, boost::is_any_of(":") );
+
+  dirs.push_back( OSMOSDR_PLUGIN_DIR );
+
+  return dirs;
+}
+
+static std::vector< std::string > plugin_names()
+{
+  std::vector< std::string > names;
+  std::string prefix = PLUGIN_PREFIX, suffix = PLUGIN_SUFFIX;
+
+  BOOST_FOREACH( std::string dir, plugin_dirs() ) {
+    DIR *d = opendir( dir.c_str() );
+    if ( ! d )
+      continue;
+
+    struct dirent *ent;
+    while ( (ent = readdir( d )) != NULL ) {
+      std::string file = ent->d_name;
+
+      if ( file.size() > prefix.size() + suffix.size() &&
+           boost::algorithm::starts_with( file, prefix ) &&
+           boost::algorithm::ends_with( file, suffix ) )
+        names.push_back( file.substr( prefix.size(),
+                                      file.size() - prefix.size() - suffix.size() ) );
+    }
+
+    closedir( d );
+  }
+
+  return names;
+}
+
+/* a broken vendor library only takes its own backend down */
+static void load_plugin( const std::string &name )
+{
+  if ( _plugins_tried.count( name ) )
+    return;
+
+  _plugins_tried.insert( name );
+
+  BOOST_FOREACH( std::string dir, plugin_dirs() ) {
+    std::string path = dir + "/" PLUGIN_PREFIX + name + PLUGIN_SUFFIX;
+
+    if ( access( path.c_str(), R_OK ) != 0 )
+      continue;
+
+    if ( ! dlopen( path.c_str(), RTLD_NOW | RTLD_LOCAL ) )
+      std::cerr << "Failed to load driver plugin '" << name << "': "
+                << dlerror() << std::endl;
+
+    return;
+  }
+}
+
+static void load_all_plugins()
+{
+  if ( _plugins_all_tried )
+    return;
+
+  _plugins_all_tried = true;
+
+  BOOST_FOREACH( std::string name, plugin_names() )
+    load_plugin( name );
+}
+#endif
+
+template < typename T >
+static bool match( const std::vector< T > &registry, const dict_t &dict, T &driver )
+{
+  BOOST_FOREACH( const T &candidate, registry )
+    BOOST_FOREACH( std::string type, split_types( candidate.probe.types ) )
+      if ( dict.count( type ) ) {
+        driver = candidate;
+        return true;
+      }
+
+  return false;
+}
+
+template < typename T >
+static bool find_driver( const std::vector< T > &registry, const dict_t &dict, T &driver )
+{
+  boost::recursive_mutex::scoped_lock lock( registry_mutex() );
+
+  if ( match( registry, dict, driver ) )
+    return true;
+
+#ifdef ENABLE_PLUGINS
+  /* plugins are named after the main device type of their backend */
+  BOOST_FOREACH( const dict_t::value_type &entry, dict )
+    if ( entry.first.find_first_of( "/." ) == std::string::npos )
+      load_plugin( entry.first );
+
+  if ( match( registry, dict, driver ) )
+    return true;
+
+  load_all_plugins();
+
+  return match( registry, dict, driver );
+#else
+  return false;
+#endif
+}
+
+bool find_source_driver( const dict_t &dict, source_driver &driver )
+{
+  return find_driver( source_registry(), dict, driver );
+}
+
+bool find_sink_driver( const dict_t &dict, sink_driver &driver )
+{
+  return find_driver( sink_registry(), dict, driver );
+}
+
+static bool software_last( const device_probe &a, const device_probe &b )
+{
+  return !(a.flags & PROBE_SOFTWARE) && (b.flags & PROBE_SOFTWARE);
+}
+
+template < typename T >
+static std::vector< device_probe > probes( const std::vector< T > &registry )
+{
+  boost::recursive_mutex::scoped_lock lock( registry_mutex() );
+
+#ifdef ENABLE_PLUGINS
+  load_all_plugins();
+#endif
+
+  std::vector< device_probe > list;
+  BOOST_FOREACH( const T &driver, registry )
+    list.push_back( driver.probe );
+
+  /* hardware sources should be shown first in a graphical interface etc... */
+  std::stable_sort( list.begin(), list.end(), software_last );
+
+  return list;
+}
+
+std::vector< device_probe > source_probes()
+{
+  return probes( source_registry() );
+}
+
+std::vector< device_probe > sink_probes()
+{
+  return probes( sink_registry() );
+}
+
+template < typename T >
+static std::vector< std::string > types( const std::vector< T > &registry )
+{
+  boost::recursive_mutex::scoped_lock lock( registry_mutex() );
+
+  std::vector< std::string > list;
+  BOOST_FOREACH( const T &driver, registry )
+    list.push_back( split_types( driver.probe.types ).front() );
+
+#ifdef ENABLE_PLUGINS
+  /* not loaded yet, named after their main device type */
+  BOOST_FOREACH( std::string name, plugin_names() )
+    if ( ! _plugins_tried.count( name ) )
+      list.push_back( name );
+#endif
+
+  return list;
+}
+
+std::vector< std::string > source_types()
+{
+  return types( source_registry() );
+}
+
+std::vector< std::string > sink_types()
+{
+  return types( sink_registry() );
+}
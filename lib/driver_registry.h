@@ -0,0 +1,115 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_DRIVER_REGISTRY_H
+#define OSMOSDR_DRIVER_REGISTRY_H
+
+#include <string>
+#include <vector>
+
+#include <gnuradio/basic_block.h>
+
+#include <osmosdr/api.h>
+
+#include "arg_helpers.h"
+#include "device_probe.h"
+
+class source_iface;
+class sink_iface;
+
+typedef gr::basic_block_sptr (*make_source_fn_t)( const std::string &args,
+                                                  source_iface *&iface );
+typedef gr::basic_block_sptr (*make_sink_fn_t)( const std::string &args,
+                                                sink_iface *&iface );
+
+/*
+ * A backend as seen by the source and sink blocks: the device type keys
+ * it answers to, how to enumerate its devices and how to make a block.
+ */
+struct source_driver
+{
+  device_probe probe;
+  make_source_fn_t make;
+};
+
+struct sink_driver
+{
+  device_probe probe;
+  make_sink_fn_t make;
+};
+
+OSMOSDR_API void register_source_driver( const source_driver &driver );
+OSMOSDR_API void register_sink_driver( const sink_driver &driver );
+
+/*
+ * Look up the driver for the device type keys in dict. With plugins, the
+ * module named after a key is loaded on first use, all of them if none
+ * matches.
+ */
+bool find_source_driver( const dict_t &dict, source_driver &driver );
+bool find_sink_driver( const dict_t &dict, sink_driver &driver );
+
+/* every driver available, hardware first, loading all plugins */
+std::vector< device_probe > source_probes();
+std::vector< device_probe > sink_probes();
+
+/* device type keys known, without loading anything */
+std::vector< std::string > source_types();
+std::vector< std::string > sink_types();
+
+struct source_driver_registrar
+{
+  source_driver_registrar( const char *types, int flags, probe_fn_t get_devices,
+                           make_source_fn_t make )
+  {
+    source_driver driver = { device_probe( types, flags, get_devices ), make };
+    register_source_driver( driver );
+  }
+};
+
+struct sink_driver_registrar
+{
+  sink_driver_registrar( const char *types, int flags, probe_fn_t get_devices,
+                         make_sink_fn_t make )
+  {
+    sink_driver driver = { device_probe( types, flags, get_devices ), make };
+    register_sink_driver( driver );
+  }
+};
+
+/*
+ * Registers a backend from its translation unit, so it is known once its
+ * code is loaded, be it as part of the library or as a plugin. devices is
+ * an expression listing the devices, with bool fake in scope.
+ */
+#define OSMOSDR_REGISTER_SOURCE( name, types, flags, make_fn, devices ) \
+  static source_driver_registrar name##_source_registrar( types, flags, \
+    []( bool fake ) -> std::vector< std::string > { return devices; }, \
+    []( const std::string &args, source_iface *&iface ) -> gr::basic_block_sptr { \
+      auto block = make_fn( args ); iface = block.get(); return block; } )
+
+#define OSMOSDR_REGISTER_SINK( name, types, flags, make_fn, devices ) \
+  static sink_driver_registrar name##_sink_registrar( types, flags, \
+    []( bool fake ) -> std::vector< std::string > { return devices; }, \
+    []( const std::string &args, sink_iface *&iface ) -> gr::basic_block_sptr { \
+      auto block = make_fn( args ); iface = block.get(); return block; } )
+
+#endif // OSMOSDR_DRIVER_REGISTRY_H
@@ -28,6 +28,7 @@
 #include <gnuradio/io_signature.h>
 
 #include "fcd_source_c.h"
+#include "driver_registry.h"
 
 #include "arg_helpers.h"
 
@@ -433,3 +434,6 @@ std::string fcd_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+OSMOSDR_REGISTER_SOURCE( fcd, "fcd", PROBE_USB,
+                         make_fcd_source_c, fcd_source_c::get_devices() );
@@ -0,0 +1,243 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <sys/time.h>
+
+#include <boost/format.hpp>
+
+#include <gnuradio/io_signature.h>
+
+#include "archive_sink_c.h"
+
+#define CHUNK_DURATION  0.1 /* seconds of samples per chunk */
+#define CHUNK_MIN_LEN   4096
+#define CHUNK_NUM       20 /* up to 2 seconds of disk stalls are absorbed */
+
+archive_sink_c_sptr make_archive_sink_c( const std::string &dir,
+                                         double rate,
+                                         double freq,
+                                         sample_format fmt,
+                                         double segment,
+                                         double retain_time,
+                                         double retain_bytes )
+{
+  return gnuradio::get_initial_sptr(
+        new archive_sink_c( dir, rate, freq, fmt, segment,
+                            retain_time, retain_bytes ) );
+}
+
+archive_sink_c::archive_sink_c( const std::string &dir,
+                                double rate,
+                                double freq,
+                                sample_format fmt,
+                                double segment,
+                                double retain_time,
+                                double retain_bytes ) :
+  gr::sync_block( "archive_sink_c",
+                  gr::io_signature::make(1, 1, sizeof (gr_complex)),
+                  gr::io_signature::make(0, 0, 0) ),
+  _fmt(fmt),
+  _item_size(sample_format_size(fmt)),
+  _rate(rate),
+  _current(-1),
+  _start_time(0),
+  _samples(0),
+  _dropped(0),
+  _running(false)
+{
+  if ( rate <= 0 )
+    throw std::runtime_error("Archive requires a sample rate.");
+
+  if ( segment <= 0 )
+    throw std::runtime_error("Archive segment duration must be positive.");
+
+  if ( retain_time <= 0 && retain_bytes <= 0 )
+    throw std::runtime_error("Archive requires a time or byte budget.");
+
+  uint64_t segment_len = uint64_t( segment * rate );
+  double segment_bytes = double(segment_len) * _item_size;
+
+  /* the smaller budget wins */
+  double slots = retain_time > 0 ? ceil( retain_time / segment ) : HUGE_VAL;
+  if ( retain_bytes > 0 )
+    slots = std::min( slots, floor( retain_bytes / segment_bytes ) );
+
+  if ( slots < 2 )
+    throw std::runtime_error("Archive budget must hold at least two segments.");
+
+  _archive.reset( new segment_archive( dir, fmt, rate, freq,
+                                       segment_len, uint32_t(slots) ) );
+
+  std::cerr << boost::format("Archiving to %s: %u segments of %g s (%s)")
+               % dir % uint32_t(slots) % segment % sample_format_sigmf( fmt )
+            << std::endl;
+
+  _chunk_len = std::max< size_t >( CHUNK_MIN_LEN, CHUNK_DURATION * rate );
+
+  _chunks.resize( CHUNK_NUM );
+  _chunk_lens.resize( CHUNK_NUM, 0 );
+  _chunk_starts.resize( CHUNK_NUM, 0 );
+  for ( size_t i = 0; i < CHUNK_NUM; i++ ) {
+    _chunks[i].resize( _chunk_len * _item_size );
+    _free.push_back( i );
+  }
+}
+
+archive_sink_c::~archive_sink_c()
+{
+  stop();
+}
+
+bool archive_sink_c::start()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( ! _running ) {
+    struct timeval tv;
+    gettimeofday( &tv, NULL );
+    _start_time = tv.tv_sec + tv.tv_usec / 1e6;
+    _samples = 0;
+
+    _running = true;
+    _thread = boost::thread(_writer, this);
+  }
+
+  return true;
+}
+
+bool archive_sink_c::stop()
+{
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    if ( ! _running )
+      return true;
+
+    if ( _current >= 0 ) {
+      _filled.push_back( _current );
+      _current = -1;
+    }
+
+    _running = false;
+  }
+  _cond.notify_one();
+
+  if ( _thread.joinable() )
+    _thread.join();
+
+  if ( _dropped )
+    std::cerr << "Archive dropped " << _dropped << " samples." << std::endl;
+
+  return true;
+}
+
+int archive_sink_c::work( int noutput_items,
+                          gr_vector_const_void_star &input_items,
+                          gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *)input_items[0];
+  int i = 0;
+
+  while ( i < noutput_items ) {
+    if ( _current < 0 ) {
+      boost::mutex::scoped_lock lock( _mutex );
+
+      if ( _free.empty() ) {
+        /* the writer detects the gap from the chunk offsets */
+        _dropped += noutput_items - i;
+        _samples += noutput_items - i;
+        std::cerr << "D" << std::flush;
+        break;
+      }
+
+      _current = _free.front();
+      _free.pop_front();
+      _chunk_lens[_current] = 0;
+      _chunk_starts[_current] = _samples;
+    }
+
+    size_t &len = _chunk_lens[_current];
+    size_t num = std::min( size_t(noutput_items - i), _chunk_len - len );
+
+    sample_format_pack( _fmt, in + i, &_chunks[_current][len * _item_size], num );
+    len += num;
+    i += num;
+    _samples += num;
+
+    if ( len == _chunk_len ) {
+      {
+        boost::mutex::scoped_lock lock( _mutex );
+        _filled.push_back( _current );
+      }
+      _cond.notify_one();
+      _current = -1;
+    }
+  }
+
+  return noutput_items;
+}
+
+void archive_sink_c::_writer( archive_sink_c *obj )
+{
+  obj->writer();
+}
+
+void archive_sink_c::writer()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+  uint64_t next = 0;
+
+  /* a restart continues in a new segment */
+  _archive->discontinuity();
+
+  while ( true ) {
+    while ( _filled.empty() && _running )
+      _cond.wait( lock );
+
+    if ( _filled.empty() )
+      break;
+
+    size_t idx = _filled.front();
+    _filled.pop_front();
+
+    lock.unlock();
+
+    try {
+      if ( _chunk_starts[idx] != next )
+        _archive->discontinuity();
+
+      _archive->write( &_chunks[idx][0], _chunk_lens[idx],
+                       _start_time + _chunk_starts[idx] / _rate );
+      next = _chunk_starts[idx] + _chunk_lens[idx];
+    } catch ( std::exception &ex ) {
+      std::cerr << ex.what() << std::endl;
+    }
+
+    lock.lock();
+    _free.push_back( idx );
+  }
+}
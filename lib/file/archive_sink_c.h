@@ -0,0 +1,121 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef ARCHIVE_SINK_C_H
+#define ARCHIVE_SINK_C_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <gnuradio/sync_block.h>
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include "segment_archive.h"
+
+class archive_sink_c;
+
+typedef boost::shared_ptr< archive_sink_c > archive_sink_c_sptr;
+
+/*!
+ * \param dir archive directory, created if missing
+ * \param rate sample rate of the input stream
+ * \param freq center frequency, stored with the archive
+ * \param fmt storage format of the segments
+ * \param segment duration of one segment in seconds
+ * \param retain_time seconds to keep, 0 if not limited by time
+ * \param retain_bytes bytes to keep, 0 if not limited by size
+ */
+archive_sink_c_sptr make_archive_sink_c( const std::string &dir,
+                                         double rate,
+                                         double freq,
+                                         sample_format fmt,
+                                         double segment,
+                                         double retain_time,
+                                         double retain_bytes );
+
+/*!
+ * Continuously records the input into a segment_archive. The samples are
+ * converted into preallocated chunks which are written to disk by a
+ * background thread, so a slow disk never stalls the flowgraph (chunks are
+ * dropped and counted instead).
+ */
+class archive_sink_c : public gr::sync_block
+{
+private:
+  friend archive_sink_c_sptr make_archive_sink_c( const std::string &dir,
+                                                  double rate,
+                                                  double freq,
+                                                  sample_format fmt,
+                                                  double segment,
+                                                  double retain_time,
+                                                  double retain_bytes );
+
+  archive_sink_c( const std::string &dir,
+                  double rate,
+                  double freq,
+                  sample_format fmt,
+                  double segment,
+                  double retain_time,
+                  double retain_bytes );
+
+public:
+  ~archive_sink_c();
+
+  bool start();
+  bool stop();
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+private:
+  static void _writer( archive_sink_c *obj );
+  void writer();
+
+  boost::scoped_ptr< segment_archive > _archive;
+  sample_format _fmt;
+  size_t _item_size;
+  double _rate;
+
+  std::vector< std::vector< char > > _chunks;
+  std::vector< size_t > _chunk_lens;
+  std::vector< uint64_t > _chunk_starts; /* sample offset since start */
+  std::deque< size_t > _free;
+  std::deque< size_t > _filled;
+  size_t _chunk_len; /* in samples */
+  int _current; /* chunk being filled, -1 if none */
+
+  double _start_time;
+  uint64_t _samples;
+  uint64_t _dropped;
+
+  boost::mutex _mutex;
+  boost::condition_variable _cond;
+  boost::thread _thread;
+  bool _running;
+};
+
+#endif // ARCHIVE_SINK_C_H
@@ -0,0 +1,119 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/format.hpp>
+
+#include <gnuradio/io_signature.h>
+
+#include "archive_source_c.h"
+
+archive_source_c_sptr make_archive_source_c( const std::string &dir,
+                                             double begin,
+                                             double end )
+{
+  return gnuradio::get_initial_sptr( new archive_source_c( dir, begin, end ) );
+}
+
+archive_source_c::archive_source_c( const std::string &dir,
+                                    double begin,
+                                    double end ) :
+  gr::sync_block( "archive_source_c",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(1, 1, sizeof (gr_complex)) ),
+  _pos(0)
+{
+  _archive.reset( new segment_archive( dir ) );
+
+  double first = _archive->get_begin_time();
+  double last = _archive->get_end_time();
+
+  if ( begin < 0 )
+    begin = last + begin;
+  if ( end <= 0 )
+    end = last + end;
+
+  begin = std::max( begin, first );
+  end = std::min( end, last );
+
+  if ( end <= begin )
+    throw std::runtime_error( "The requested range is not in archive " + dir + "." );
+
+  if ( ! _archive->seek( begin ) )
+    throw std::runtime_error( "Failed to seek in archive " + dir + "." );
+
+  _begin = _archive->get_time();
+  _len = uint64_t( (end - _begin) * _archive->get_sample_rate() );
+
+  std::cerr << boost::format("Playing %g s from archive %s")
+               % (end - _begin) % dir
+            << std::endl;
+}
+
+bool archive_source_c::seek( long seek_point, int whence )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  int64_t pos = seek_point;
+  if ( SEEK_CUR == whence )
+    pos += _pos;
+  else if ( SEEK_END == whence )
+    pos += _len;
+
+  if ( pos < 0 || uint64_t(pos) > _len )
+    return false;
+
+  if ( ! _archive->seek( _begin + pos / _archive->get_sample_rate() ) )
+    return false;
+
+  _pos = pos;
+
+  return true;
+}
+
+int archive_source_c::work( int noutput_items,
+                            gr_vector_const_void_star &input_items,
+                            gr_vector_void_star &output_items )
+{
+  gr_complex *out = (gr_complex *)output_items[0];
+
+  boost::mutex::scoped_lock lock( _mutex );
+
+  size_t num = std::min( uint64_t(noutput_items), _len - _pos );
+  size_t item_size = sample_format_size( _archive->get_format() );
+
+  if ( _buf.size() < num * item_size )
+    _buf.resize( num * item_size );
+
+  num = num ? _archive->read( &_buf[0], num ) : 0;
+  if ( 0 == num )
+    return WORK_DONE;
+
+  sample_format_unpack( _archive->get_format(), &_buf[0], out, num );
+  _pos += num;
+
+  return num;
+}
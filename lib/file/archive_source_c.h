@@ -0,0 +1,83 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef ARCHIVE_SOURCE_C_H
+#define ARCHIVE_SOURCE_C_H
+
+#include <string>
+#include <vector>
+
+#include <gnuradio/sync_block.h>
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "segment_archive.h"
+
+class archive_source_c;
+
+typedef boost::shared_ptr< archive_source_c > archive_source_c_sptr;
+
+/*!
+ * \param dir archive directory written by archive_sink_c
+ * \param begin wall clock time to start at, 0 for the oldest sample,
+ *        negative for seconds before the end of the archive
+ * \param end wall clock time to stop at, 0 for the end of the archive,
+ *        negative for seconds before the end of the archive
+ */
+archive_source_c_sptr make_archive_source_c( const std::string &dir,
+                                             double begin,
+                                             double end );
+
+/*!
+ * Plays back a time range of a segment_archive and finishes once the range
+ * has been produced.
+ */
+class archive_source_c : public gr::sync_block
+{
+private:
+  friend archive_source_c_sptr make_archive_source_c( const std::string &dir,
+                                                      double begin,
+                                                      double end );
+
+  archive_source_c( const std::string &dir, double begin, double end );
+
+public:
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  double get_sample_rate() const { return _archive->get_sample_rate(); }
+  double get_center_freq() const { return _archive->get_center_freq(); }
+
+  /* seek to a sample offset relative to the beginning of the range */
+  bool seek( long seek_point, int whence );
+
+private:
+  boost::scoped_ptr< segment_archive > _archive;
+  boost::mutex _mutex;
+  std::vector< char > _buf;
+  double _begin;
+  uint64_t _pos; /* samples produced since begin */
+  uint64_t _len; /* samples in the range */
+};
+
+#endif // ARCHIVE_SOURCE_C_H
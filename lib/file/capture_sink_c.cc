@@ -0,0 +1,372 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+
+#include <gnuradio/io_signature.h>
+
+#include "capture_sink_c.h"
+
+capture_sink_c_sptr make_capture_sink_c( const std::string &path,
+                                         double rate,
+                                         double pre,
+                                         double post,
+                                         sample_format fmt,
+                                         const std::string &tag,
+                                         double threshold )
+{
+  return gnuradio::get_initial_sptr(
+        new capture_sink_c( path, rate, pre, post, fmt, tag, threshold ) );
+}
+
+capture_sink_c::capture_sink_c( const std::string &path,
+                                double rate,
+                                double pre,
+                                double post,
+                                sample_format fmt,
+                                const std::string &tag,
+                                double threshold ) :
+  gr::sync_block( "capture_sink_c",
+                  gr::io_signature::make(1, 1, sizeof (gr_complex)),
+                  gr::io_signature::make(0, 0, 0) ),
+  _path(path),
+  _rate(0),
+  _pre(pre),
+  _post(post),
+  _fmt(fmt),
+  _item_size(sample_format_size(fmt)),
+  _tag(pmt::PMT_NIL),
+  _threshold(0),
+  _avg_power(0),
+  _ring_len(0), _ring_pos(0), _ring_used(0),
+  _capture_len(0), _capture_used(0), _capture_end(0),
+  _capturing(false),
+  _triggered(false),
+  _pending_len(0),
+  _skip_warned(false),
+  _running(false),
+  _count(0)
+{
+  if ( _pre < 0 || _post <= 0 )
+    throw std::runtime_error("Capture window must be positive.");
+
+  if ( ! tag.empty() )
+    _tag = pmt::intern( tag );
+
+  if ( threshold < 0 )
+    _threshold = powf( 10.0f, threshold / 10.0f );
+
+  set_sample_rate( rate );
+
+  message_port_register_in( pmt::mp("command") );
+  set_msg_handler( pmt::mp("command"),
+                   boost::bind(&capture_sink_c::handle_command, this, _1) );
+}
+
+capture_sink_c::~capture_sink_c()
+{
+  stop();
+}
+
+bool capture_sink_c::start()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( ! _running ) {
+    _running = true;
+    _thread = boost::thread(_writer, this);
+  }
+
+  return true;
+}
+
+bool capture_sink_c::stop()
+{
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    if ( ! _running )
+      return true;
+
+    /* keep what was collected so far */
+    if ( _capturing && _pending_len == 0 )
+      finish_capture();
+
+    _running = false;
+  }
+  _cond.notify_one();
+
+  if ( _thread.joinable() )
+    _thread.join();
+
+  return true;
+}
+
+void capture_sink_c::set_sample_rate( double rate )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( rate <= 0 )
+    throw std::runtime_error("Capture requires a sample rate.");
+
+  if ( rate == _rate )
+    return;
+
+  _rate = rate;
+
+  /* the windows are preallocated once, nothing is allocated while running */
+  _ring_len = size_t(_pre * _rate);
+  _capture_len = _ring_len + std::max< size_t >( 1, _post * _rate );
+
+  _ring.assign( _ring_len * _item_size, 0 );
+  _capture.assign( _capture_len * _item_size, 0 );
+
+  /* the writer grows it once done if it is busy with it now */
+  if ( 0 == _pending_len )
+    _pending.assign( _capture_len * _item_size, 0 );
+
+  _ring_pos = _ring_used = _capture_used = 0;
+  _capturing = false;
+}
+
+void capture_sink_c::trigger()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+  _triggered = true;
+}
+
+void capture_sink_c::handle_command( pmt::pmt_t msg )
+{
+  if ( pmt::is_symbol( msg ) && pmt::eqv( msg, pmt::mp("trigger") ) )
+    trigger();
+  else if ( pmt::is_dict( msg ) && pmt::dict_has_key( msg, pmt::mp("trigger") ) )
+    trigger();
+}
+
+void capture_sink_c::ring_push( const gr_complex *in, size_t num )
+{
+  if ( 0 == _ring_len )
+    return;
+
+  if ( num > _ring_len ) {
+    in += num - _ring_len;
+    num = _ring_len;
+  }
+
+  size_t first = std::min( num, _ring_len - _ring_pos );
+
+  sample_format_pack( _fmt, in, &_ring[_ring_pos * _item_size], first );
+  sample_format_pack( _fmt, in + first, &_ring[0], num - first );
+
+  _ring_pos = (_ring_pos + num) % _ring_len;
+  _ring_used = std::min( _ring_used + num, _ring_len );
+}
+
+int capture_sink_c::find_trigger( const gr_complex *in, int start, int end )
+{
+  if ( _triggered ) {
+    _triggered = false;
+    return start;
+  }
+
+  uint64_t offset = nitems_read(0);
+  int first = end;
+
+  BOOST_FOREACH( uint64_t tag_offset, _tag_offsets )
+    if ( tag_offset >= offset + start && tag_offset < offset + first )
+      first = int(tag_offset - offset);
+
+  if ( _threshold > 0 ) {
+    /* single pole average with a time constant of about 1 ms */
+    const float alpha = std::min( 1.0f, float(1e3 / _rate) );
+
+    for ( int i = start; i < first; i++ ) {
+      _avg_power += alpha * (std::norm( in[i] ) - _avg_power);
+
+      if ( _avg_power > _threshold )
+        return i;
+    }
+  }
+
+  return first;
+}
+
+void capture_sink_c::start_capture()
+{
+  /* oldest ring samples come first */
+  if ( _ring_used ) {
+    size_t head = (_ring_pos + _ring_len - _ring_used) % _ring_len;
+    size_t first = std::min( _ring_used, _ring_len - head );
+
+    memcpy( &_capture[0], &_ring[head * _item_size], first * _item_size );
+    memcpy( &_capture[first * _item_size], &_ring[0],
+            (_ring_used - first) * _item_size );
+  }
+
+  _capture_used = _ring_used;
+  _capture_end = _ring_used + std::max< size_t >( 1, _post * _rate );
+  _ring_used = _ring_pos = 0;
+  _capturing = true;
+}
+
+void capture_sink_c::finish_capture()
+{
+  _pending.swap( _capture );
+  _pending_len = _capture_used;
+
+  _capture_used = 0;
+  _capturing = false;
+  _avg_power = 0;
+
+  _cond.notify_one();
+}
+
+int capture_sink_c::work( int noutput_items,
+                          gr_vector_const_void_star &input_items,
+                          gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *)input_items[0];
+
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _tag_offsets.clear();
+
+  if ( ! pmt::is_null( _tag ) ) {
+    std::vector< gr::tag_t > tags;
+    get_tags_in_range( tags, 0, nitems_read(0), nitems_read(0) + noutput_items, _tag );
+    BOOST_FOREACH( gr::tag_t &tag, tags )
+      _tag_offsets.push_back( tag.offset );
+  }
+
+  int i = 0;
+  while ( i < noutput_items ) {
+    if ( _capturing ) {
+      size_t num = std::min( size_t(noutput_items - i), _capture_end - _capture_used );
+
+      sample_format_pack( _fmt, in + i, &_capture[_capture_used * _item_size], num );
+      _capture_used += num;
+      i += num;
+
+      if ( _capture_used == _capture_end )
+        finish_capture();
+
+      continue;
+    }
+
+    if ( _pending_len ) {
+      /* no triggers until the writer is done, the ring keeps filling */
+      bool missed = _triggered;
+      BOOST_FOREACH( uint64_t tag_offset, _tag_offsets )
+        missed |= tag_offset >= nitems_read(0) + i;
+
+      if ( missed && ! _skip_warned ) {
+        std::cerr << "Captures skipped, the previous one is still being written."
+                  << std::endl;
+        _skip_warned = true;
+      }
+
+      _triggered = false;
+      _avg_power = 0;
+
+      ring_push( in + i, noutput_items - i );
+      break;
+    }
+
+    int trig = find_trigger( in, i, noutput_items );
+
+    ring_push( in + i, trig - i );
+    i = trig;
+
+    if ( i < noutput_items )
+      start_capture();
+  }
+
+  return noutput_items;
+}
+
+std::string capture_sink_c::next_path()
+{
+  std::string base = _path, ext;
+
+  size_t dot = _path.find_last_of( '.' );
+  size_t slash = _path.find_last_of( '/' );
+  if ( dot != std::string::npos && (slash == std::string::npos || dot > slash) ) {
+    base = _path.substr( 0, dot );
+    ext = _path.substr( dot );
+  }
+
+  return str( boost::format("%s_%04u%s") % base % _count++ % ext );
+}
+
+void capture_sink_c::_writer( capture_sink_c *obj )
+{
+  obj->writer();
+}
+
+void capture_sink_c::writer()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  while ( true ) {
+    while ( 0 == _pending_len && _running )
+      _cond.wait( lock );
+
+    if ( 0 == _pending_len )
+      break;
+
+    std::string path = next_path();
+    size_t len = _pending_len;
+
+    lock.unlock();
+
+    FILE *file = fopen( path.c_str(), "wb" );
+    if ( file ) {
+      if ( fwrite( &_pending[0], _item_size, len, file ) != len )
+        std::cerr << "Failed to write capture to '" << path << "': "
+                  << strerror(errno) << std::endl;
+      fclose( file );
+
+      std::cerr << boost::format("Captured %u %s samples to %s")
+                   % len % sample_format_sigmf( _fmt ) % path
+                << std::endl;
+    } else {
+      std::cerr << "Failed to open '" << path << "' for capture: "
+                << strerror(errno) << std::endl;
+    }
+
+    lock.lock();
+    _pending_len = 0;
+    _skip_warned = false;
+
+    /* swapped in after a rate change, grown here rather than in work() */
+    if ( _pending.size() < _capture_len * _item_size )
+      _pending.resize( _capture_len * _item_size );
+  }
+}
@@ -0,0 +1,144 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef CAPTURE_SINK_C_H
+#define CAPTURE_SINK_C_H
+
+#include <string>
+#include <vector>
+
+#include <gnuradio/sync_block.h>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include "sample_format.h"
+
+class capture_sink_c;
+
+typedef boost::shared_ptr< capture_sink_c > capture_sink_c_sptr;
+
+/*!
+ * \param path base name of the capture files, captures are written to
+ *        <path>_<n>.<ext> (or <path>_<n> if there is no extension)
+ * \param rate sample rate of the input stream
+ * \param pre seconds kept before a trigger
+ * \param post seconds recorded after a trigger
+ * \param fmt storage format of the ring and the capture files
+ * \param tag stream tag key which triggers a capture, empty to disable
+ * \param threshold power threshold in dBFS, 0 or above to disable
+ */
+capture_sink_c_sptr make_capture_sink_c( const std::string &path,
+                                         double rate,
+                                         double pre,
+                                         double post,
+                                         sample_format fmt,
+                                         const std::string &tag,
+                                         double threshold );
+
+/*!
+ * Keeps the last pre seconds of the input in a preallocated ring. When
+ * triggered by a stream tag, a "trigger" command message or the input power
+ * exceeding the threshold, the ring and the following post seconds are
+ * collected into a preallocated capture buffer, which is written to disk by
+ * a background thread. Triggers during a capture are ignored.
+ */
+class capture_sink_c : public gr::sync_block
+{
+private:
+  friend capture_sink_c_sptr make_capture_sink_c( const std::string &path,
+                                                  double rate,
+                                                  double pre,
+                                                  double post,
+                                                  sample_format fmt,
+                                                  const std::string &tag,
+                                                  double threshold );
+
+  capture_sink_c( const std::string &path,
+                  double rate,
+                  double pre,
+                  double post,
+                  sample_format fmt,
+                  const std::string &tag,
+                  double threshold );
+
+public:
+  ~capture_sink_c();
+
+  bool start();
+  bool stop();
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  void set_sample_rate( double rate );
+
+  /* request a capture starting with the next sample */
+  void trigger();
+
+private:
+  void handle_command( pmt::pmt_t msg );
+
+  int find_trigger( const gr_complex *in, int start, int end );
+  void ring_push( const gr_complex *in, size_t num );
+  void start_capture();
+  void finish_capture();
+
+  static void _writer( capture_sink_c *obj );
+  void writer();
+  std::string next_path();
+
+  std::string _path;
+  double _rate;
+  double _pre, _post;
+  sample_format _fmt;
+  size_t _item_size;
+  pmt::pmt_t _tag;
+  float _threshold; /* linear power, 0 if disabled */
+  float _avg_power;
+
+  std::vector< char > _ring;
+  size_t _ring_len; /* in samples */
+  size_t _ring_pos;
+  size_t _ring_used;
+
+  std::vector< char > _capture;
+  size_t _capture_len; /* in samples */
+  size_t _capture_used;
+  size_t _capture_end; /* pre-trigger samples taken from the ring plus post */
+  bool _capturing;
+
+  std::vector< uint64_t > _tag_offsets;
+  bool _triggered;
+
+  boost::mutex _mutex;
+  boost::condition_variable _cond;
+  boost::thread _thread;
+  std::vector< char > _pending; /* handed over to the writer */
+  size_t _pending_len;
+  bool _skip_warned; /* about triggers while the writer is busy */
+  bool _running;
+  unsigned int _count;
+};
+
+#endif // CAPTURE_SINK_C_H
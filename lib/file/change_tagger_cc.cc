@@ -0,0 +1,61 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cstring>
+
+#include <boost/foreach.hpp>
+
+#include <gnuradio/io_signature.h>
+
+#include "change_tagger_cc.h"
+
+change_tagger_cc_sptr make_change_tagger_cc()
+{
+  return gnuradio::get_initial_sptr( new change_tagger_cc() );
+}
+
+change_tagger_cc::change_tagger_cc() :
+  gr::sync_block( "change_tagger_cc",
+                  gr::io_signature::make(1, 1, sizeof (gr_complex)),
+                  gr::io_signature::make(1, 1, sizeof (gr_complex)) )
+{
+}
+
+void change_tagger_cc::post( const std::string &key, double value )
+{
+  /* any position before the next sample lands on it */
+  _changes.post( key, value, 0 );
+}
+
+int change_tagger_cc::work( int noutput_items,
+                            gr_vector_const_void_star &input_items,
+                            gr_vector_void_star &output_items )
+{
+  memcpy( output_items[0], input_items[0], noutput_items * sizeof(gr_complex) );
+
+  uint64_t pos = nitems_written( 0 );
+
+  BOOST_FOREACH( const gr::tag_t &change, _changes.take( pos, noutput_items, pos ) )
+    add_item_tag( 0, change );
+
+  return noutput_items;
+}
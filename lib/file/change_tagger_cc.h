@@ -0,0 +1,59 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef CHANGE_TAGGER_CC_H
+#define CHANGE_TAGGER_CC_H
+
+#include <string>
+
+#include <gnuradio/sync_block.h>
+
+#include "channel_config.h"
+
+class change_tagger_cc;
+
+typedef boost::shared_ptr< change_tagger_cc > change_tagger_cc_sptr;
+
+change_tagger_cc_sptr make_change_tagger_cc();
+
+/*!
+ * Passes samples through and tags the first one produced after a setting
+ * change, for sources without a work function of their own.
+ */
+class change_tagger_cc : public gr::sync_block
+{
+private:
+  friend change_tagger_cc_sptr make_change_tagger_cc();
+
+  change_tagger_cc();
+
+public:
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  void post( const std::string &key, double value );
+
+private:
+  change_tags _changes;
+};
+
+#endif // CHANGE_TAGGER_CC_H
@@ -28,6 +28,7 @@
 #include <gnuradio/io_signature.h>
 
 #include "file_sink_c.h"
+#include "driver_registry.h"
 
 #include "arg_helpers.h"
 
@@ -66,6 +67,43 @@ file_sink_c::file_sink_c(const std::string &args) :
   if (dict.count("append"))
     append = ("true" == dict["append"] ? true : false);
 
+  /* capture mode, only the samples around a trigger are written */
+  bool capture = dict.count("pre") || dict.count("post");
+  double pre = 0, post = 0, threshold = 0;
+  std::string trigger_tag = "trigger";
+  sample_format format = SAMPLE_FORMAT_CF32;
+
+  if (dict.count("pre"))
+    pre = boost::lexical_cast< double >( dict["pre"] );
+
+  if (dict.count("post"))
+    post = boost::lexical_cast< double >( dict["post"] );
+
+  if (dict.count("tag"))
+    trigger_tag = dict["tag"];
+
+  if (dict.count("threshold"))
+    threshold = boost::lexical_cast< double >( dict["threshold"] );
+
+  /* archive mode, a rolling recording into segments of the given directory */
+  bool archive = dict.count("archive");
+  double segment = 60, retain = 0, retain_bytes = 0;
+
+  if (dict.count("segment"))
+    segment = boost::lexical_cast< double >( dict["segment"] );
+
+  if (dict.count("retain"))
+    retain = boost::lexical_cast< double >( dict["retain"] );
+
+  if (dict.count("retain_bytes"))
+    retain_bytes = boost::lexical_cast< double >( dict["retain_bytes"] );
+
+  if (archive)
+    format = SAMPLE_FORMAT_SC16; /* compact by default */
+
+  if (dict.count("format"))
+    format = parse_sample_format( dict["format"] );
+
   if (!filename.length())
     throw std::runtime_error("No file name specified.");
 
@@ -75,19 +113,44 @@ file_sink_c::file_sink_c(const std::string &args) :
   if (0 == _rate && throttle)
     throw std::runtime_error("Parameter 'rate' is missing in arguments.");
 
+  if (0 == _rate && capture)
+    throw std::runtime_error("Parameter 'rate' is required for capture.");
+
+  if (0 == _rate && archive)
+    throw std::runtime_error("Parameter 'rate' is required for archive.");
+
+  if (capture && archive)
+    throw std::runtime_error("Capture and archive modes are exclusive.");
+
   _file_rate = _rate;
 
-  _sink = gr::blocks::file_sink::make( sizeof(gr_complex),
-                                           filename.c_str(),
-                                           append);
+  gr::basic_block_sptr sink;
+
+  if (capture) {
+    _capture = make_capture_sink_c( filename, _rate, pre, post, format,
+                                    trigger_tag, threshold );
+    sink = _capture;
+
+    message_port_register_hier_in( pmt::mp("command") );
+    msg_connect( self(), pmt::mp("command"), _capture, pmt::mp("command") );
+  } else if (archive) {
+    _archive = make_archive_sink_c( filename, _rate, _freq, format,
+                                    segment, retain, retain_bytes );
+    sink = _archive;
+  } else {
+    _sink = gr::blocks::file_sink::make( sizeof(gr_complex),
+                                             filename.c_str(),
+                                             append);
+    sink = _sink;
+  }
 
   _throttle = gr::blocks::throttle::make( sizeof(gr_complex), _file_rate );
 
   if (throttle) {
     connect( self(), 0, _throttle, 0 );
-    connect( _throttle, 0, _sink, 0 );
+    connect( _throttle, 0, sink, 0 );
   } else {
-    connect( self(), 0, _sink, 0 );
+    connect( self(), 0, sink, 0 );
   }
 }
 
@@ -140,6 +203,9 @@ double file_sink_c::set_sample_rate( double rate )
 
   _throttle->set_sample_rate( rate );
 
+  if (_capture)
+    _capture->set_sample_rate( rate );
+
   _rate = rate;
 
   return get_sample_rate();
@@ -224,3 +290,11 @@ std::string file_sink_c::get_antenna( size_t chan )
 {
   return "";
 }
+
+bool file_sink_c::has_command_port( void )
+{
+  return _capture.get() != NULL;
+}
+
+OSMOSDR_REGISTER_SINK( file, "file", PROBE_SOFTWARE,
+                         make_file_sink_c, file_sink_c::get_devices( fake ) );
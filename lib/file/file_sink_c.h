@@ -25,6 +25,8 @@
 #include <gnuradio/blocks/throttle.h>
 
 #include "sink_iface.h"
+#include "capture_sink_c.h"
+#include "archive_sink_c.h"
 
 class file_sink_c;
 
@@ -72,8 +74,13 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  /* true if the sink accepts trigger commands (capture mode) */
+  bool has_command_port( void );
+
 private:
   gr::blocks::file_sink::sptr _sink;
+  capture_sink_c_sptr _capture;
+  archive_sink_c_sptr _archive;
   gr::blocks::throttle::sptr _throttle;
   double _file_rate;
   double _freq, _rate;
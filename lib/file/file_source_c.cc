@@ -28,6 +28,7 @@
 #include <gnuradio/io_signature.h>
 
 #include "file_source_c.h"
+#include "driver_registry.h"
 
 #include "arg_helpers.h"
 
@@ -69,6 +70,25 @@ file_source_c::file_source_c(const std::string &args) :
   if (!filename.length())
     throw std::runtime_error("No file name specified.");
 
+  /* archive mode, play back a time range of a rolling recording */
+  if (dict.count("archive")) {
+    double begin = 0, end = 0;
+
+    if (dict.count("begin"))
+      begin = boost::lexical_cast< double >( dict["begin"] );
+
+    if (dict.count("end"))
+      end = boost::lexical_cast< double >( dict["end"] );
+
+    _archive = make_archive_source_c( filename, begin, end );
+
+    if (0 == _rate)
+      _rate = _archive->get_sample_rate();
+
+    if (0 == _freq)
+      _freq = _archive->get_center_freq();
+  }
+
   if (_freq < 0)
     throw std::runtime_error("Parameter 'freq' may not be negative.");
 
@@ -77,18 +97,35 @@ file_source_c::file_source_c(const std::string &args) :
 
   _file_rate = _rate;
 
-  _source = gr::blocks::file_source::make( sizeof(gr_complex),
-                                           filename.c_str(),
-                                           repeat );
+  gr::basic_block_sptr source;
+
+  if (_archive) {
+    source = _archive;
+  } else {
+    _source = gr::blocks::file_source::make( sizeof(gr_complex),
+                                             filename.c_str(),
+                                             repeat );
+    source = _source;
+  }
 
   _throttle = gr::blocks::throttle::make( sizeof(gr_complex), _file_rate );
+  _tagger = make_change_tagger_cc();
 
   if (throttle) {
-    connect( _source, 0, _throttle, 0 );
-    connect( _throttle, 0, self(), 0 );
+    connect( source, 0, _throttle, 0 );
+    connect( _throttle, 0, _tagger, 0 );
   } else {
-    connect( _source, 0, self(), 0 );
+    connect( source, 0, _tagger, 0 );
   }
+
+  connect( _tagger, 0, self(), 0 );
+
+  /* what the file was recorded with, on its first sample */
+  if (_rate > 0)
+    _tagger->post( "rx_rate", _rate );
+
+  if (_freq > 0)
+    _tagger->post( "rx_freq", _freq );
 }
 
 file_source_c::~file_source_c()
@@ -122,6 +159,9 @@ size_t file_source_c::get_num_channels( void )
 
 bool file_source_c::seek( long seek_point, int whence , size_t chan )
 {
+    if (_archive)
+      return _archive->seek( seek_point, whence );
+
     return _source->seek( seek_point, whence );
 }
 
@@ -145,6 +185,9 @@ double file_source_c::set_sample_rate( double rate )
 
   _throttle->set_sample_rate( rate );
 
+  if ( rate != _rate )
+    _tagger->post( "rx_rate", rate );
+
   _rate = rate;
 
   return get_sample_rate();
@@ -229,3 +272,6 @@ std::string file_source_c::get_antenna( size_t chan )
 {
   return "";
 }
+
+OSMOSDR_REGISTER_SOURCE( file, "file", PROBE_SOFTWARE,
+                         make_file_source_c, file_source_c::get_devices( fake ) );
@@ -25,6 +25,8 @@
 #include <gnuradio/blocks/throttle.h>
 
 #include "source_iface.h"
+#include "archive_source_c.h"
+#include "change_tagger_cc.h"
 
 class file_source_c;
 
@@ -59,6 +61,7 @@ public:
   osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
   double set_center_freq( double freq, size_t chan = 0 );
   double get_center_freq( size_t chan = 0 );
+  bool tags_changes() { return true; }
   double set_freq_corr( double ppm, size_t chan = 0 );
   double get_freq_corr( size_t chan = 0 );
 
@@ -76,7 +79,9 @@ public:
 
 private:
   gr::blocks::file_source::sptr _source;
+  archive_source_c_sptr _archive;
   gr::blocks::throttle::sptr _throttle;
+  change_tagger_cc_sptr _tagger;
   double _file_rate;
   double _freq, _rate;
 };
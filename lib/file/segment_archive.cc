@@ -0,0 +1,385 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <boost/format.hpp>
+
+#include "segment_archive.h"
+
+#define INDEX_MAGIC "OSMOSEG1"
+
+static void throw_errno( const std::string &msg )
+{
+  throw std::runtime_error( msg + ": " + strerror(errno) );
+}
+
+segment_archive::segment_archive( const std::string &dir ) :
+  _dir(dir),
+  _writable(false),
+  _index_fd(-1),
+  _seg_fd(-1),
+  _read_fd(-1),
+  _read_seq(0),
+  _read_pos(0),
+  _read_slot(0)
+{
+  open_index( false );
+
+  _fmt = sample_format(_hdr.format);
+  _item_size = sample_format_size( _fmt );
+}
+
+segment_archive::segment_archive( const std::string &dir,
+                                  sample_format fmt,
+                                  double rate,
+                                  double freq,
+                                  uint64_t segment_len,
+                                  uint32_t slots ) :
+  _dir(dir),
+  _fmt(fmt),
+  _item_size(sample_format_size(fmt)),
+  _writable(true),
+  _index_fd(-1),
+  _seg_fd(-1),
+  _read_fd(-1),
+  _read_seq(0),
+  _read_pos(0),
+  _read_slot(0)
+{
+  if ( 0 == segment_len || 0 == slots )
+    throw std::runtime_error("Invalid archive segment configuration.");
+
+  if ( mkdir( _dir.c_str(), 0755 ) < 0 && errno != EEXIST )
+    throw_errno( "Failed to create archive directory '" + _dir + "'" );
+
+  open_index( true );
+
+  if ( _hdr.format != uint32_t(fmt) || _hdr.slots != slots ||
+       _hdr.segment_len != segment_len || _hdr.rate != rate ) {
+    if ( _hdr.newest )
+      std::cerr << "Archive parameters changed, discarding old segments in "
+                << _dir << std::endl;
+
+    memset( &_hdr, 0, sizeof(_hdr) );
+    memcpy( _hdr.magic, INDEX_MAGIC, sizeof(_hdr.magic) );
+    _hdr.format = fmt;
+    _hdr.slots = slots;
+    _hdr.segment_len = segment_len;
+    _hdr.rate = rate;
+
+    entry e;
+    memset( &e, 0, sizeof(e) );
+    if ( ftruncate( _index_fd, sizeof(header) ) < 0 )
+      throw_errno( "Failed to reset archive index" );
+    for ( uint32_t i = 0; i < slots; i++ ) {
+      e.seq = i;
+      write_entry( e );
+    }
+  }
+
+  _hdr.freq = freq;
+  write_header();
+
+  memset( &_cur, 0, sizeof(_cur) );
+}
+
+segment_archive::~segment_archive()
+{
+  close_segment();
+
+  if ( _read_fd >= 0 )
+    close( _read_fd );
+
+  if ( _index_fd >= 0 )
+    close( _index_fd );
+}
+
+void segment_archive::open_index( bool create )
+{
+  std::string path = _dir + "/index";
+
+  _index_fd = open( path.c_str(), create ? (O_RDWR | O_CREAT) : O_RDONLY, 0644 );
+  if ( _index_fd < 0 )
+    throw_errno( "Failed to open archive index '" + path + "'" );
+
+  memset( &_hdr, 0, sizeof(_hdr) );
+
+  ssize_t len = pread( _index_fd, &_hdr, sizeof(_hdr), 0 );
+  if ( len == sizeof(_hdr) && 0 == memcmp( _hdr.magic, INDEX_MAGIC, sizeof(_hdr.magic) ) )
+    return;
+
+  if ( ! create )
+    throw std::runtime_error( "'" + _dir + "' does not contain a valid archive." );
+
+  memset( &_hdr, 0, sizeof(_hdr) );
+}
+
+void segment_archive::reload_header()
+{
+  /* pick up segments added by a concurrent writer */
+  if ( ! _writable ) {
+    header hdr;
+    if ( pread( _index_fd, &hdr, sizeof(hdr), 0 ) == sizeof(hdr) )
+      _hdr = hdr;
+  }
+}
+
+void segment_archive::write_header()
+{
+  if ( pwrite( _index_fd, &_hdr, sizeof(_hdr), 0 ) != sizeof(_hdr) )
+    throw_errno( "Failed to write archive index" );
+}
+
+bool segment_archive::read_entry( uint64_t seq, entry &e )
+{
+  off_t offset = sizeof(header) + (seq % _hdr.slots) * sizeof(entry);
+
+  if ( pread( _index_fd, &e, sizeof(e), offset ) != sizeof(e) )
+    return false;
+
+  return e.seq == seq && e.samples > 0;
+}
+
+void segment_archive::write_entry( const entry &e )
+{
+  off_t offset = sizeof(header) + (e.seq % _hdr.slots) * sizeof(entry);
+
+  if ( pwrite( _index_fd, &e, sizeof(e), offset ) != sizeof(e) )
+    throw_errno( "Failed to write archive index" );
+}
+
+int segment_archive::open_slot( uint32_t slot, bool create )
+{
+  std::string path = str( boost::format("%s/segment_%05u.%s")
+                          % _dir % slot % sample_format_sigmf( _fmt ) );
+
+  int fd = open( path.c_str(), create ? (O_RDWR | O_CREAT) : O_RDONLY, 0644 );
+  if ( fd < 0 ) {
+    if ( create )
+      throw_errno( "Failed to open archive segment '" + path + "'" );
+    return -1;
+  }
+
+  if ( create ) {
+    off_t size = _hdr.segment_len * _item_size;
+    struct stat st;
+
+    /* reserve the whole segment up front to keep the files contiguous */
+    if ( fstat( fd, &st ) == 0 && st.st_size < size ) {
+#ifdef __linux__
+      int ret = posix_fallocate( fd, 0, size );
+      if ( ret != 0 )
+        std::cerr << "Failed to preallocate " << path << ": "
+                  << strerror(ret) << std::endl;
+#else
+      if ( ftruncate( fd, size ) < 0 )
+        std::cerr << "Failed to preallocate " << path << ": "
+                  << strerror(errno) << std::endl;
+#endif
+    }
+  }
+
+  return fd;
+}
+
+void segment_archive::close_segment()
+{
+  if ( _seg_fd >= 0 ) {
+    close( _seg_fd );
+    _seg_fd = -1;
+  }
+}
+
+void segment_archive::discontinuity()
+{
+  close_segment();
+}
+
+void segment_archive::write( const void *data, size_t num, double time )
+{
+  const char *p = (const char *)data;
+
+  while ( num ) {
+    if ( _seg_fd < 0 || _cur.samples == _hdr.segment_len ) {
+      close_segment();
+
+      _cur.seq = _hdr.newest++;
+      _cur.samples = 0;
+      _cur.time = time;
+
+      /* invalidate the recycled slot before overwriting its data */
+      write_entry( _cur );
+      write_header();
+
+      _seg_fd = open_slot( _cur.seq % _hdr.slots, true );
+    }
+
+    size_t len = std::min( uint64_t(num), _hdr.segment_len - _cur.samples );
+
+    if ( pwrite( _seg_fd, p, len * _item_size, _cur.samples * _item_size )
+         != ssize_t(len * _item_size) )
+      throw_errno( "Failed to write archive segment" );
+
+    _cur.samples += len;
+    write_entry( _cur );
+
+    p += len * _item_size;
+    num -= len;
+    time += len / _hdr.rate;
+  }
+}
+
+double segment_archive::get_begin_time()
+{
+  reload_header();
+
+  uint64_t first = _hdr.newest > _hdr.slots ? _hdr.newest - _hdr.slots : 0;
+  entry e;
+
+  for ( uint64_t seq = first; seq < _hdr.newest; seq++ )
+    if ( read_entry( seq, e ) )
+      return e.time;
+
+  return 0;
+}
+
+double segment_archive::get_end_time()
+{
+  reload_header();
+
+  entry e;
+
+  if ( _hdr.newest && read_entry( _hdr.newest - 1, e ) )
+    return e.time + e.samples / _hdr.rate;
+
+  return 0;
+}
+
+bool segment_archive::seek( double time )
+{
+  reload_header();
+
+  if ( 0 == _hdr.newest )
+    return false;
+
+  uint64_t first = _hdr.newest > _hdr.slots ? _hdr.newest - _hdr.slots : 0;
+  uint64_t last = _hdr.newest - 1;
+  double duration = _hdr.segment_len / _hdr.rate;
+  entry e;
+
+  if ( ! read_entry( last, e ) )
+    return false;
+
+  /* estimate from the newest segment, exact unless there are gaps */
+  uint64_t seq = last;
+  if ( time < e.time ) {
+    uint64_t back = uint64_t( ceil( (e.time - time) / duration ) );
+    seq = back > last - first ? first : last - back;
+  }
+
+  /* step over gaps between runs */
+  while ( seq > first && (! read_entry( seq, e ) || time < e.time) )
+    seq--;
+  while ( seq < last && (! read_entry( seq, e ) ||
+                         time >= e.time + e.samples / _hdr.rate) )
+    seq++;
+
+  if ( ! read_entry( seq, e ) )
+    return false;
+
+  double offset = std::max( 0.0, (time - e.time) * _hdr.rate );
+
+  _read_seq = seq;
+  _read_pos = std::min( uint64_t(offset + 0.5), e.samples );
+
+  if ( _read_fd >= 0 )
+    close( _read_fd );
+  _read_slot = seq % _hdr.slots;
+  _read_fd = open_slot( _read_slot, false );
+
+  return _read_fd >= 0;
+}
+
+size_t segment_archive::read( void *data, size_t num )
+{
+  char *p = (char *)data;
+  size_t done = 0;
+  entry e;
+
+  while ( done < num && _read_fd >= 0 ) {
+    if ( ! read_entry( _read_seq, e ) )
+      break; /* recycled by the writer meanwhile */
+
+    if ( _read_pos >= e.samples ) {
+      reload_header();
+
+      if ( _read_seq + 1 >= _hdr.newest )
+        break; /* caught up with the writer */
+
+      _read_seq++;
+      _read_pos = 0;
+
+      close( _read_fd );
+      _read_slot = _read_seq % _hdr.slots;
+      _read_fd = open_slot( _read_slot, false );
+      continue;
+    }
+
+    size_t len = std::min( uint64_t(num - done), e.samples - _read_pos );
+    ssize_t ret = pread( _read_fd, p, len * _item_size, _read_pos * _item_size );
+    if ( ret <= 0 )
+      break;
+
+    /* the writer invalidates a slot before recycling it, so if the entry
+     * is still the same the data read belongs to it */
+    if ( ! read_entry( _read_seq, e ) )
+      break;
+
+    len = ret / _item_size;
+    _read_pos += len;
+    done += len;
+    p += len * _item_size;
+  }
+
+  return done;
+}
+
+double segment_archive::get_time()
+{
+  entry e;
+
+  if ( read_entry( _read_seq, e ) )
+    return e.time + _read_pos / _hdr.rate;
+
+  return 0;
+}
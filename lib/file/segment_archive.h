@@ -0,0 +1,149 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef SEGMENT_ARCHIVE_H
+#define SEGMENT_ARCHIVE_H
+
+#include <string>
+
+#include <stdint.h>
+
+#include "sample_format.h"
+
+/*!
+ * A directory of fixed size segment files used as a ring, plus an index.
+ *
+ * Segments are numbered by a sequence number which keeps increasing over
+ * restarts; segment n lives in slot n % slots. Slot files are preallocated
+ * once and then overwritten in place, so the oldest data is recycled when
+ * the ring wraps. The index holds one entry per slot with the sequence
+ * number, the wall clock time of the first sample and the number of valid
+ * samples, and is updated after every write so a concurrent reader (or a
+ * restart after a crash) always sees consistent data.
+ *
+ * Since all segments but the last one of a run are full, the segment
+ * holding a given time is found directly from the newest segment, and
+ * only gaps between runs require stepping to a neighbour.
+ */
+class segment_archive
+{
+public:
+  /*!
+   * Open an existing archive for reading.
+   */
+  segment_archive( const std::string &dir );
+
+  /*!
+   * Open or create an archive for writing. An existing archive with
+   * different parameters is reinitialized.
+   */
+  segment_archive( const std::string &dir,
+                   sample_format fmt,
+                   double rate,
+                   double freq,
+                   uint64_t segment_len,
+                   uint32_t slots );
+
+  ~segment_archive();
+
+  sample_format get_format() const { return _fmt; }
+  double get_sample_rate() const { return _hdr.rate; }
+  double get_center_freq() const { return _hdr.freq; }
+
+  /* writer side */
+
+  /*!
+   * Append num samples in storage format. time is the wall clock time
+   * of the first sample, it is only used when a new segment is started.
+   */
+  void write( const void *data, size_t num, double time );
+
+  /* start a new segment with the next write, e.g. after a restart */
+  void discontinuity();
+
+  /* reader side */
+
+  double get_begin_time();
+  double get_end_time();
+
+  /*!
+   * Position the read cursor at the given time, clamped to the recorded
+   * range. Returns false if the archive is empty.
+   */
+  bool seek( double time );
+
+  /*!
+   * Read up to num samples in storage format from the cursor. Returns the
+   * number of samples read, 0 once all recorded data has been consumed.
+   */
+  size_t read( void *data, size_t num );
+
+  /* time of the sample at the read cursor */
+  double get_time();
+
+  struct header
+  {
+    char magic[8];
+    uint32_t format;
+    uint32_t slots;
+    uint64_t segment_len;
+    double rate;
+    double freq;
+    uint64_t newest; /* sequence number of the newest segment + 1, 0 if empty */
+  };
+
+  struct entry
+  {
+    uint64_t seq;
+    uint64_t samples; /* 0 if the slot holds no valid data */
+    double time;
+    uint64_t reserved;
+  };
+
+private:
+  void open_index( bool create );
+  void reload_header();
+  void write_header();
+  bool read_entry( uint64_t seq, entry &e );
+  void write_entry( const entry &e );
+  int open_slot( uint32_t slot, bool create );
+  void close_segment();
+
+  std::string _dir;
+  sample_format _fmt;
+  size_t _item_size;
+  bool _writable;
+
+  int _index_fd;
+  header _hdr;
+
+  /* writer state */
+  int _seg_fd;
+  entry _cur;
+
+  /* reader state */
+  int _read_fd;
+  uint64_t _read_seq;
+  uint64_t _read_pos;
+  uint32_t _read_slot;
+};
+
+#endif // SEGMENT_ARCHIVE_H
@@ -1,4 +1,5 @@
 #include "freesrp_sink_c.h"
+#include "driver_registry.h"
 
 using namespace FreeSRP;
 using namespace std;
@@ -278,3 +279,6 @@ double freesrp_sink_c::get_bandwidth(size_t chan)
         return r.param;
     }
 }
+
+OSMOSDR_REGISTER_SINK( freesrp, "freesrp", PROBE_USB,
+                         make_freesrp_sink_c, freesrp_sink_c::get_devices() );
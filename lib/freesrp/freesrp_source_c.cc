@@ -1,4 +1,5 @@
 #include "freesrp_source_c.h"
+#include "driver_registry.h"
 
 using namespace FreeSRP;
 using namespace std;
@@ -339,3 +340,6 @@ double freesrp_source_c::get_bandwidth(size_t chan)
         return static_cast<double>(r.param);
     }
 }
+
+OSMOSDR_REGISTER_SOURCE( freesrp, "freesrp", PROBE_USB,
+                         make_freesrp_source_c, freesrp_source_c::get_devices() );
@@ -45,6 +45,7 @@
 #include <gnuradio/io_signature.h>
 
 #include "hackrf_sink_c.h"
+#include "driver_registry.h"
 
 #include "arg_helpers.h"
 
@@ -827,3 +828,6 @@ osmosdr::freq_range_t hackrf_sink_c::get_bandwidth_range( size_t chan )
 
   return bandwidths;
 }
+
+OSMOSDR_REGISTER_SINK( hackrf, "hackrf", PROBE_USB,
+                         make_hackrf_sink_c, hackrf_sink_c::get_devices() );
@@ -27,18 +27,24 @@
 #include "config.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <iostream>
 
 #include <boost/assign.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <boost/predef/other/endian.h>
 #include <boost/algorithm/string.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/thread/thread.hpp>
 
 #include <gnuradio/io_signature.h>
 
 #include "hackrf_source_c.h"
+#include "driver_registry.h"
 
 #include "arg_helpers.h"
 
@@ -91,6 +97,9 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
   : gr::sync_block ("hackrf_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
+    _soft_agc(false),
+    _stats(false),
+    _exec(boost::make_shared<device_executor>()),
     _dev(NULL),
     _buf(NULL),
     _sample_rate(0),
@@ -100,20 +109,33 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
     _amp_gain(0),
     _lna_gain(0),
     _vga_gain(0),
-    _bandwidth(0)
+    _bandwidth(0),
+    _record_only(false)
 {
   int ret;
-  std::string hackrf_serial;
 
   dict_t dict = params_to_dict(args);
 
+  _timer.init( dict, "hackrf" );
+  _defaults.init( dict );
+
   _buf_num = _buf_len = _buf_head = _buf_used = _buf_offset = 0;
+  _samp_in = 0;
 
   _biasT = false;
 
   if (dict.count("buffers"))
     _buf_num = boost::lexical_cast< unsigned int >( dict["buffers"] );
 
+  if (dict.count("decim"))
+    _decim.set_decimation( parse_decimation( dict["decim"] ) );
+
+  if (dict.count("soft_agc"))
+    _soft_agc = boost::lexical_cast<bool>( dict["soft_agc"] );
+
+  if (dict.count("stats"))
+    _stats = boost::lexical_cast<bool>( dict["stats"] );
+
 //  if (dict.count("buflen"))
 //    _buf_len = boost::lexical_cast< unsigned int >( dict["buflen"] );
 
@@ -136,47 +158,22 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
 #endif
   }
 
-  {
-    boost::mutex::scoped_lock lock( _usage_mutex );
+  /* the bytes of I and Q are signed, in this order in memory */
+  for (unsigned int i = 0; i < 0x100; i++) {
+    _lut16.push_back( int16_t( int8_t(i) ) * (halfband_decim::FULL_SCALE / 128) );
+    _lut8.push_back( float( int8_t(i) ) * (1.0f/128.0f) );
+  }
 
-    if ( _usage == 0 )
-      hackrf_init(); /* call only once before the first open */
+  _pool_key = "hackrf:" + (dict.count("hackrf") ? dict["hackrf"] : "");
+  _linger = pool_linger( dict );
 
-    _usage++;
+  _dev = (hackrf_device *)device_pool::instance().claim( _pool_key, _settings );
+  if ( ! _dev ) {
+    _dev = open_device( dict );
+    _settings.reset( new device_settings );
   }
 
-  _dev = NULL;
-  
-#ifdef LIBHACKRF_HAVE_DEVICE_LIST
-  if (dict.count("hackrf") && dict["hackrf"].length() > 0) {
-    hackrf_serial = dict["hackrf"];
-    
-    if (hackrf_serial.length() > 1) {
-      ret = hackrf_open_by_serial( hackrf_serial.c_str(), &_dev );
-    } else {
-        int dev_index = 0;
-        try {
-          dev_index = boost::lexical_cast< int >( hackrf_serial );
-        } catch ( std::exception &ex ) {
-          throw std::runtime_error(
-                "Failed to use '" + hackrf_serial + "' as HackRF device index number: " + ex.what());
-        }
-
-        hackrf_device_list_t *list = hackrf_device_list();
-        if (dev_index < list->devicecount) {
-          ret = hackrf_device_list_open(list, dev_index, &_dev);
-        } else {
-          hackrf_device_list_free(list);
-          throw std::runtime_error(
-                "Failed to use '" + hackrf_serial + "' as HackRF device index: not enough devices");
-        }
-        hackrf_device_list_free(list);
-    }
-  } else
-#endif
-    ret = hackrf_open( &_dev );
-    
-  HACKRF_THROW_ON_ERROR(ret, "Failed to open HackRF device")
+  _timer.phase( "open" );
 
   uint8_t board_id;
   ret = hackrf_board_id_read( _dev, &board_id );
@@ -201,15 +198,22 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
               << std::endl;
   }
 
-  set_center_freq( (get_freq_range().start() + get_freq_range().stop()) / 2.0 );
-  set_sample_rate( get_sample_rates().start() );
-  set_bandwidth( 0 );
+  /* what the deferred defaults will apply, should setters refer to it */
+  if ( _defaults.deferred() ) {
+    _center_freq = (get_freq_range().start() + get_freq_range().stop()) / 2.0;
+    _sample_rate = get_sample_rates().start() * _decim.get_decimation();
+  }
 
-  set_gain( 0 ); /* disable AMP gain stage by default to protect full sprectrum pre-amp from physical damage */
+  _defaults.add( "freq", [this]() {
+    set_center_freq( (get_freq_range().start() + get_freq_range().stop()) / 2.0 ); } );
+  _defaults.add( "rate", [this]() { set_sample_rate( get_sample_rates().start() ); } );
+  _defaults.add( "bandwidth", [this]() { set_bandwidth( 0 ); } );
 
-  set_if_gain( 16 ); /* preset to a reasonable default (non-GRC use case) */
+  set_gain( 0 ); /* disable AMP gain stage by default to protect full sprectrum pre-amp from physical damage */
 
-  set_bb_gain( 20 ); /* preset to a reasonable default (non-GRC use case) */
+  /* preset to a reasonable default (non-GRC use case) */
+  _defaults.add( "if_gain", [this]() { set_if_gain( 16 ); } );
+  _defaults.add( "bb_gain", [this]() { set_bb_gain( 20 ); } );
 
   // Check device args to find out if bias/phantom power is desired.
   if ( dict.count("bias") ) {
@@ -225,6 +229,18 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
     }
   }
 
+  if (dict.count("record_only"))
+    _record_only = boost::lexical_cast<bool>( dict["record_only"] );
+
+  if (dict.count("record")) {
+    _recorder.reset( new raw_recorder( dict["record"], "ci8", BYTES_PER_SAMPLE,
+                                       "HackRF" ) );
+    _recorder->set_sample_rate( _sample_rate );
+    _recorder->set_center_freq( get_center_freq() );
+  } else if (_record_only) {
+    throw std::runtime_error("Parameter 'record_only' requires 'record'.");
+  }
+
   _buf = (unsigned short **) malloc(_buf_num * sizeof(unsigned short *));
 
   if (_buf) {
@@ -234,15 +250,87 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
 
 //  _thread = gr::thread::thread(_hackrf_wait, this);
 
+  _timer.phase( "configure" );
+
   ret = hackrf_start_rx( _dev, _hackrf_rx_callback, (void *)this );
   HACKRF_THROW_ON_ERROR(ret, "Failed to start RX streaming")
 }
 
+hackrf_device *hackrf_source_c::open_device( dict_t &dict )
+{
+  {
+    boost::mutex::scoped_lock lock( _usage_mutex );
+
+    if ( _usage == 0 )
+      hackrf_init(); /* call only once before the first open */
+
+    _usage++;
+  }
+
+  hackrf_device *dev = NULL;
+  int ret;
+  std::string hackrf_serial;
+
+#ifdef LIBHACKRF_HAVE_DEVICE_LIST
+  if (dict.count("hackrf") && dict["hackrf"].length() > 0) {
+    hackrf_serial = dict["hackrf"];
+    
+    if (hackrf_serial.length() > 1) {
+      ret = hackrf_open_by_serial( hackrf_serial.c_str(), &dev );
+    } else {
+        int dev_index = 0;
+        try {
+          dev_index = boost::lexical_cast< int >( hackrf_serial );
+        } catch ( std::exception &ex ) {
+          throw std::runtime_error(
+                "Failed to use '" + hackrf_serial + "' as HackRF device index number: " + ex.what());
+        }
+
+        hackrf_device_list_t *list = hackrf_device_list();
+        if (dev_index < list->devicecount) {
+          ret = hackrf_device_list_open(list, dev_index, &dev);
+        } else {
+          hackrf_device_list_free(list);
+          throw std::runtime_error(
+                "Failed to use '" + hackrf_serial + "' as HackRF device index: not enough devices");
+        }
+        hackrf_device_list_free(list);
+    }
+  } else
+#endif
+    ret = hackrf_open( &dev );
+    
+  HACKRF_THROW_ON_ERROR(ret, "Failed to open HackRF device")
+
+  return dev;
+}
+
+void hackrf_source_c::close_device( void *dev )
+{
+  int ret = hackrf_close( (hackrf_device *)dev );
+  if ( ret != HACKRF_SUCCESS )
+  {
+    std::cerr << HACKRF_FORMAT_ERROR(ret, "Failed to close HackRF") << std::endl;
+  }
+
+  {
+    boost::mutex::scoped_lock lock( _usage_mutex );
+
+     _usage--;
+
+    if ( _usage == 0 )
+      hackrf_exit(); /* call only once after last close */
+  }
+}
+
 /*
  * Our virtual destructor.
  */
 hackrf_source_c::~hackrf_source_c ()
 {
+  /* gain steps still queued use the device */
+  boost::atomic_load( &_exec )->call( [](){} );
+
   if (_dev) {
 //    _thread.join();
     int ret = hackrf_stop_rx( _dev );
@@ -250,21 +338,9 @@ hackrf_source_c::~hackrf_source_c ()
     {
       std::cerr << HACKRF_FORMAT_ERROR(ret, "Failed to stop RX streaming") << std::endl;
     }
-    ret = hackrf_close( _dev );
-    if ( ret != HACKRF_SUCCESS )
-    {
-      std::cerr << HACKRF_FORMAT_ERROR(ret, "Failed to close HackRF") << std::endl;
-    }
+    device_pool::instance().release( _pool_key, _dev, close_device,
+                                     _settings, _linger );
     _dev = NULL;
-
-    {
-      boost::mutex::scoped_lock lock( _usage_mutex );
-
-       _usage--;
-
-      if ( _usage == 0 )
-        hackrf_exit(); /* call only once after last close */
-    }
   }
 
   if (_buf) {
@@ -285,11 +361,21 @@ int hackrf_source_c::_hackrf_rx_callback(hackrf_transfer *transfer)
 
 int hackrf_source_c::hackrf_rx_callback(unsigned char *buf, uint32_t len)
 {
+  _timer.first_sample();
+
+  if (_recorder) {
+    _recorder->push(buf, len);
+
+    if (_record_only) /* work() stays idle, no conversion takes place */
+      return 0;
+  }
+
   {
     boost::mutex::scoped_lock lock( _buf_mutex );
 
     int buf_tail = (_buf_head + _buf_used) % _buf_num;
     memcpy(_buf[buf_tail], buf, len);
+    _samp_in += len / BYTES_PER_SAMPLE;
 
     if (_buf_used == _buf_num) {
       std::cerr << "O" << std::flush;
@@ -304,6 +390,14 @@ int hackrf_source_c::hackrf_rx_callback(unsigned char *buf, uint32_t len)
   return 0; // TODO: return -1 on error/stop
 }
 
+/* the position of the first sample of the next transfer, after decimation */
+uint64_t hackrf_source_c::samples_received()
+{
+  boost::mutex::scoped_lock lock( _buf_mutex );
+
+  return _samp_in / _decim.get_decimation();
+}
+
 void hackrf_source_c::_hackrf_wait(hackrf_source_c *obj)
 {
   obj->hackrf_wait();
@@ -317,6 +411,9 @@ bool hackrf_source_c::start()
 {
   if ( ! _dev )
     return false;
+
+  /* already streaming since construction */
+  _defaults.apply();
 #if 0
   int ret = hackrf_start_rx( _dev, _hackrf_rx_callback, (void *)this );
   if ( ret != HACKRF_SUCCESS ) {
@@ -341,11 +438,78 @@ bool hackrf_source_c::stop()
   return true;
 }
 
+/* converts n samples, correcting them on the way if asked to */
+void hackrf_source_c::convert( const unsigned short *buf, int n, gr_complex *out )
+{
+  if (_corrector.enabled()) {
+    _corrector.convert( (const unsigned char *)buf, n, &_lut8[0], out );
+    return;
+  }
+
+  for (int i = 0; i < n; ++i)
+    *out++ = _lut[ *(buf + i) ];
+}
+
+/*
+ * Measures the raw samples ahead of their conversion into the output at
+ * produced and tags the statistics of each complete window there. A step
+ * of the software gain control is queued on the executor, work() does not
+ * wait for the control transfers.
+ */
+void hackrf_source_c::measure( const unsigned short *buf, int n, int produced )
+{
+  if ( ! _agc.measure( (const unsigned char *)buf, n, true ) )
+    return;
+
+  if ( _stats )
+    add_item_tag( 0, nitems_written( 0 ) + produced, pmt::mp( "rx_stats" ), _agc.to_pmt() );
+
+  if ( _soft_agc && _auto_gain && _agc.queue_step() )
+    boost::atomic_load( &_exec )->post( boost::bind( &hackrf_source_c::step_gain, this ) );
+}
+
+void hackrf_source_c::set_executor( const boost::shared_ptr< device_executor > &exec )
+{
+  boost::shared_ptr< device_executor > own;
+  if ( ! exec )
+    own = boost::make_shared< device_executor >();
+
+  boost::atomic_store( &_exec, exec ? exec : own );
+}
+
+/*
+ * Takes a step of the software gain control. Its ladder runs over the total
+ * of the LNA and the VGA gain in steps of 2 dB, filling the LNA first for
+ * the better noise figure. The steps are tagged as rx_if_gain and rx_bb_gain
+ * by the setters, rx_gain stays the amp gain that get_gain() returns.
+ */
+void hackrf_source_c::step_gain()
+{
+  const size_t count = (40 + 62) / 2 + 1;
+  size_t current = size_t(_lna_gain + _vga_gain) / 2;
+
+  size_t next = _agc.step( current, _auto_gain ? count : 0 );
+  if ( next == current )
+    return;
+
+  double total = next * 2;
+  double lna = std::min( 40.0, std::floor( total / 8 ) * 8 );
+
+  try {
+    set_if_gain( lna );
+    set_bb_gain( total - lna );
+  } catch ( std::exception &ex ) {
+    std::cerr << "Failed to step the gain: " << ex.what() << std::endl;
+  }
+}
+
 int hackrf_source_c::work( int noutput_items,
                         gr_vector_const_void_star &input_items,
                         gr_vector_void_star &output_items )
 {
   gr_complex *out = (gr_complex *)output_items[0];
+  const int decim = _decim.get_decimation();
+  uint64_t pos;
 
   bool running = false;
 
@@ -357,6 +521,9 @@ int hackrf_source_c::work( int noutput_items,
 
     while (_buf_used < 3 && running) // collect at least 3 buffers
       _buf_cond.wait( lock );
+
+    /* the head buffer is the oldest one still held */
+    pos = (_samp_in - _buf_used * (_buf_len / BYTES_PER_SAMPLE) + _buf_offset) / decim;
   }
 
   if ( ! running )
@@ -364,15 +531,56 @@ int hackrf_source_c::work( int noutput_items,
 
   unsigned short *buf = _buf[_buf_head] + _buf_offset;
 
-  if (noutput_items <= _samp_avail) {
-    for (int i = 0; i < noutput_items; ++i)
-      *out++ = _lut[ *(buf + i) ];
+  if (decim > 1) {
+    int produced = 0;
+
+    while (produced < noutput_items && _buf_used) {
+      /* whole multiples of the decimation leave exactly nin / decim */
+      int nin = std::min((noutput_items - produced) * decim, _samp_avail);
+      if (nin > decim)
+        nin -= nin % decim;
+
+      if (_soft_agc || _stats)
+        measure( buf, nin, produced );
+
+      int n = _decim.decimate( (const unsigned char *)buf, nin,
+                               &_lut16[0], out + produced );
+      if (_corrector.enabled())
+        _corrector.correct( out + produced, n );
+      produced += n;
+
+      _buf_offset += nin;
+      _samp_avail -= nin;
+
+      if (!_samp_avail) {
+        boost::mutex::scoped_lock lock( _buf_mutex );
+
+        _buf_head = (_buf_head + 1) % _buf_num;
+        _buf_used--;
+
+        _buf_offset = 0;
+        _samp_avail = _buf_len / BYTES_PER_SAMPLE;
+      }
+
+      buf = _buf[_buf_head] + _buf_offset;
+    }
+
+    noutput_items = produced;
+  } else if (noutput_items <= _samp_avail) {
+    if (_soft_agc || _stats)
+      measure( buf, noutput_items, 0 );
+
+    convert( buf, noutput_items, out );
+    out += noutput_items;
 
     _buf_offset += noutput_items;
     _samp_avail -= noutput_items;
   } else {
-    for (int i = 0; i < _samp_avail; ++i)
-      *out++ = _lut[ *(buf + i) ];
+    if (_soft_agc || _stats)
+      measure( buf, _samp_avail, 0 );
+
+    convert( buf, _samp_avail, out );
+    out += _samp_avail;
 
     {
       boost::mutex::scoped_lock lock( _buf_mutex );
@@ -385,13 +593,19 @@ int hackrf_source_c::work( int noutput_items,
 
     int remaining = noutput_items - _samp_avail;
 
-    for (int i = 0; i < remaining; ++i)
-      *out++ = _lut[ *(buf + i) ];
+    if (_soft_agc || _stats)
+      measure( buf, remaining, _samp_avail );
+
+    convert( buf, remaining, out );
+    out += remaining;
 
     _buf_offset = remaining;
     _samp_avail = (_buf_len / BYTES_PER_SAMPLE) - remaining;
   }
 
+  BOOST_FOREACH( const gr::tag_t &change, _changes.take( pos, noutput_items, nitems_written( 0 ) ) )
+    add_item_tag( 0, change );
+
   return noutput_items;
 }
 
@@ -490,17 +704,30 @@ osmosdr::meta_range_t hackrf_source_c::get_sample_rates()
   range += osmosdr::range_t( 16e6 );
   range += osmosdr::range_t( 20e6 ); /* confirmed to work on fast machines */
 
-  return range;
+  return decimate_rates( range, _decim.get_decimation() );
 }
 
 double hackrf_source_c::set_sample_rate( double rate )
 {
   int ret;
 
+  _defaults.cancel( "rate" );
+
+  /* the device runs at the rate before decimation */
+  rate *= _decim.get_decimation();
+
   if (_dev) {
-    ret = hackrf_set_sample_rate( _dev, rate );
+    ret = HACKRF_SUCCESS;
+    if ( ! _settings->cached( "rate", rate ) )
+      ret = hackrf_set_sample_rate( _dev, rate );
     if ( HACKRF_SUCCESS == ret ) {
+      _settings->store( "rate", rate );
+      if ( rate != _sample_rate )
+        _changes.post( "rx_rate", rate / _decim.get_decimation(), samples_received() );
       _sample_rate = rate;
+      _agc.set_sample_rate( rate );
+      if (_recorder)
+        _recorder->set_sample_rate( rate );
       //set_bandwidth( 0.0 ); /* bandwidth of 0 means automatic filter selection */
     } else {
       HACKRF_THROW_ON_ERROR( ret, HACKRF_FUNC_STR( "hackrf_set_sample_rate", rate ) )
@@ -512,7 +739,7 @@ double hackrf_source_c::set_sample_rate( double rate )
 
 double hackrf_source_c::get_sample_rate()
 {
-  return _sample_rate;
+  return _sample_rate / _decim.get_decimation();
 }
 
 osmosdr::freq_range_t hackrf_source_c::get_freq_range( size_t chan )
@@ -528,13 +755,22 @@ double hackrf_source_c::set_center_freq( double freq, size_t chan )
 {
   int ret;
 
+  _defaults.cancel( "freq" );
+
   #define APPLY_PPM_CORR(val, ppm) ((val) * (1.0 + (ppm) * 0.000001))
 
   if (_dev) {
     double corr_freq = APPLY_PPM_CORR( freq, _freq_corr );
-    ret = hackrf_set_freq( _dev, uint64_t(corr_freq) );
+    ret = HACKRF_SUCCESS;
+    if ( ! _settings->cached( "freq", uint64_t(corr_freq) ) )
+      ret = hackrf_set_freq( _dev, uint64_t(corr_freq) );
     if ( HACKRF_SUCCESS == ret ) {
+      _settings->store( "freq", uint64_t(corr_freq) );
+      if ( freq != _center_freq )
+        _changes.post( "rx_freq", freq, samples_received() );
       _center_freq = freq;
+      if (_recorder)
+        _recorder->set_center_freq( freq );
     } else {
       HACKRF_THROW_ON_ERROR( ret, HACKRF_FUNC_STR( "hackrf_set_freq", corr_freq ) )
     }
@@ -616,8 +852,13 @@ double hackrf_source_c::set_gain( double gain, size_t chan )
     double clip_gain = rf_gains.clip( gain, true );
     uint8_t value = clip_gain == 14.0f ? 1 : 0;
 
-    ret = hackrf_set_amp_enable( _dev, value );
+    ret = HACKRF_SUCCESS;
+    if ( ! _settings->cached( "amp", value ) )
+      ret = hackrf_set_amp_enable( _dev, value );
     if ( HACKRF_SUCCESS == ret ) {
+      _settings->store( "amp", value );
+      if ( clip_gain != _amp_gain )
+        _changes.post( "rx_gain", clip_gain, samples_received() );
       _amp_gain = clip_gain;
     } else {
       HACKRF_THROW_ON_ERROR( ret, HACKRF_FUNC_STR( "hackrf_set_amp_enable", value ) )
@@ -671,11 +912,18 @@ double hackrf_source_c::set_if_gain(double gain, size_t chan)
   int ret;
   osmosdr::gain_range_t rf_gains = get_gain_range( "IF", chan );
 
+  _defaults.cancel( "if_gain" );
+
   if (_dev) {
     double clip_gain = rf_gains.clip( gain, true );
 
-    ret = hackrf_set_lna_gain( _dev, uint32_t(clip_gain) );
+    ret = HACKRF_SUCCESS;
+    if ( ! _settings->cached( "lna", uint32_t(clip_gain) ) )
+      ret = hackrf_set_lna_gain( _dev, uint32_t(clip_gain) );
     if ( HACKRF_SUCCESS == ret ) {
+      _settings->store( "lna", uint32_t(clip_gain) );
+      if ( clip_gain != _lna_gain )
+        _changes.post( "rx_if_gain", clip_gain, samples_received() );
       _lna_gain = clip_gain;
     } else {
       HACKRF_THROW_ON_ERROR( ret, HACKRF_FUNC_STR( "hackrf_set_lna_gain", clip_gain ) )
@@ -690,11 +938,18 @@ double hackrf_source_c::set_bb_gain( double gain, size_t chan )
   int ret;
   osmosdr::gain_range_t if_gains = get_gain_range( "BB", chan );
 
+  _defaults.cancel( "bb_gain" );
+
   if (_dev) {
     double clip_gain = if_gains.clip( gain, true );
 
-    ret = hackrf_set_vga_gain( _dev, uint32_t(clip_gain) );
+    ret = HACKRF_SUCCESS;
+    if ( ! _settings->cached( "vga", uint32_t(clip_gain) ) )
+      ret = hackrf_set_vga_gain( _dev, uint32_t(clip_gain) );
     if ( HACKRF_SUCCESS == ret ) {
+      _settings->store( "vga", uint32_t(clip_gain) );
+      if ( clip_gain != _vga_gain )
+        _changes.post( "rx_bb_gain", clip_gain, samples_received() );
       _vga_gain = clip_gain;
     } else {
       HACKRF_THROW_ON_ERROR( ret, HACKRF_FUNC_STR( "hackrf_set_vga_gain", clip_gain ) )
@@ -723,9 +978,31 @@ std::string hackrf_source_c::get_antenna( size_t chan )
   return "TX/RX";
 }
 
+void hackrf_source_c::set_dc_offset_mode( int mode, size_t chan )
+{
+  _corrector.set_dc_offset_mode( mode );
+}
+
+void hackrf_source_c::set_dc_offset( const std::complex<double> &offset, size_t chan )
+{
+  _corrector.set_dc_offset( offset );
+}
+
+void hackrf_source_c::set_iq_balance_mode( int mode, size_t chan )
+{
+  _corrector.set_iq_balance_mode( mode );
+}
+
+void hackrf_source_c::set_iq_balance( const std::complex<double> &balance, size_t chan )
+{
+  _corrector.set_iq_balance( balance );
+}
+
 double hackrf_source_c::set_bandwidth( double bandwidth, size_t chan )
 {
   int ret;
+
+  _defaults.cancel( "bandwidth" );
 //  osmosdr::freq_range_t bandwidths = get_bandwidth_range( chan );
 
   if ( bandwidth == 0.0 ) /* bandwidth of 0 means automatic filter selection */
@@ -734,8 +1011,11 @@ double hackrf_source_c::set_bandwidth( double bandwidth, size_t chan )
   if ( _dev ) {
     /* compute best default value depending on sample rate (auto filter) */
     uint32_t bw = hackrf_compute_baseband_filter_bw( uint32_t(bandwidth) );
-    ret = hackrf_set_baseband_filter_bandwidth( _dev, bw );
+    ret = HACKRF_SUCCESS;
+    if ( ! _settings->cached( "bandwidth", bw ) )
+      ret = hackrf_set_baseband_filter_bandwidth( _dev, bw );
     if ( HACKRF_SUCCESS == ret ) {
+      _settings->store( "bandwidth", bw );
       _bandwidth = bw;
     } else {
       HACKRF_THROW_ON_ERROR( ret, HACKRF_FUNC_STR( "hackrf_set_baseband_filter_bandwidth", bw ) )
@@ -776,6 +1056,28 @@ osmosdr::freq_range_t hackrf_source_c::get_bandwidth_range( size_t chan )
   return bandwidths;
 }
 
+double hackrf_source_c::get_settle_time( size_t chan )
+{
+  return tuner_settle_time( "MAX2837" );
+}
+
+osmosdr::channel_settings hackrf_source_c::configure( const osmosdr::channel_settings &settings,
+                                                  size_t chan )
+{
+  /* one pass with the rate ahead of the filter and the frequency, values
+   * the device already has are skipped through the settings cache */
+  osmosdr::channel_settings actual;
+  {
+    /* one rx_retune tag instead of the tags of each setter */
+    change_tags::hold hold( _changes );
+    actual = apply_channel_settings( this, settings, chan );
+  }
+
+  _changes.post_retune( actual, samples_received() );
+
+  return actual;
+}
+
 void hackrf_source_c::set_biast( bool enabled ) {
   hackrf_set_antenna_enable(_dev, enabled ? 1 : 0);
   _biasT = enabled;
@@ -784,3 +1086,6 @@ void hackrf_source_c::set_biast( bool enabled ) {
 bool hackrf_source_c::get_biast() {
   return _biasT;
 }
+
+OSMOSDR_REGISTER_SOURCE( hackrf, "hackrf", PROBE_USB,
+                         make_hackrf_source_c, hackrf_source_c::get_devices() );
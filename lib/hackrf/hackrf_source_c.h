@@ -31,6 +31,13 @@
 #include <libhackrf/hackrf.h>
 
 #include "source_iface.h"
+#include "iq_corrector.h"
+#include "soft_agc.h"
+#include "device_executor.h"
+#include "raw_recorder.h"
+#include "device_startup.h"
+#include "device_pool.h"
+#include "halfband_decim.h"
 
 class hackrf_source_c;
 
@@ -96,6 +103,8 @@ public:
   osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
   double set_center_freq( double freq, size_t chan = 0 );
   double get_center_freq( size_t chan = 0 );
+  bool tags_changes() { return true; }
+  void set_executor( const boost::shared_ptr< device_executor > &exec );
   double set_freq_corr( double ppm, size_t chan = 0 );
   double get_freq_corr( size_t chan = 0 );
 
@@ -116,10 +125,21 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  void set_dc_offset_mode( int mode, size_t chan = 0 );
+  void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
+
+  void set_iq_balance_mode( int mode, size_t chan = 0 );
+  void set_iq_balance( const std::complex<double> &balance, size_t chan = 0 );
+
   double set_bandwidth( double bandwidth, size_t chan = 0 );
   double get_bandwidth( size_t chan = 0 );
   osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
 
+  osmosdr::channel_settings configure( const osmosdr::channel_settings &settings,
+                                       size_t chan = 0 );
+
+  double get_settle_time( size_t chan = 0 );
+
   void set_biast( bool enabled );
   bool get_biast();
 
@@ -127,12 +147,26 @@ private:
   static int _hackrf_rx_callback(hackrf_transfer* transfer);
   int hackrf_rx_callback(unsigned char *buf, uint32_t len);
   static void _hackrf_wait(hackrf_source_c *obj);
+  static hackrf_device *open_device(dict_t &dict);
+  static void close_device(void *dev);
+  uint64_t samples_received();
+  void convert( const unsigned short *buf, int n, gr_complex *out );
+  void measure( const unsigned short *buf, int n, int produced );
+  void step_gain();
   void hackrf_wait();
 
   static int _usage;
   static boost::mutex _usage_mutex;
 
   std::vector<gr_complex> _lut;
+  std::vector<int16_t> _lut16; /* for decimation, full scale at FULL_SCALE */
+  halfband_decim _decim;
+  std::vector<float> _lut8; /* for correction, per byte */
+  iq_corrector _corrector;
+  soft_agc _agc;
+  bool _soft_agc; /* automatic gain steps the LNA and VGA gains on _exec */
+  bool _stats; /* tags the statistics of each window of _agc */
+  boost::shared_ptr< device_executor > _exec; /* runs the steps of _agc */
 
   hackrf_device *_dev;
   gr::thread::thread _thread;
@@ -146,8 +180,9 @@ private:
 
   unsigned int _buf_offset;
   int _samp_avail;
+  uint64_t _samp_in; /* samples put into the buffers since opening */
 
-  double _sample_rate;
+  double _sample_rate; /* of the device, before decimation */
   double _center_freq;
   double _freq_corr;
   bool _auto_gain;
@@ -156,6 +191,17 @@ private:
   double _vga_gain;
   double _bandwidth;
   bool _biasT;
+
+  boost::shared_ptr<raw_recorder> _recorder;
+  bool _record_only;
+
+  startup_timer _timer;
+  deferred_defaults _defaults;
+  change_tags _changes;
+
+  std::string _pool_key;
+  double _linger;
+  device_settings_sptr _settings;
 };
 
 #endif /* INCLUDED_HACKRF_SOURCE_C_H */
@@ -0,0 +1,241 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <volk/volk.h>
+
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "halfband_decim.h"
+#include "airspy/airspy_fir_kernels.h"
+
+#define MAX_DECIMATION 64
+
+size_t parse_decimation( const std::string &value )
+{
+  size_t decim = 0;
+
+  try {
+    decim = boost::lexical_cast< size_t >( value );
+  } catch ( boost::bad_lexical_cast & ) {
+  }
+
+  if ( decim < 1 || decim > MAX_DECIMATION || (decim & (decim - 1)) )
+    throw std::runtime_error( "Invalid decimation '" + value +
+                              "', expected a power of two from 1 to 64." );
+
+  return decim;
+}
+
+osmosdr::meta_range_t decimate_rates( const osmosdr::meta_range_t &rates, size_t decim )
+{
+  if ( decim == 1 )
+    return rates;
+
+  osmosdr::meta_range_t decimated;
+
+  BOOST_FOREACH( const osmosdr::range_t &range, rates )
+    decimated.push_back( osmosdr::range_t( range.start() / decim, range.stop() / decim,
+                                           range.step() / decim ) );
+
+  return decimated;
+}
+
+halfband_decim::halfband_decim( size_t decim ) :
+  _decim( 1 ),
+  _quarter( 0 )
+{
+  set_decimation( decim );
+}
+
+void halfband_decim::set_decimation( size_t decim )
+{
+  _decim = decim;
+  _stages.clear();
+
+  for (size_t ahead = decim; ahead > 1; ahead /= 2) {
+    const float *kernel;
+    size_t len;
+
+    if ( ahead <= 2 ) {
+      kernel = KERNEL_2_80;
+      len = KERNEL_2_80_LEN;
+    } else if ( ahead <= 4 ) {
+      kernel = KERNEL_4_90;
+      len = KERNEL_4_90_LEN;
+    } else if ( ahead <= 8 ) {
+      kernel = KERNEL_8_100;
+      len = KERNEL_8_100_LEN;
+    } else {
+      kernel = KERNEL_16_110;
+      len = KERNEL_16_110_LEN;
+    }
+
+    /* Q15, only the center and the odd taps are nonzero */
+    stage s;
+    size_t half = (len - 1) / 2;
+
+    s.center = int32_t( kernel[ half ] * 32768 + 0.5f );
+    for (size_t d = 1; d <= half; d += 2)
+      s.taps.push_back( int32_t( kernel[ half + d ] * 32768 + (kernel[ half + d ] < 0 ? -0.5f : 0.5f) ) );
+
+    s.history.assign( 2 * 2 * half, 0 );
+    s.odd = false;
+
+    _stages.push_back( s );
+  }
+}
+
+void halfband_decim::reset()
+{
+  for (size_t i = 0; i < _stages.size(); i++) {
+    std::fill( _stages[i].history.begin(), _stages[i].history.end(), 0 );
+    _stages[i].odd = false;
+  }
+
+  _quarter = 0;
+}
+
+size_t halfband_decim::stage::run( int16_t *iq, size_t n )
+{
+  size_t ntaps = taps.size();
+  size_t half = 2 * ntaps - 1;  /* the outermost tap */
+  size_t keep = history.size(); /* 2 * half interleaved samples */
+
+  work.resize( keep + 2 * n );
+  std::copy( history.begin(), history.end(), work.begin() );
+  std::copy( iq, iq + 2 * n, work.begin() + keep );
+  std::copy( work.end() - keep, work.end(), history.begin() );
+
+  /* centers run over the new samples, delayed by half */
+  size_t first = half + (odd ? 1 : 0);
+  size_t produced = half + n > first ? (half + n - first + 1) / 2 : 0;
+
+  odd = (first + 2 * produced - n - half) == 1;
+
+  if ( ! produced )
+    return 0;
+
+  /*
+   * The odd taps of output c read c - d and c + d of the other phase of
+   * the input than c itself. Split into the centers and the phase around
+   * them, for I and Q each, every tap is a multiply-add of two contiguous
+   * runs over all outputs, which the compiler vectorizes.
+   */
+  const int16_t *w = &work[0];
+  size_t nouter = produced + 2 * ntaps - 1;
+
+  for (size_t ch = 0; ch < 2; ch++) {
+    centers[ch].resize( produced );
+    outer[ch].resize( nouter );
+    acc[ch].resize( produced );
+
+    int16_t *a = &centers[ch][0];
+    int16_t *b = &outer[ch][0];
+    int32_t *sum = &acc[ch][0];
+
+    for (size_t j = 0; j < produced; j++)
+      a[j] = w[ 2 * (first + 2 * j) + ch ];
+
+    for (size_t m = 0; m < nouter; m++)
+      b[m] = w[ 2 * (first - half + 2 * m) + ch ];
+
+    for (size_t j = 0; j < produced; j++)
+      sum[j] = center * a[j];
+
+    for (size_t k = 0; k < ntaps; k++) {
+      const int32_t tap = taps[k];
+      const int16_t *lo = b + ntaps - 1 - k; /* c - (2k + 1) */
+      const int16_t *hi = b + ntaps + k;     /* c + (2k + 1) */
+
+      for (size_t j = 0; j < produced; j++)
+        sum[j] += tap * (lo[j] + hi[j]);
+    }
+  }
+
+  for (size_t j = 0; j < produced; j++) {
+    int32_t acc_i = (acc[0][j] + (1 << 14)) >> 15;
+    int32_t acc_q = (acc[1][j] + (1 << 14)) >> 15;
+
+    iq[ 2 * j ] = int16_t( std::max( -32768, std::min( 32767, acc_i ) ) );
+    iq[ 2 * j + 1 ] = int16_t( std::max( -32768, std::min( 32767, acc_q ) ) );
+  }
+
+  return produced;
+}
+
+size_t halfband_decim::decimate( int16_t *iq, size_t n )
+{
+  for (size_t i = 0; i < _stages.size(); i++)
+    n = _stages[i].run( iq, n );
+
+  return n;
+}
+
+size_t halfband_decim::decimate( const unsigned char *iq, size_t n,
+                                 const int16_t *lut, gr_complex *out )
+{
+  _buf.resize( 2 * n );
+
+  for (size_t i = 0; i < 2 * n; i++)
+    _buf[i] = lut[ iq[i] ];
+
+  n = decimate( &_buf[0], n );
+  to_complex( &_buf[0], n, out );
+
+  return n;
+}
+
+size_t halfband_decim::decimate_real( const int16_t *x, size_t n, gr_complex *out,
+                                      float full_scale )
+{
+  _buf.resize( 2 * n );
+
+  /* multiply by -j^k, which leaves every other I and Q zero */
+  for (size_t i = 0; i < n; i++) {
+    int16_t s = x[i];
+    int16_t neg = (s == -32768) ? 32767 : -s;
+
+    switch ( (_quarter + i) & 3 ) {
+    case 0: _buf[ 2 * i ] = neg; _buf[ 2 * i + 1 ] = 0; break;
+    case 1: _buf[ 2 * i ] = 0; _buf[ 2 * i + 1 ] = neg; break;
+    case 2: _buf[ 2 * i ] = s; _buf[ 2 * i + 1 ] = 0; break;
+    case 3: _buf[ 2 * i ] = 0; _buf[ 2 * i + 1 ] = s; break;
+    }
+  }
+
+  _quarter = (_quarter + n) & 3;
+
+  n = decimate( &_buf[0], n );
+  to_complex( &_buf[0], n, out, full_scale );
+
+  return n;
+}
+
+void halfband_decim::to_complex( const int16_t *iq, size_t n, gr_complex *out,
+                                 float full_scale )
+{
+  volk_16i_s32f_convert_32f( (float *)out, iq, full_scale, 2 * n );
+}
@@ -0,0 +1,107 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_HALFBAND_DECIM_H
+#define OSMOSDR_HALFBAND_DECIM_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <gnuradio/gr_complex.h>
+
+#include <osmosdr/api.h>
+#include <osmosdr/ranges.h>
+
+/* parses the decim argument, a power of two from 1 to 64 */
+OSMOSDR_API size_t parse_decimation( const std::string &value );
+
+/* the rates of a device delivering samples at rates, after decimation */
+OSMOSDR_API osmosdr::meta_range_t decimate_rates( const osmosdr::meta_range_t &rates, size_t decim );
+
+/*
+ * Decimates interleaved 16 bit I/Q samples by a power of two with a
+ * cascade of half-band filters in integer arithmetic, before anything is
+ * converted to float. Each stage uses the kernel of airspy_fir_kernels.h
+ * matching the decimation still ahead of it, so the early stages running
+ * at the higher rates are the short ones. Each stage splits its input
+ * into planes of I and Q by phase, so the inner loops are plain integer
+ * multiply-adds over contiguous samples, which the compiler vectorizes.
+ */
+class OSMOSDR_API halfband_decim
+{
+public:
+  /* the sample value of full scale, leaving headroom for the ripple */
+  static const int FULL_SCALE = 1 << 14;
+
+  halfband_decim( size_t decim = 1 );
+
+  void set_decimation( size_t decim );
+  size_t get_decimation() const { return _decim; }
+
+  /* forgets the samples of previous calls */
+  void reset();
+
+  /*
+   * Decimates n samples in place and returns the number of samples left,
+   * n / decimation for n multiple of the decimation.
+   */
+  size_t decimate( int16_t *iq, size_t n );
+
+  /* converts n samples of 8 bit I/Q through lut, then decimates them into out */
+  size_t decimate( const unsigned char *iq, size_t n, const int16_t *lut, gr_complex *out );
+
+  /*
+   * Translates n real samples by a quarter of their rate, the band around
+   * -rate/4 ending up around 0, and decimates the result into out. The
+   * decimation includes the factor 2 of going from real to complex, it
+   * has to be at least 2.
+   */
+  size_t decimate_real( const int16_t *x, size_t n, gr_complex *out,
+                        float full_scale = FULL_SCALE );
+
+  /* converts n decimated samples to complex float, full_scale becoming 1 */
+  static void to_complex( const int16_t *iq, size_t n, gr_complex *out,
+                          float full_scale = FULL_SCALE );
+
+private:
+  struct stage
+  {
+    int32_t center;
+    std::vector< int32_t > taps;    /* odd taps from the center outwards */
+    std::vector< int16_t > history; /* last samples of the previous call */
+    std::vector< int16_t > work;
+    std::vector< int16_t > centers[2]; /* I and Q at the output centers */
+    std::vector< int16_t > outer[2];   /* I and Q of the other phase */
+    std::vector< int32_t > acc[2];
+    bool odd;                       /* the next output is due one sample later */
+
+    size_t run( int16_t *iq, size_t n );
+  };
+
+  size_t _decim;
+  size_t _quarter; /* the phase of the translation, in samples mod 4 */
+  std::vector< stage > _stages;
+  std::vector< int16_t > _buf;
+};
+
+#endif // OSMOSDR_HALFBAND_DECIM_H
@@ -0,0 +1,311 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+#include <gnuradio/io_signature.h>
+
+#include <boost/foreach.hpp>
+
+#include "hop_gate_cc.h"
+
+hop_gate_cc_sptr make_hop_gate_cc( const hop_retune_t &retune )
+{
+  return gnuradio::get_initial_sptr( new hop_gate_cc( retune ) );
+}
+
+hop_gate_cc::hop_gate_cc( const hop_retune_t &retune ) :
+  gr::block( "hop_gate_cc",
+             gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+             gr::io_signature::make( 1, 1, sizeof(gr_complex) ) ),
+  _retune( retune ),
+  _stop( false ),
+  _step( 0 ),
+  _generation( 0 ),
+  _state( IDLE ),
+  _requested( false ),
+  _read( 0 ),
+  _changed( false ),
+  _changed_at( 0 ),
+  _wait( 0 ),
+  _discard( 0 ),
+  _remaining( 0 ),
+  _tag( false )
+{
+  /* samples are dropped, tags are moved along with the ones passed */
+  set_tag_propagation_policy( TPP_DONT );
+}
+
+hop_gate_cc::~hop_gate_cc()
+{
+  stop();
+}
+
+bool hop_gate_cc::start()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _stop = false;
+
+  if ( ! _schedule.empty() && ! _thread.joinable() ) {
+    retune(); /* the device may have been retuned while stopped */
+    _thread = boost::thread( &hop_gate_cc::control, this );
+  }
+
+  return true;
+}
+
+bool hop_gate_cc::stop()
+{
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+    _stop = true;
+  }
+
+  _cond.notify_all();
+
+  if ( _thread.joinable() )
+    _thread.join();
+
+  return true;
+}
+
+void hop_gate_cc::set_schedule( const osmosdr::hop_schedule_t &schedule )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _schedule = schedule;
+  _generation++;
+  _step = 0;
+
+  if ( _schedule.empty() ) {
+    _state = IDLE;
+    _requested = false;
+    return;
+  }
+
+  retune();
+
+  if ( ! _stop && ! _thread.joinable() )
+    _thread = boost::thread( &hop_gate_cc::control, this );
+
+  _cond.notify_all();
+}
+
+/* hands the current step to the control thread, with _mutex held */
+void hop_gate_cc::retune()
+{
+  _state = RETUNING;
+  _requested = true;
+  _changed = false;
+}
+
+void hop_gate_cc::control()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+  unsigned int failures = 0;
+
+  while ( true ) {
+    while ( ! _requested && ! _stop )
+      _cond.wait( lock );
+
+    if ( _stop )
+      break;
+
+    _requested = false;
+
+    osmosdr::hop_t hop = _schedule[ _step ];
+    unsigned int generation = _generation;
+    hop_settle_t settle;
+    bool failed = false;
+
+    lock.unlock();
+
+    try {
+      settle = _retune( hop );
+    } catch ( std::exception &ex ) {
+      if ( 0 == failures ) /* once, it may fail on every step */
+        std::cerr << "Failed to hop to " << hop.freq << " Hz: " << ex.what() << std::endl;
+      failed = true;
+    }
+
+    lock.lock();
+
+    if ( failed ) {
+      /* back off from 10 ms up to a second, the device may be busy or gone */
+      int delay = 10 << std::min( failures++, 7u );
+      _cond.timed_wait( lock, boost::posix_time::milliseconds( std::min( delay, 1000 ) ) );
+    } else if ( failures ) {
+      std::cerr << "Hopping again after " << failures << " failed retunes." << std::endl;
+      failures = 0;
+    }
+
+    if ( _stop )
+      break;
+
+    if ( generation != _generation ) /* the schedule was replaced meanwhile */
+      continue;
+
+    if ( failed ) { /* no samples can be vouched for, go on with the next step */
+      _step = (_step + 1) % _schedule.size();
+      retune();
+      continue;
+    }
+
+    _discard = settle.samples;
+    _remaining = hop.dwell;
+    _tag = true;
+
+    if ( ! settle.tagged ) {
+      _state = SETTLING;
+    } else if ( _changed ) {
+      /* the samples dropped since the tag count towards settling */
+      uint64_t since = _read - _changed_at;
+      _discard -= std::min( uint64_t(_discard), since );
+      _state = SETTLING;
+    } else {
+      _wait = settle.limit;
+      _state = WAITING;
+    }
+  }
+}
+
+/*
+ * Looks for the rx_freq tag of a retune in the next n input samples, at
+ * consumed. Returns the offset of the last one.
+ */
+bool hop_gate_cc::find_change( int n, int consumed, uint64_t &offset )
+{
+  std::vector< gr::tag_t > tags;
+  uint64_t start = nitems_read( 0 ) + consumed;
+
+  get_tags_in_range( tags, 0, start, start + n, pmt::mp("rx_freq") );
+
+  if ( tags.empty() )
+    return false;
+
+  offset = 0;
+  BOOST_FOREACH( const gr::tag_t &tag, tags )
+    offset = std::max( offset, tag.offset );
+
+  return true;
+}
+
+void hop_gate_cc::pass( const gr_complex *in, gr_complex *out, int n,
+                        int consumed, int produced )
+{
+  memcpy( out, in, n * sizeof(gr_complex) );
+
+  std::vector< gr::tag_t > tags;
+  uint64_t start = nitems_read( 0 ) + consumed;
+
+  get_tags_in_range( tags, 0, start, start + n );
+
+  BOOST_FOREACH( gr::tag_t &tag, tags ) {
+    tag.offset = nitems_written( 0 ) + produced + (tag.offset - start);
+    add_item_tag( 0, tag );
+  }
+}
+
+int hop_gate_cc::general_work( int noutput_items,
+                               gr_vector_int &ninput_items,
+                               gr_vector_const_void_star &input_items,
+                               gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *)input_items[0];
+  gr_complex *out = (gr_complex *)output_items[0];
+
+  int ninput = std::min( noutput_items, ninput_items[0] );
+  int consumed = 0, produced = 0;
+
+  boost::mutex::scoped_lock lock( _mutex );
+
+  while ( consumed < ninput ) {
+    int avail = ninput - consumed;
+
+    if ( IDLE == _state ) {
+      pass( in + consumed, out + produced, avail, consumed, produced );
+      consumed += avail;
+      produced += avail;
+    } else if ( RETUNING == _state ) {
+      /* whatever arrives before the retune is done can't be trusted */
+      uint64_t offset;
+      if ( find_change( avail, consumed, offset ) ) {
+        _changed = true;
+        _changed_at = offset;
+      }
+
+      consumed += avail;
+    } else if ( WAITING == _state ) {
+      /* samples queued at the old frequency, up to the tag of the new one */
+      uint64_t offset;
+      int n = avail;
+
+      if ( find_change( avail, consumed, offset ) ) {
+        n = offset - (nitems_read( 0 ) + consumed);
+        _state = SETTLING;
+      } else if ( size_t(n) >= _wait ) {
+        std::cerr << "No rx_freq tag after retuning, settling from here." << std::endl;
+        n = _wait;
+        _state = SETTLING;
+      } else {
+        _wait -= n;
+      }
+
+      consumed += n;
+    } else if ( SETTLING == _state ) {
+      int n = std::min( size_t(avail), _discard );
+      consumed += n;
+      _discard -= n;
+
+      if ( 0 == _discard )
+        _state = DWELLING;
+    } else { /* DWELLING */
+      int n = std::min( size_t(avail), _remaining );
+
+      if ( _tag && n ) {
+        add_item_tag( 0, nitems_written( 0 ) + produced,
+                      pmt::mp("rx_freq"), pmt::from_double( _schedule[ _step ].freq ) );
+        _tag = false;
+      }
+
+      pass( in + consumed, out + produced, n, consumed, produced );
+      consumed += n;
+      produced += n;
+      _remaining -= n;
+
+      if ( 0 == _remaining ) {
+        _step = (_step + 1) % _schedule.size();
+        retune();
+        _cond.notify_all();
+      }
+    }
+  }
+
+  _read = nitems_read( 0 ) + consumed;
+
+  consume_each( consumed );
+
+  return produced;
+}
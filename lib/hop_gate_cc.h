@@ -0,0 +1,119 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_HOP_GATE_CC_H
+#define OSMOSDR_HOP_GATE_CC_H
+
+#include <gnuradio/block.h>
+
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <osmosdr/hop.h>
+
+class hop_gate_cc;
+
+typedef boost::shared_ptr< hop_gate_cc > hop_gate_cc_sptr;
+
+/*
+ * The samples to discard after a retune while the tuner settles. With
+ * tagged, the rx_freq tag of the device marks the first sample received at
+ * the new frequency and the count starts there, older samples still queued
+ * are dropped up to it. Without such a tag within limit samples, or when
+ * not tagged, the count starts once the retune returned.
+ */
+struct hop_settle_t
+{
+  hop_settle_t( size_t samples = 0, bool tagged = false, size_t limit = 0 )
+    : samples( samples ), tagged( tagged ), limit( limit ) {}
+
+  size_t samples;
+  bool tagged;
+  size_t limit;
+};
+
+/* retunes the channel to a step of the schedule */
+typedef boost::function< hop_settle_t ( const osmosdr::hop_t &hop ) > hop_retune_t;
+
+hop_gate_cc_sptr make_hop_gate_cc( const hop_retune_t &retune );
+
+/*!
+ * \brief Steps a channel through a hop schedule, counting samples.
+ *
+ * Without a schedule the samples pass unchanged. With one, the gate passes
+ * the dwell samples of a step with an rx_freq tag on the first one, then
+ * drops samples while its control thread retunes to the next step and the
+ * tuner settles. A failing retune is retried on the next step after a
+ * growing pause.
+ */
+class hop_gate_cc : public gr::block
+{
+private:
+  friend hop_gate_cc_sptr make_hop_gate_cc( const hop_retune_t &retune );
+
+  hop_gate_cc( const hop_retune_t &retune );
+
+public:
+  ~hop_gate_cc();
+
+  /* an empty schedule stops hopping and leaves the channel where it is */
+  void set_schedule( const osmosdr::hop_schedule_t &schedule );
+
+  bool start();
+  bool stop();
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+private:
+  enum state_t { IDLE, RETUNING, WAITING, SETTLING, DWELLING };
+
+  void control();
+  void retune();
+  bool find_change( int n, int consumed, uint64_t &offset );
+  void pass( const gr_complex *in, gr_complex *out, int n, int consumed, int produced );
+
+  hop_retune_t _retune;
+
+  boost::mutex _mutex;
+  boost::condition_variable _cond;
+  boost::thread _thread;
+  bool _stop;
+
+  osmosdr::hop_schedule_t _schedule;
+  size_t _step;
+  unsigned int _generation; /* bumped whenever the schedule changes */
+  state_t _state;
+  bool _requested;          /* the control thread has a retune to do */
+  uint64_t _read;           /* input samples consumed so far */
+  bool _changed;            /* an rx_freq tag was dropped while retuning */
+  uint64_t _changed_at;     /* its offset */
+  size_t _wait;             /* samples left to wait for the tag */
+  size_t _discard;
+  size_t _remaining;
+  bool _tag;
+};
+
+#endif // OSMOSDR_HOP_GATE_CC_H
@@ -0,0 +1,260 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cmath>
+
+#include <osmosdr/source.h>
+
+#include "iq_corrector.h"
+
+#define ESTIMATE_EVERY 8  /* buffers */
+#define ESTIMATE_MIN   64 /* samples for an estimate */
+#define ALPHA          0.05
+
+iq_corrector::iq_corrector() :
+  _dc_mode( osmosdr::source::DCOffsetOff ),
+  _iq_mode( osmosdr::source::IQBalanceOff ),
+  _dc_manual( 0 ),
+  _iq_manual( 0 ),
+  _calls( 0 ),
+  _estimated( false ),
+  _mean_i( 0 ), _mean_q( 0 ),
+  _var_i( 0 ), _var_q( 0 ), _cov( 0 )
+{
+  _corr.dc_i = _corr.dc_q = 0;
+  _corr.gain_i = _corr.gain_q = 1;
+  _corr.cross = 0;
+}
+
+void iq_corrector::set_dc_offset_mode( int mode )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  /* manual mode takes the last value set, off resets the averaging */
+  if ( osmosdr::source::DCOffsetOff == mode ) {
+    _corr.dc_i = _corr.dc_q = 0;
+    _estimated = false;
+  } else if ( osmosdr::source::DCOffsetAutomatic == mode ) {
+    _estimated = false;
+  } else if ( osmosdr::source::DCOffsetManual == mode ) {
+    _corr.dc_i = _dc_manual.real();
+    _corr.dc_q = _dc_manual.imag();
+  }
+
+  _dc_mode = mode;
+}
+
+void iq_corrector::set_dc_offset( const std::complex<double> &offset )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _dc_manual = offset;
+
+  if ( osmosdr::source::DCOffsetManual == _dc_mode ) {
+    _corr.dc_i = offset.real();
+    _corr.dc_q = offset.imag();
+  }
+}
+
+void iq_corrector::set_iq_balance_mode( int mode )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( osmosdr::source::IQBalanceOff == mode ) {
+    _corr.gain_i = _corr.gain_q = 1;
+    _corr.cross = 0;
+    _estimated = false;
+  } else if ( osmosdr::source::IQBalanceAutomatic == mode ) {
+    _estimated = false;
+  } else if ( osmosdr::source::IQBalanceManual == mode ) {
+    _corr.gain_i = 1 + _iq_manual.real();
+    _corr.gain_q = 1;
+    _corr.cross = _iq_manual.imag();
+  }
+
+  _iq_mode = mode;
+}
+
+void iq_corrector::set_iq_balance( const std::complex<double> &balance )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _iq_manual = balance;
+
+  if ( osmosdr::source::IQBalanceManual == _iq_mode ) {
+    _corr.gain_i = 1 + balance.real();
+    _corr.gain_q = 1;
+    _corr.cross = balance.imag();
+  }
+}
+
+bool iq_corrector::enabled()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  return _dc_mode != osmosdr::source::DCOffsetOff ||
+         _iq_mode != osmosdr::source::IQBalanceOff;
+}
+
+/* takes the current correction, true if the buffer is to be estimated on */
+bool iq_corrector::begin( correction &c )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  c = _corr;
+
+  if ( _dc_mode != osmosdr::source::DCOffsetAutomatic &&
+       _iq_mode != osmosdr::source::IQBalanceAutomatic )
+    return false;
+
+  return (_calls++ % ESTIMATE_EVERY) == 0;
+}
+
+void iq_corrector::estimate( const gr_complex *iq, size_t n, correction &c )
+{
+  if ( n < ESTIMATE_MIN )
+    return;
+
+  const float *s = (const float *)iq;
+  double sum_i = 0, sum_q = 0, sum_ii = 0, sum_qq = 0, sum_iq = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    double si = s[ 2 * i ], sq = s[ 2 * i + 1 ];
+
+    sum_i += si;
+    sum_q += sq;
+    sum_ii += si * si;
+    sum_qq += sq * sq;
+    sum_iq += si * sq;
+  }
+
+  double mean_i = sum_i / n, mean_q = sum_q / n;
+  double var_i = sum_ii / n - mean_i * mean_i;
+  double var_q = sum_qq / n - mean_q * mean_q;
+  double cov = sum_iq / n - mean_i * mean_q;
+
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( ! _estimated ) {
+    _mean_i = mean_i; _mean_q = mean_q;
+    _var_i = var_i; _var_q = var_q; _cov = cov;
+    _estimated = true;
+  } else {
+    _mean_i += ALPHA * (mean_i - _mean_i);
+    _mean_q += ALPHA * (mean_q - _mean_q);
+    _var_i += ALPHA * (var_i - _var_i);
+    _var_q += ALPHA * (var_q - _var_q);
+    _cov += ALPHA * (cov - _cov);
+  }
+
+  if ( osmosdr::source::DCOffsetAutomatic == _dc_mode ) {
+    _corr.dc_i = _mean_i;
+    _corr.dc_q = _mean_q;
+  }
+
+  /* the power of Q left after removing its part correlated with I */
+  double ortho_q = _var_q - _cov * _cov / _var_i;
+
+  if ( osmosdr::source::IQBalanceAutomatic == _iq_mode &&
+       _var_i > 0 && ortho_q > 0 ) {
+    double gain = std::sqrt( _var_i / ortho_q );
+
+    _corr.gain_i = 1;
+    _corr.gain_q = gain;
+    _corr.cross = -gain * _cov / _var_i;
+  }
+
+  c = _corr;
+}
+
+void iq_corrector::apply( const correction &c, gr_complex *iq, size_t n )
+{
+  float *s = (float *)iq;
+
+  for (size_t i = 0; i < n; i++) {
+    float si = s[ 2 * i ] - c.dc_i;
+    float sq = s[ 2 * i + 1 ] - c.dc_q;
+
+    s[ 2 * i ] = c.gain_i * si;
+    s[ 2 * i + 1 ] = c.gain_q * sq + c.cross * si;
+  }
+}
+
+void iq_corrector::convert( const unsigned char *iq, size_t n,
+                            const float *lut, gr_complex *out )
+{
+  correction c;
+
+  if ( begin( c ) ) {
+    for (size_t i = 0; i < n; i++)
+      out[i] = gr_complex( lut[ iq[ 2 * i ] ], lut[ iq[ 2 * i + 1 ] ] );
+
+    estimate( out, n, c );
+    apply( c, out, n );
+    return;
+  }
+
+  float *s = (float *)out;
+
+  for (size_t i = 0; i < n; i++) {
+    float si = lut[ iq[ 2 * i ] ] - c.dc_i;
+    float sq = lut[ iq[ 2 * i + 1 ] ] - c.dc_q;
+
+    s[ 2 * i ] = c.gain_i * si;
+    s[ 2 * i + 1 ] = c.gain_q * sq + c.cross * si;
+  }
+}
+
+void iq_corrector::convert( const int16_t *iq, size_t n,
+                            float scale, gr_complex *out )
+{
+  correction c;
+
+  if ( begin( c ) ) {
+    for (size_t i = 0; i < n; i++)
+      out[i] = gr_complex( iq[ 2 * i ] * scale, iq[ 2 * i + 1 ] * scale );
+
+    estimate( out, n, c );
+    apply( c, out, n );
+    return;
+  }
+
+  float *s = (float *)out;
+
+  for (size_t i = 0; i < n; i++) {
+    float si = iq[ 2 * i ] * scale - c.dc_i;
+    float sq = iq[ 2 * i + 1 ] * scale - c.dc_q;
+
+    s[ 2 * i ] = c.gain_i * si;
+    s[ 2 * i + 1 ] = c.gain_q * sq + c.cross * si;
+  }
+}
+
+void iq_corrector::correct( gr_complex *iq, size_t n )
+{
+  correction c;
+
+  if ( begin( c ) )
+    estimate( iq, n, c );
+
+  apply( c, iq, n );
+}
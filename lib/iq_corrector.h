@@ -0,0 +1,101 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_IQ_CORRECTOR_H
+#define OSMOSDR_IQ_CORRECTOR_H
+
+#include <stdint.h>
+
+#include <complex>
+
+#include <boost/thread/mutex.hpp>
+
+#include <gnuradio/gr_complex.h>
+
+#include <osmosdr/api.h>
+
+/*
+ * Removes the DC offset and corrects the IQ imbalance of devices lacking
+ * hardware support for it, while their samples are converted to complex
+ * float. The modes and values follow set_dc_offset_mode(), set_dc_offset(),
+ * set_iq_balance_mode() and set_iq_balance() of osmosdr::source. Manual
+ * values are kept in any mode and take effect in the manual modes.
+ *
+ * The automatic modes estimate the mean and the covariance of I and Q on
+ * one buffer out of every ESTIMATE_EVERY and smooth them with a one pole
+ * IIR filter. The DC offset is the mean, the imbalance is corrected by
+ * making Q orthogonal to I and scaling it to the power of I. All other
+ * buffers are converted and corrected in a single pass of plain float
+ * loops, which the compiler vectorizes.
+ */
+class OSMOSDR_API iq_corrector
+{
+public:
+  iq_corrector();
+
+  void set_dc_offset_mode( int mode );
+  void set_dc_offset( const std::complex<double> &offset );
+
+  /*
+   * The manual balance scales I by 1 + balance.real() and adds the
+   * multiple balance.imag() of I to Q.
+   */
+  void set_iq_balance_mode( int mode );
+  void set_iq_balance( const std::complex<double> &balance );
+
+  /* whether any correction is active, the conversion is plain otherwise */
+  bool enabled();
+
+  /* converts n samples of 8 bit I/Q through lut and corrects them into out */
+  void convert( const unsigned char *iq, size_t n, const float *lut, gr_complex *out );
+
+  /* converts n samples of 16 bit I/Q scaled by scale and corrects them into out */
+  void convert( const int16_t *iq, size_t n, float scale, gr_complex *out );
+
+  /* corrects n samples in place */
+  void correct( gr_complex *iq, size_t n );
+
+private:
+  struct correction
+  {
+    float dc_i, dc_q;
+    float gain_i, gain_q, cross; /* I' = gain_i I, Q' = gain_q Q + cross I */
+  };
+
+  bool begin( correction &c );
+  void estimate( const gr_complex *iq, size_t n, correction &c );
+  static void apply( const correction &c, gr_complex *iq, size_t n );
+
+  boost::mutex _mutex;
+  int _dc_mode;
+  int _iq_mode;
+  correction _corr;
+  std::complex<double> _dc_manual;
+  std::complex<double> _iq_manual;
+  unsigned int _calls;
+
+  /* the smoothed estimates, valid once _estimated is set */
+  bool _estimated;
+  double _mean_i, _mean_q;
+  double _var_i, _var_q, _cov;
+};
+
+#endif // OSMOSDR_IQ_CORRECTOR_H
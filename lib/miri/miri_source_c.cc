@@ -29,9 +29,11 @@
 #endif
 
 #include "miri_source_c.h"
+#include "driver_registry.h"
 #include <gnuradio/io_signature.h>
 
 #include <boost/assign.hpp>
+#include <boost/foreach.hpp>
 #include <boost/format.hpp>
 
 #include <stdexcept>
@@ -84,7 +86,8 @@ miri_source_c::miri_source_c (const std::string &args)
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
     _running(true),
     _auto_gain(false),
-    _skipped(0)
+    _skipped(0),
+    _record_only(false)
 {
   int ret;
   unsigned int dev_index = 0;
@@ -95,6 +98,7 @@ miri_source_c::miri_source_c (const std::string &args)
     dev_index = boost::lexical_cast< unsigned int >( dict["miri"] );
 
   _buf_num = _buf_head = _buf_used = _buf_offset = 0;
+  _samp_in = 0;
   _samp_avail = BUF_SIZE / BYTES_PER_SAMPLE;
 
   if (dict.count("buffers"))
@@ -103,6 +107,9 @@ miri_source_c::miri_source_c (const std::string &args)
   if (0 == _buf_num)
     _buf_num = BUF_NUM;
 
+  if (dict.count("record_only"))
+    _record_only = boost::lexical_cast<bool>( dict["record_only"] );
+
   if ( BUF_NUM != _buf_num ) {
     std::cerr << "Using " << _buf_num << " buffers of size " << BUF_SIZE << "."
               << std::endl;
@@ -134,12 +141,22 @@ miri_source_c::miri_source_c (const std::string &args)
 
   _buf = (unsigned short **) malloc(_buf_num * sizeof(unsigned short *));
   _buf_lens = (unsigned int *) malloc(_buf_num * sizeof(unsigned int));
+  _buf_pos.resize(_buf_num);
 
   if (_buf && _buf_lens) {
     for(unsigned int i = 0; i < _buf_num; ++i)
       _buf[i] = (unsigned short *) malloc(BUF_SIZE);
   }
 
+  if (dict.count("record")) {
+    _recorder.reset( new raw_recorder( dict["record"], "ci16_le",
+                                       BYTES_PER_SAMPLE, "Mirics" ) );
+    _recorder->set_sample_rate( get_sample_rate() );
+    _recorder->set_center_freq( get_center_freq() );
+  } else if (_record_only) {
+    throw std::runtime_error("Parameter 'record_only' requires 'record'.");
+  }
+
   _thread = gr::thread::thread(_mirisdr_wait, this);
 }
 
@@ -181,6 +198,13 @@ void miri_source_c::mirisdr_callback(unsigned char *buf, uint32_t len)
     return;
   }
 
+  if (_recorder) {
+    _recorder->push(buf, len);
+
+    if (_record_only) /* work() stays idle, no conversion takes place */
+      return;
+  }
+
   {
     boost::mutex::scoped_lock lock( _buf_mutex );
 
@@ -190,6 +214,8 @@ void miri_source_c::mirisdr_callback(unsigned char *buf, uint32_t len)
     int buf_tail = (_buf_head + _buf_used) % _buf_num;
     memcpy(_buf[buf_tail], buf, len);
     _buf_lens[buf_tail] = len;
+    _buf_pos[buf_tail] = _samp_in;
+    _samp_in += len / BYTES_PER_SAMPLE;
 
     if (_buf_used == _buf_num) {
       std::cerr << "O" << std::flush;
@@ -202,6 +228,14 @@ void miri_source_c::mirisdr_callback(unsigned char *buf, uint32_t len)
   _buf_cond.notify_one();
 }
 
+/* the position of the first sample of the next transfer */
+uint64_t miri_source_c::samples_received()
+{
+  boost::mutex::scoped_lock lock( _buf_mutex );
+
+  return _samp_in;
+}
+
 void miri_source_c::_mirisdr_wait(miri_source_c *obj)
 {
   obj->mirisdr_wait();
@@ -219,17 +253,33 @@ void miri_source_c::mirisdr_wait()
   _buf_cond.notify_one();
 }
 
+/* converts n samples, correcting them on the way if asked to */
+void miri_source_c::convert( const short *buf, int n, gr_complex *out )
+{
+  if (_corrector.enabled()) {
+    _corrector.convert( (const int16_t *)buf, n, 1.0f/4096.0f, out );
+    return;
+  }
+
+  for (int i = 0; i < n; i++)
+    *out++ = gr_complex( float(*(buf + i * 2 + 0)) * (1.0f/4096.0f),
+                         float(*(buf + i * 2 + 1)) * (1.0f/4096.0f) );
+}
+
 int miri_source_c::work( int noutput_items,
                         gr_vector_const_void_star &input_items,
                         gr_vector_void_star &output_items )
 {
   gr_complex *out = (gr_complex *)output_items[0];
+  uint64_t pos;
 
   {
     boost::mutex::scoped_lock lock( _buf_mutex );
 
     while (_buf_used < 3 && _running) // collect at least 3 buffers
       _buf_cond.wait( lock );
+
+    pos = _buf_pos[_buf_head] + _buf_offset / 2;
   }
 
   if (!_running)
@@ -238,16 +288,14 @@ int miri_source_c::work( int noutput_items,
   short *buf = (short *)_buf[_buf_head] + _buf_offset;
 
   if (noutput_items <= _samp_avail) {
-    for (int i = 0; i < noutput_items; i++)
-      *out++ = gr_complex( float(*(buf + i * 2 + 0)) * (1.0f/4096.0f),
-                           float(*(buf + i * 2 + 1)) * (1.0f/4096.0f) );
+    convert( buf, noutput_items, out );
+    out += noutput_items;
 
     _buf_offset += noutput_items * 2;
     _samp_avail -= noutput_items;
   } else {
-    for (int i = 0; i < _samp_avail; i++)
-      *out++ = gr_complex( float(*(buf + i * 2 + 0)) * (1.0f/4096.0f),
-                           float(*(buf + i * 2 + 1)) * (1.0f/4096.0f) );
+    convert( buf, _samp_avail, out );
+    out += _samp_avail;
 
     {
       boost::mutex::scoped_lock lock( _buf_mutex );
@@ -260,14 +308,16 @@ int miri_source_c::work( int noutput_items,
 
     int remaining = noutput_items - _samp_avail;
 
-    for (int i = 0; i < remaining; i++)
-      *out++ = gr_complex( float(*(buf + i * 2 + 0)) * (1.0f/4096.0f),
-                           float(*(buf + i * 2 + 1)) * (1.0f/4096.0f) );
+    convert( buf, remaining, out );
+    out += remaining;
 
     _buf_offset = remaining * 2;
     _samp_avail = (_buf_lens[_buf_head] / BYTES_PER_SAMPLE) - remaining;
   }
 
+  BOOST_FOREACH( const gr::tag_t &change, _changes.take( pos, noutput_items, nitems_written( 0 ) ) )
+    add_item_tag( 0, change );
+
   return noutput_items;
 }
 
@@ -301,7 +351,15 @@ osmosdr::meta_range_t miri_source_c::get_sample_rates()
 double miri_source_c::set_sample_rate(double rate)
 {
   if (_dev) {
+    double prev_rate = get_sample_rate();
+
     mirisdr_set_sample_rate( _dev, (uint32_t)rate );
+
+    if (get_sample_rate() != prev_rate)
+      _changes.post( "rx_rate", get_sample_rate(), samples_received() );
+
+    if (_recorder)
+      _recorder->set_sample_rate( get_sample_rate() );
   }
 
   return get_sample_rate();
@@ -330,9 +388,18 @@ osmosdr::freq_range_t miri_source_c::get_freq_range( size_t chan )
 
 double miri_source_c::set_center_freq( double freq, size_t chan )
 {
-  if (_dev)
+  if (_dev) {
+    double prev_freq = get_center_freq( chan );
+
     mirisdr_set_center_freq( _dev, (uint32_t)freq );
 
+    if (get_center_freq( chan ) != prev_freq)
+      _changes.post( "rx_freq", get_center_freq( chan ), samples_received() );
+
+    if (_recorder)
+      _recorder->set_center_freq( get_center_freq( chan ) );
+  }
+
   return get_center_freq( chan );
 }
 
@@ -407,7 +474,12 @@ double miri_source_c::set_gain( double gain, size_t chan )
   osmosdr::gain_range_t rf_gains = miri_source_c::get_gain_range( chan );
 
   if (_dev) {
+    double prev_gain = get_gain( chan );
+
     mirisdr_set_tuner_gain( _dev, int(rf_gains.clip(gain) * 10.0) );
+
+    if (get_gain( chan ) != prev_gain)
+      _changes.post( "rx_gain", get_gain( chan ), samples_received() );
   }
 
   return get_gain( chan );
@@ -449,3 +521,26 @@ std::string miri_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+void miri_source_c::set_dc_offset_mode( int mode, size_t chan )
+{
+  _corrector.set_dc_offset_mode( mode );
+}
+
+void miri_source_c::set_dc_offset( const std::complex<double> &offset, size_t chan )
+{
+  _corrector.set_dc_offset( offset );
+}
+
+void miri_source_c::set_iq_balance_mode( int mode, size_t chan )
+{
+  _corrector.set_iq_balance_mode( mode );
+}
+
+void miri_source_c::set_iq_balance( const std::complex<double> &balance, size_t chan )
+{
+  _corrector.set_iq_balance( balance );
+}
+
+OSMOSDR_REGISTER_SOURCE( miri, "miri", PROBE_USB,
+                         make_miri_source_c, miri_source_c::get_devices() );
@@ -27,6 +27,8 @@
 #include <boost/thread/condition_variable.hpp>
 
 #include "source_iface.h"
+#include "iq_corrector.h"
+#include "raw_recorder.h"
 
 class miri_source_c;
 typedef struct mirisdr_dev mirisdr_dev_t;
@@ -90,6 +92,7 @@ private:
   osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
   double set_center_freq( double freq, size_t chan = 0 );
   double get_center_freq( size_t chan = 0 );
+  bool tags_changes() { return true; }
   double set_freq_corr( double ppm, size_t chan = 0 );
   double get_freq_corr( size_t chan = 0 );
 
@@ -107,16 +110,25 @@ private:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  void set_dc_offset_mode( int mode, size_t chan = 0 );
+  void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
+
+  void set_iq_balance_mode( int mode, size_t chan = 0 );
+  void set_iq_balance( const std::complex<double> &balance, size_t chan = 0 );
+
 private:
   static void _mirisdr_callback(unsigned char *buf, uint32_t len, void *ctx);
   void mirisdr_callback(unsigned char *buf, uint32_t len);
   static void _mirisdr_wait(miri_source_c *obj);
   void mirisdr_wait();
+  uint64_t samples_received();
+  void convert( const short *buf, int n, gr_complex *out );
 
   mirisdr_dev_t *_dev;
   gr::thread::thread _thread;
   unsigned short **_buf;
   unsigned int *_buf_lens;
+  std::vector< uint64_t > _buf_pos; /* position of the first sample of each */
   unsigned int _buf_num;
   unsigned int _buf_head;
   unsigned int _buf_used;
@@ -126,9 +138,17 @@ private:
 
   unsigned int _buf_offset;
   int _samp_avail;
+  uint64_t _samp_in; /* samples put into the buffers since opening */
+
+  iq_corrector _corrector;
 
   bool _auto_gain;
   unsigned int _skipped;
+
+  boost::shared_ptr<raw_recorder> _recorder;
+  bool _record_only;
+
+  change_tags _changes;
 };
 
 #endif /* INCLUDED_MIRI_SOURCE_C_H */
@@ -0,0 +1,138 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <gnuradio/io_signature.h>
+
+#include <volk/volk.h>
+
+#include "nco_cc.h"
+
+nco_cc_sptr make_nco_cc()
+{
+  return gnuradio::get_initial_sptr( new nco_cc() );
+}
+
+nco_cc::nco_cc() :
+  gr::sync_block( "nco_cc",
+                  gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+                  gr::io_signature::make( 1, 1, sizeof(gr_complex) ) ),
+  _offset( 0 ),
+  _rate( 0 ),
+  _freq( 0 ),
+  _phase( 1, 0 ),
+  _increment( 1, 0 ),
+  _tag( false ),
+  _reset( false )
+{
+  const int alignment_multiple = volk_get_alignment() / sizeof(gr_complex);
+  set_alignment( std::max( 1, alignment_multiple ) );
+}
+
+int nco_cc::work( int noutput_items,
+                  gr_vector_const_void_star &input_items,
+                  gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  gr_complex *out = (gr_complex *) output_items[0];
+
+  gr_complex increment;
+
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    if ( _reset ) {
+      _phase = gr_complex( 1, 0 );
+      _reset = false;
+    }
+
+    if ( _tag ) {
+      add_item_tag( 0, nitems_written( 0 ), pmt::mp("rx_freq"),
+                    pmt::from_double( _freq ) );
+      _tag = false;
+    }
+
+    increment = _increment;
+  }
+
+  if ( increment == gr_complex( 1, 0 ) && _phase == gr_complex( 1, 0 ) ) {
+    memcpy( out, in, noutput_items * sizeof(gr_complex) );
+    return noutput_items;
+  }
+
+  /* the rotator keeps _phase normalized across calls */
+  volk_32fc_s32fc_x2_rotator_32fc( out, in, increment, &_phase, noutput_items );
+
+  return noutput_items;
+}
+
+void nco_cc::set_offset( double offset, double freq )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _offset = offset;
+  _freq = freq;
+  _tag = true;
+
+  update_increment();
+}
+
+double nco_cc::get_offset()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  return _offset;
+}
+
+void nco_cc::reset()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _offset = 0;
+  _reset = true;
+
+  update_increment();
+}
+
+void nco_cc::set_sample_rate( double rate )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _rate = rate;
+
+  update_increment();
+}
+
+void nco_cc::update_increment()
+{
+  if ( _offset == 0 || _rate <= 0 ) {
+    _increment = gr_complex( 1, 0 );
+    return;
+  }
+
+  /* mixes the channel down from offset to 0 Hz */
+  double step = -2.0 * M_PI * _offset / _rate;
+  _increment = gr_complex( std::cos( step ), std::sin( step ) );
+}
@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_NCO_CC_H
+#define OSMOSDR_NCO_CC_H
+
+#include <gnuradio/sync_block.h>
+
+#include <boost/thread/mutex.hpp>
+
+class nco_cc;
+
+typedef boost::shared_ptr< nco_cc > nco_cc_sptr;
+
+nco_cc_sptr make_nco_cc();
+
+/*!
+ * \brief Fine-tunes a channel inside the captured bandwidth.
+ *
+ * Mixes the samples down by an offset from the frequency the hardware is
+ * tuned to, so retunes within the passband don't touch the PLL. The phase
+ * of the oscillator carries over offset changes and the first sample mixed
+ * with a new offset is tagged with rx_freq.
+ */
+class nco_cc : public gr::sync_block
+{
+private:
+  friend nco_cc_sptr make_nco_cc();
+
+  nco_cc();
+
+public:
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  /* moves the channel to offset Hz above the hardware, reached at freq */
+  void set_offset( double offset, double freq );
+  double get_offset();
+
+  /* the hardware was retuned to the channel, nothing left to mix */
+  void reset();
+
+  void set_sample_rate( double rate );
+
+private:
+  void update_increment();
+
+  boost::mutex _mutex;
+  double _offset;
+  double _rate;
+  double _freq;
+
+  gr_complex _phase;
+  gr_complex _increment;
+  bool _tag;   /* a new offset waits for its tag */
+  bool _reset; /* the phase starts over with the next sample */
+};
+
+#endif // OSMOSDR_NCO_CC_H
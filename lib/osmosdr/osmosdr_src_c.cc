@@ -28,6 +28,7 @@
 #endif
 
 #include "osmosdr_src_c.h"
+#include "driver_registry.h"
 #include <gnuradio/io_signature.h>
 
 #include <boost/assign.hpp>
@@ -35,6 +36,7 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 #include <stdio.h>
 
 #include <osmosdr.h>
@@ -71,7 +73,8 @@ osmosdr_src_c::osmosdr_src_c (const std::string &args)
     _running(true),
     _auto_gain(false),
     _if_gain(0),
-    _skipped(0)
+    _skipped(0),
+    _record_only(false)
 {
   int ret;
   unsigned int dev_index = 0;
@@ -89,6 +92,12 @@ osmosdr_src_c::osmosdr_src_c (const std::string &args)
   if (dict.count("buflen"))
     _buf_len = boost::lexical_cast< unsigned int >( dict["buflen"] );
 
+  if (dict.count("record_only"))
+    _record_only = boost::lexical_cast<bool>( dict["record_only"] );
+
+  if (dict.count("decim"))
+    _decim.set_decimation( parse_decimation( dict["decim"] ) );
+
   if (0 == _buf_num)
     _buf_num = BUF_NUM;
 
@@ -139,6 +148,15 @@ osmosdr_src_c::osmosdr_src_c (const std::string &args)
       _buf[i] = (unsigned short *) malloc(_buf_len);
   }
 
+  if (dict.count("record")) {
+    _recorder.reset( new raw_recorder( dict["record"], "ci16_le",
+                                       BYTES_PER_SAMPLE, "OsmoSDR" ) );
+    _recorder->set_sample_rate( osmosdr_get_sample_rate( _dev ) );
+    _recorder->set_center_freq( get_center_freq() );
+  } else if (_record_only) {
+    throw std::runtime_error("Parameter 'record_only' requires 'record'.");
+  }
+
   _thread = gr::thread::thread(_osmosdr_wait, this);
 }
 
@@ -178,6 +196,13 @@ void osmosdr_src_c::osmosdr_callback(unsigned char *buf, uint32_t len)
     return;
   }
 
+  if (_recorder) {
+    _recorder->push(buf, len);
+
+    if (_record_only) /* work() stays idle, no conversion takes place */
+      return;
+  }
+
   {
     boost::mutex::scoped_lock lock( _buf_mutex );
 
@@ -217,6 +242,7 @@ int osmosdr_src_c::work( int noutput_items,
                         gr_vector_void_star &output_items )
 {
   gr_complex *out = (gr_complex *)output_items[0];
+  const int decim = _decim.get_decimation();
 
   {
     boost::mutex::scoped_lock lock( _buf_mutex );
@@ -230,7 +256,38 @@ int osmosdr_src_c::work( int noutput_items,
 
   short *buf = (short *)_buf[_buf_head] + _buf_offset;
 
-  if (noutput_items <= _samp_avail) {
+  if (decim > 1) {
+    int produced = 0;
+
+    while (produced < noutput_items && _buf_used) {
+      /* whole multiples of the decimation leave exactly nin / decim */
+      int nin = std::min((noutput_items - produced) * decim, _samp_avail);
+      if (nin > decim)
+        nin -= nin % decim;
+
+      /* the samples are decimated in place, they are consumed anyway */
+      int n = _decim.decimate( (int16_t *)buf, nin );
+      halfband_decim::to_complex( (int16_t *)buf, n, out + produced, 32767.5f );
+      produced += n;
+
+      _buf_offset += nin * 2;
+      _samp_avail -= nin;
+
+      if (!_samp_avail) {
+        boost::mutex::scoped_lock lock( _buf_mutex );
+
+        _buf_head = (_buf_head + 1) % _buf_num;
+        _buf_used--;
+
+        _buf_offset = 0;
+        _samp_avail = _buf_len / BYTES_PER_SAMPLE;
+      }
+
+      buf = (short *)_buf[_buf_head] + _buf_offset;
+    }
+
+    noutput_items = produced;
+  } else if (noutput_items <= _samp_avail) {
     for (int i = 0; i < noutput_items; i++)
        *out++ = gr_complex( float(*(buf + i * 2 + 0)) * (1.0f/32767.5f),
                             float(*(buf + i * 2 + 1)) * (1.0f/32767.5f) );
@@ -309,13 +366,17 @@ osmosdr::meta_range_t osmosdr_src_c::get_sample_rates()
     }
   }
 
-  return range;
+  return decimate_rates( range, _decim.get_decimation() );
 }
 
 double osmosdr_src_c::set_sample_rate(double rate)
 {
   if (_dev) {
-    osmosdr_set_sample_rate( _dev, (uint32_t)rate );
+    /* the device runs at the rate before decimation */
+    osmosdr_set_sample_rate( _dev, (uint32_t)(rate * _decim.get_decimation()) );
+
+    if (_recorder)
+      _recorder->set_sample_rate( osmosdr_get_sample_rate( _dev ) );
   }
 
   return get_sample_rate();
@@ -324,7 +385,7 @@ double osmosdr_src_c::set_sample_rate(double rate)
 double osmosdr_src_c::get_sample_rate()
 {
   if (_dev)
-    return (double)osmosdr_get_sample_rate( _dev );
+    return (double)osmosdr_get_sample_rate( _dev ) / _decim.get_decimation();
 
   return 0;
 }
@@ -341,9 +402,13 @@ osmosdr::freq_range_t osmosdr_src_c::get_freq_range( size_t chan )
 
 double osmosdr_src_c::set_center_freq( double freq, size_t chan )
 {
-  if (_dev)
+  if (_dev) {
     osmosdr_set_center_freq( _dev, (uint32_t)freq );
 
+    if (_recorder)
+      _recorder->set_center_freq( get_center_freq( chan ) );
+  }
+
   return get_center_freq( chan );
 }
 
@@ -530,4 +595,7 @@ std::string osmosdr_src_c::set_antenna( const std::string & antenna, size_t chan
 std::string osmosdr_src_c::get_antenna( size_t chan )
 {
   return "RX";
-}
\ No newline at end of file
+}
+
+OSMOSDR_REGISTER_SOURCE( osmosdr, "osmosdr", PROBE_USB,
+                         osmosdr_make_src_c, osmosdr_src_c::get_devices() );
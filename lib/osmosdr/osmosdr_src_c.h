@@ -27,6 +27,8 @@
 #include <boost/thread/condition_variable.hpp>
 
 #include "source_iface.h"
+#include "raw_recorder.h"
+#include "halfband_decim.h"
 
 class osmosdr_src_c;
 typedef struct osmosdr_dev osmosdr_dev_t;
@@ -131,9 +133,14 @@ private:
   unsigned int _buf_offset;
   int _samp_avail;
 
+  halfband_decim _decim;
+
   bool _auto_gain;
   double _if_gain;
   unsigned int _skipped;
+
+  boost::shared_ptr<raw_recorder> _recorder;
+  bool _record_only;
 };
 
 #endif /* INCLUDED_OSMOSDR_SRC_C_H */
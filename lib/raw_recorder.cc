@@ -0,0 +1,348 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "raw_recorder.h"
+
+#ifndef GR_OSMOSDR_VERSION
+#define GR_OSMOSDR_VERSION "unknown"
+#endif
+
+/* queued in place of a buffer, the writer goes on with the next recording */
+#define NEXT_RECORDING size_t(-1)
+
+static std::string now_datetime()
+{
+  char datetime[32];
+  time_t now = time(NULL);
+  strftime( datetime, sizeof(datetime), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now) );
+  return datetime;
+}
+
+/* for a JSON string */
+static std::string escape( const std::string &s )
+{
+  std::string out;
+
+  BOOST_FOREACH( char c, s ) {
+    if ( '"' == c || '\\' == c )
+      out += '\\';
+
+    if ( (unsigned char)c < 0x20 )
+      out += str( boost::format( "\\u%04x" ) % int(c) );
+    else
+      out += c;
+  }
+
+  return out;
+}
+
+raw_recorder::raw_recorder( const std::string &path,
+                            const std::string &datatype,
+                            size_t sample_size,
+                            const std::string &hw,
+                            size_t buf_num )
+  : _path(path),
+    _datatype(datatype),
+    _sample_size(sample_size),
+    _hw(hw),
+    _file(NULL),
+    _running(true),
+    _failed(false),
+    _samples(0),
+    _dropped(0),
+    _parts(0)
+{
+  if ( 0 == _sample_size )
+    throw std::runtime_error("Invalid sample size for raw recording.");
+
+  _file = fopen( _path.c_str(), "wb" );
+  if ( ! _file )
+    throw std::runtime_error( "Failed to open '" + _path + "' for recording: " +
+                              strerror(errno) );
+
+  recording rec;
+  rec.path = _path;
+  rec.datetime = now_datetime();
+  rec.sample_rate = 0;
+  rec.start = 0;
+  _recordings.push_back( rec );
+
+  _bufs.resize( buf_num );
+  _lens.resize( buf_num, 0 );
+  for (size_t i = 0; i < buf_num; i++)
+    _free.push_back( i );
+
+  std::cerr << "Recording " << _datatype << " samples to " << _path << std::endl;
+
+  _thread = boost::thread(_writer, this);
+}
+
+raw_recorder::~raw_recorder()
+{
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+    _running = false;
+  }
+  _cond.notify_one();
+  _thread.join();
+
+  if (_file) {
+    fclose( _file );
+    _file = NULL;
+  }
+
+  if (_dropped)
+    std::cerr << "Recording dropped " << _dropped << " transfers." << std::endl;
+
+  /* the writer leaves the ones it didn't get to, nothing of them was written */
+  if ( ! _recordings.empty() )
+    write_meta( _recordings.front() );
+}
+
+void raw_recorder::push( const void *buf, size_t len )
+{
+  if ( ! len )
+    return;
+
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    if ( _failed )
+      return;
+
+    if ( _free.empty() ) {
+      _dropped++;
+      std::cerr << "D" << std::flush;
+      return;
+    }
+
+    size_t idx = _free.front();
+    _free.pop_front();
+
+    /* buffers grow to the largest transfer seen and stay allocated */
+    if ( _bufs[idx].size() < len )
+      _bufs[idx].resize( len );
+
+    memcpy( &_bufs[idx][0], buf, len );
+    _lens[idx] = len;
+    _filled.push_back( idx );
+    _samples += len / _sample_size;
+  }
+
+  _cond.notify_one();
+}
+
+std::string raw_recorder::part_path( unsigned int part )
+{
+  std::string suffix = "-" + boost::lexical_cast< std::string >( part );
+
+  if ( boost::algorithm::ends_with( _path, ".sigmf-data" ) )
+    return _path.substr( 0, _path.size() - 11 ) + suffix + ".sigmf-data";
+
+  return _path + suffix;
+}
+
+void raw_recorder::set_sample_rate( double rate )
+{
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    if ( _failed )
+      return;
+
+    recording &last = _recordings.back();
+
+    if ( rate == last.sample_rate )
+      return;
+
+    if ( _samples == last.start ) { /* nothing recorded at the old rate yet */
+      last.sample_rate = rate;
+      return;
+    }
+
+    recording rec;
+    rec.path = part_path( ++_parts );
+    rec.datetime = now_datetime();
+    rec.sample_rate = rate;
+    rec.start = _samples;
+    if ( ! last.captures.empty() )
+      rec.captures.push_back( std::make_pair( _samples, last.captures.back().second ) );
+
+    _recordings.push_back( rec );
+    _filled.push_back( NEXT_RECORDING );
+  }
+
+  _cond.notify_one();
+}
+
+void raw_recorder::set_center_freq( double freq )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( _failed )
+    return;
+
+  std::vector< std::pair< uint64_t, double > > &captures = _recordings.back().captures;
+
+  /* a new capture segment starts with the next transfer */
+  if ( ! captures.empty() && captures.back().first == _samples )
+    captures.back().second = freq;
+  else
+    captures.push_back( std::make_pair( _samples, freq ) );
+}
+
+uint64_t raw_recorder::get_dropped()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+  return _dropped;
+}
+
+void raw_recorder::_writer(raw_recorder *obj)
+{
+  obj->writer();
+}
+
+/*
+ * Stops recording for good, reported once. The buffers queued are returned
+ * so push() finds them free, it drops everything quietly from now on.
+ * Called by the writer with _mutex held.
+ */
+void raw_recorder::fail( const std::string &what )
+{
+  std::cerr << "Failed to " << what << ", recording stopped: "
+            << strerror(errno) << std::endl;
+
+  _failed = true;
+
+  BOOST_FOREACH( size_t idx, _filled )
+    if ( NEXT_RECORDING != idx )
+      _free.push_back( idx );
+
+  _filled.clear();
+}
+
+void raw_recorder::writer()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  while ( ! _failed ) {
+    while ( _filled.empty() && _running )
+      _cond.wait( lock );
+
+    if ( _filled.empty() )
+      break; /* drained and stopped */
+
+    size_t idx = _filled.front();
+    _filled.pop_front();
+
+    if ( NEXT_RECORDING == idx ) {
+      recording done = _recordings.front();
+      _recordings.pop_front();
+      std::string path = _recordings.front().path;
+
+      lock.unlock();
+      fclose( _file );
+      write_meta( done );
+      _file = fopen( path.c_str(), "wb" );
+      lock.lock();
+
+      if ( ! _file ) {
+        fail( "open '" + path + "'" );
+        _recordings.clear(); /* there is no data to describe */
+        break;
+      }
+
+      std::cerr << "Recording continues in " << path << std::endl;
+      continue;
+    }
+
+    lock.unlock();
+    size_t written = fwrite( &_bufs[idx][0], 1, _lens[idx], _file );
+    lock.lock();
+
+    _free.push_back( idx );
+
+    if ( written != _lens[idx] )
+      fail( "write to '" + _recordings.front().path + "'" );
+  }
+}
+
+void raw_recorder::write_meta( const recording &rec )
+{
+  std::string meta_path = rec.path;
+
+  if ( boost::algorithm::ends_with( meta_path, ".sigmf-data" ) )
+    meta_path.replace( meta_path.size() - 4, 4, "meta" );
+  else
+    meta_path += ".sigmf-meta";
+
+  std::ofstream meta( meta_path.c_str() );
+  if ( ! meta.good() ) {
+    std::cerr << "Failed to write SigMF metadata to " << meta_path << std::endl;
+    return;
+  }
+
+  meta << "{\n"
+       << "  \"global\": {\n"
+       << "    \"core:datatype\": \"" << _datatype << "\",\n"
+       << "    \"core:sample_rate\": " << boost::format("%.1f") % rec.sample_rate << ",\n"
+       << "    \"core:hw\": \"" << escape( _hw ) << "\",\n"
+       << "    \"core:recorder\": \"gr-osmosdr " << GR_OSMOSDR_VERSION << "\",\n"
+       << "    \"core:version\": \"1.0.0\"\n"
+       << "  },\n"
+       << "  \"captures\": [";
+
+  std::vector< std::pair< uint64_t, double > > captures = rec.captures;
+  if ( captures.empty() )
+    captures.push_back( std::make_pair( rec.start, 0.0 ) );
+
+  for (size_t i = 0; i < captures.size(); i++) {
+    meta << (i ? ",\n" : "\n")
+         << "    {\n"
+         << "      \"core:sample_start\": " << captures[i].first - rec.start << ",\n";
+    if ( 0 == i )
+      meta << "      \"core:datetime\": \"" << rec.datetime << "\",\n";
+    meta << "      \"core:frequency\": "
+         << boost::format("%.1f") % captures[i].second << "\n"
+         << "    }";
+  }
+
+  meta << "\n  ],\n"
+       << "  \"annotations\": []\n"
+       << "}\n";
+}
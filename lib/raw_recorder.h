@@ -0,0 +1,122 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_RAW_RECORDER_H
+#define OSMOSDR_RAW_RECORDER_H
+
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <osmosdr/api.h>
+
+/*!
+ * Writes the native sample buffers of a device to disk.
+ *
+ * The usb callback of a driver hands every transfer to push(), which copies
+ * it into one of a set of preallocated buffers and returns immediately.
+ * A background thread writes the filled buffers to the data file. A SigMF
+ * sidecar (.sigmf-meta) describing the native sample format is written
+ * next to the data file when the recorder is closed.
+ *
+ * SigMF has a single sample rate per recording, so a rate change after the
+ * first samples closes the recording and continues in a new one, numbered
+ * path-1.sigmf-data, path-2.sigmf-data and so on. Recording stops for good
+ * on the first write error.
+ */
+class OSMOSDR_API raw_recorder
+{
+public:
+  /*!
+   * \param path the data file to write
+   * \param datatype SigMF datatype of the native samples, e.g. "cu8"
+   * \param sample_size size of one complex sample in bytes
+   * \param hw a description of the hardware for the metadata
+   * \param buf_num number of transfers which may be queued for writing
+   */
+  raw_recorder( const std::string &path,
+                const std::string &datatype,
+                size_t sample_size,
+                const std::string &hw,
+                size_t buf_num = 32 );
+  ~raw_recorder();
+
+  /*!
+   * Queue a native transfer buffer for writing. Never blocks, the buffer
+   * is dropped (and counted) if the writer can't keep up.
+   */
+  void push( const void *buf, size_t len );
+
+  /* a change after the first samples starts a new recording */
+  void set_sample_rate( double rate );
+  void set_center_freq( double freq );
+
+  uint64_t get_dropped();
+
+private:
+  struct recording
+  {
+    std::string path;
+    std::string datetime;
+    double sample_rate;
+    uint64_t start; /* of its first sample in _samples */
+    std::vector< std::pair< uint64_t, double > > captures; /* in _samples */
+  };
+
+  static void _writer(raw_recorder *obj);
+  void writer();
+  void fail( const std::string &what );
+  void write_meta( const recording &rec );
+  std::string part_path( unsigned int part );
+
+  std::string _path;
+  std::string _datatype;
+  size_t _sample_size;
+  std::string _hw;
+
+  FILE *_file;
+  boost::thread _thread;
+  boost::mutex _mutex;
+  boost::condition_variable _cond;
+  bool _running;
+  bool _failed;
+
+  std::vector< std::vector<unsigned char> > _bufs;
+  std::vector< size_t > _lens;
+  std::deque< size_t > _free;
+  std::deque< size_t > _filled;
+
+  uint64_t _samples; /* samples handed to the writer so far */
+  uint64_t _dropped;
+
+  /* the one being written first, the one being filled last */
+  std::deque< recording > _recordings;
+  unsigned int _parts;
+};
+
+#endif // OSMOSDR_RAW_RECORDER_H
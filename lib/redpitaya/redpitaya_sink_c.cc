@@ -33,6 +33,7 @@
 #include "arg_helpers.h"
 
 #include "redpitaya_sink_c.h"
+#include "driver_registry.h"
 
 using namespace boost::assign;
 
@@ -295,3 +296,6 @@ std::string redpitaya_sink_c::get_antenna( size_t chan )
 {
   return "TX";
 }
+
+OSMOSDR_REGISTER_SINK( redpitaya, "redpitaya", PROBE_SOFTWARE,
+                         make_redpitaya_sink_c, redpitaya_sink_c::get_devices( fake ) );
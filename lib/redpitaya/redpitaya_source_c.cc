@@ -33,6 +33,7 @@
 #include "arg_helpers.h"
 
 #include "redpitaya_source_c.h"
+#include "driver_registry.h"
 
 using namespace boost::assign;
 
@@ -285,3 +286,6 @@ std::string redpitaya_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+OSMOSDR_REGISTER_SOURCE( redpitaya, "redpitaya", PROBE_SOFTWARE,
+                         make_redpitaya_source_c, redpitaya_source_c::get_devices( fake ) );
@@ -0,0 +1,228 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <gnuradio/io_signature.h>
+
+#include <volk/volk.h>
+
+#include <boost/foreach.hpp>
+
+#include "resampler_cc.h"
+
+/* phases of the filterbank, the rest is interpolated */
+#define NUM_PHASES 32
+
+double pick_native_rate( const osmosdr::meta_range_t &rates, double rate )
+{
+  double best = 0, highest = 0;
+
+  BOOST_FOREACH( const osmosdr::range_t &range, rates ) {
+    highest = std::max( highest, range.stop() );
+
+    if ( range.stop() < rate )
+      continue;
+
+    double candidate = range.start();
+    if ( rate > range.start() ) {
+      candidate = rate;
+      if ( range.step() > 0 )
+        candidate = std::min( range.stop(), range.start() +
+                              std::ceil( (rate - range.start()) / range.step() ) * range.step() );
+    }
+
+    if ( best == 0 || candidate < best )
+      best = candidate;
+  }
+
+  return best > 0 ? best : highest;
+}
+
+bool parse_rate_mode( const std::string &mode )
+{
+  if ( mode == "exact" )
+    return true;
+
+  if ( mode == "native" )
+    return false;
+
+  throw std::runtime_error( "Unknown rate_mode '" + mode + "', expected native or exact." );
+}
+
+resampler_cc_sptr make_resampler_cc()
+{
+  return gnuradio::get_initial_sptr( new resampler_cc() );
+}
+
+resampler_cc::resampler_cc() :
+  gr::block( "resampler_cc",
+             gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+             gr::io_signature::make( 1, 1, sizeof(gr_complex) ) ),
+  _in_rate( 0 ),
+  _out_rate( 0 ),
+  _redesign( false ),
+  _step( 1 ),
+  _pos( 0 ),
+  _ntaps( 1 ),
+  _tag( false )
+{
+  /* the offsets of the tags are moved along with the rate */
+  set_tag_propagation_policy( TPP_DONT );
+}
+
+void resampler_cc::set_rates( double in_rate, double out_rate )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( in_rate == _in_rate && out_rate == _out_rate )
+    return;
+
+  _in_rate = in_rate;
+  _out_rate = out_rate;
+  _redesign = true;
+}
+
+double resampler_cc::get_out_rate()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  return _out_rate;
+}
+
+/*
+ * Windowed sinc low pass cutting off below the lower of both rates, split
+ * into NUM_PHASES + 1 phases so the last one closes the gap to the next
+ * input sample. Called with _mutex held.
+ */
+void resampler_cc::design()
+{
+  _redesign = false;
+  _tag = _out_rate > 0;
+  _step = 1;
+  _ntaps = 1;
+  _phases.clear();
+
+  if ( _in_rate <= 0 || _out_rate <= 0 || _in_rate == _out_rate )
+    return;
+
+  _step = _in_rate / _out_rate;
+
+  /* pass 80 % of the narrower band, with a blackman window */
+  double ratio = std::min( 1.0, _out_rate / _in_rate );
+  double cutoff = 0.45 * ratio;
+  double transition = 0.1 * ratio;
+  _ntaps = size_t( std::ceil( 5.5 / transition ) ) | 1;
+
+  size_t length = NUM_PHASES * _ntaps + 1;
+  std::vector< double > prototype( length );
+  double center = (length - 1) / 2.0, sum = 0;
+
+  for (size_t m = 0; m < length; m++) {
+    double t = (m - center) / NUM_PHASES;
+    double tap = t == 0 ? 2 * cutoff : std::sin( 2 * M_PI * cutoff * t ) / (M_PI * t);
+    tap *= 0.42 - 0.5 * std::cos( 2 * M_PI * m / (length - 1) ) +
+           0.08 * std::cos( 4 * M_PI * m / (length - 1) );
+    prototype[m] = tap;
+    sum += tap;
+  }
+
+  _phases.resize( NUM_PHASES + 1, std::vector< float >( _ntaps ) );
+
+  for (size_t p = 0; p <= NUM_PHASES; p++)
+    for (size_t t = 0; t < _ntaps; t++)
+      _phases[p][t] = prototype[ NUM_PHASES * (_ntaps - 1 - t) + p ] * NUM_PHASES / sum;
+}
+
+void resampler_cc::forecast( int noutput_items, gr_vector_int &ninput_items_required )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  ninput_items_required[0] = int( std::ceil( _pos + noutput_items * _step ) ) + _ntaps;
+}
+
+int resampler_cc::general_work( int noutput_items,
+                                gr_vector_int &ninput_items,
+                                gr_vector_const_void_star &input_items,
+                                gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  gr_complex *out = (gr_complex *) output_items[0];
+
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( _redesign )
+    design();
+
+  if ( _tag ) {
+    add_item_tag( 0, nitems_written( 0 ), pmt::mp("rx_rate"),
+                  pmt::from_double( _out_rate ) );
+    _tag = false;
+  }
+
+  int produced = 0, consumed = 0;
+
+  if ( _phases.empty() ) {
+    produced = consumed = std::min( noutput_items, ninput_items[0] );
+    memcpy( out, in, produced * sizeof(gr_complex) );
+  } else {
+    while ( produced < noutput_items ) {
+      size_t i = size_t( _pos );
+      if ( i + _ntaps > size_t( ninput_items[0] ) )
+        break;
+
+      double phase = (_pos - i) * NUM_PHASES;
+      size_t p = size_t( phase );
+      float a = phase - p;
+      gr_complex y0, y1;
+
+      volk_32fc_32f_dot_prod_32fc( &y0, in + i, &_phases[p][0], _ntaps );
+      volk_32fc_32f_dot_prod_32fc( &y1, in + i, &_phases[p + 1][0], _ntaps );
+
+      out[ produced++ ] = y0 + a * (y1 - y0);
+      _pos += _step;
+    }
+
+    consumed = int( _pos );
+    _pos -= consumed;
+  }
+
+  std::vector< gr::tag_t > tags;
+  uint64_t start = nitems_read( 0 );
+  get_tags_in_range( tags, 0, start, start + consumed );
+
+  BOOST_FOREACH( gr::tag_t tag, tags ) {
+    if ( pmt::eq( tag.key, pmt::mp("rx_rate") ) && _out_rate > 0 )
+      tag.value = pmt::from_double( _out_rate );
+
+    tag.offset = nitems_written( 0 ) +
+                 std::min< uint64_t >( produced, uint64_t( (tag.offset - start) / _step ) );
+    add_item_tag( 0, tag );
+  }
+
+  consume_each( consumed );
+
+  return produced;
+}
@@ -0,0 +1,90 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_RESAMPLER_CC_H
+#define OSMOSDR_RESAMPLER_CC_H
+
+#include <string>
+#include <vector>
+
+#include <gnuradio/block.h>
+
+#include <boost/thread/mutex.hpp>
+
+#include <osmosdr/ranges.h>
+
+/*
+ * The rate of rates to run a device at to get rate out of a resampler:
+ * the lowest one at or above rate, or the highest one if all are below.
+ */
+double pick_native_rate( const osmosdr::meta_range_t &rates, double rate );
+
+/* true for the rate_mode "exact", false for "native" */
+bool parse_rate_mode( const std::string &mode );
+
+class resampler_cc;
+
+typedef boost::shared_ptr< resampler_cc > resampler_cc_sptr;
+
+resampler_cc_sptr make_resampler_cc();
+
+/*!
+ * \brief Converts between the rate of a device and the one asked for.
+ *
+ * A polyphase filterbank interpolating linearly between its phases, so any
+ * ratio works. Equal rates pass the samples unchanged. The first sample
+ * after a rate change and every rx_rate tag coming in are tagged with the
+ * output rate.
+ */
+class resampler_cc : public gr::block
+{
+private:
+  friend resampler_cc_sptr make_resampler_cc();
+
+  resampler_cc();
+
+public:
+  void set_rates( double in_rate, double out_rate );
+  double get_out_rate();
+
+  void forecast( int noutput_items, gr_vector_int &ninput_items_required );
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+private:
+  void design();
+
+  boost::mutex _mutex;
+  double _in_rate;
+  double _out_rate;
+  bool _redesign;
+
+  double _step;  /* input samples per output sample */
+  double _pos;   /* of the next output, relative to the first unconsumed input */
+  size_t _ntaps; /* per phase */
+  std::vector< std::vector< float > > _phases;
+  bool _tag;
+};
+
+#endif // OSMOSDR_RESAMPLER_CC_H
@@ -51,6 +51,7 @@
 #include <cerrno>
 
 #include <boost/assign.hpp>
+#include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
@@ -62,6 +63,7 @@
 
 #include "arg_helpers.h"
 #include "rfspace_source_c.h"
+#include "driver_registry.h"
 
 using namespace boost::assign;
 #ifdef USE_ASIO
@@ -118,7 +120,8 @@ rfspace_source_c::rfspace_source_c (const std::string &args)
     _nchan(1),
     _sample_rate(NAN),
     _bandwidth(0.0f),
-    _fifo(NULL)
+    _fifo(NULL),
+    _samp_in(0)
 {
   std::string host = "";
   unsigned short port = 0;
@@ -714,6 +717,7 @@ void rfspace_source_c::usb_read_task()
         /* Push sample to the fifo */
         _fifo->push_back( gr_complex( *(sample+0) * SCALE_16,
                                       *(sample+1) * SCALE_16 ) );
+        _samp_in++;
 
         /* offset to the next I+Q sample */
         sample += 2;
@@ -813,6 +817,14 @@ bool rfspace_source_c::stop()
   return transaction( stop, sizeof(stop) );
 }
 
+/* the position of the first sample of the next packet */
+uint64_t rfspace_source_c::samples_received()
+{
+  boost::mutex::scoped_lock lock( _fifo_lock );
+
+  return _samp_in;
+}
+
 /* Main work function, pull samples from the socket */
 int rfspace_source_c::work( int noutput_items,
                            gr_vector_const_void_star &input_items,
@@ -840,12 +852,17 @@ int rfspace_source_c::work( int noutput_items,
         n_samples_avail = _fifo->size();
       }
 
+      uint64_t pos = _samp_in - n_samples_avail;
+
       for ( int i = 0; i < noutput_items; ++i )
       {
         out[i] = _fifo->at(0);
         _fifo->pop_front();
       }
 
+      BOOST_FOREACH( const gr::tag_t &change, _changes[0].take( pos, noutput_items, nitems_written( 0 ) ) )
+        add_item_tag( 0, change );
+
 //      std::cerr << "-" << std::flush;
     }
 
@@ -902,6 +919,8 @@ int rfspace_source_c::work( int noutput_items,
 
   _sequence = (0xffff == sequence) ? 0 : sequence;
 
+  uint16_t lost = diff > 1 ? diff - 1 : 0;
+
   /* get pointer to samples */
   int16_t *sample = (int16_t *)(data + HEADER_SIZE + SEQNUM_SIZE);
 
@@ -940,6 +959,21 @@ int rfspace_source_c::work( int noutput_items,
 
   #undef SCALE_16
 
+  uint64_t pos;
+
+  {
+    boost::mutex::scoped_lock lock( _fifo_lock );
+
+    /* assume the packets lost were as long as this one */
+    _samp_in += lost * rx_samples;
+    pos = _samp_in;
+    _samp_in += rx_samples;
+  }
+
+  for ( size_t chan = 0; chan < _nchan; chan++ )
+    BOOST_FOREACH( const gr::tag_t &change, _changes[chan].take( pos, rx_samples, nitems_written( chan ) ) )
+      add_item_tag( chan, change );
+
   noutput_items = rx_samples;
 
   return noutput_items;
@@ -1470,6 +1504,9 @@ double rfspace_source_c::set_sample_rate( double rate )
     std::cerr << "Radio reported a sample rate of " << (uint32_t)_sample_rate << " Hz"
               << std::endl;
 
+  for ( size_t chan = 0; chan < _nchan; chan++ )
+    _changes[chan].post( "rx_rate", _sample_rate, samples_received() );
+
   return get_sample_rate();
 }
 
@@ -1541,7 +1578,12 @@ double rfspace_source_c::set_center_freq( double freq, size_t chan )
 
   transaction( tune, sizeof(tune) );
 
-  return get_center_freq( chan );
+  double actual = get_center_freq( chan );
+
+  if ( chan < _nchan )
+    _changes[chan].post( "rx_freq", actual, samples_received() );
+
+  return actual;
 }
 
 double rfspace_source_c::get_center_freq( size_t chan )
@@ -1643,7 +1685,12 @@ double rfspace_source_c::set_gain( double gain, size_t chan )
 
   transaction( atten, sizeof(atten) );
 
-  return get_gain( chan );
+  double actual = get_gain( chan );
+
+  if ( chan < _nchan )
+    _changes[chan].post( "rx_gain", actual, samples_received() );
+
+  return actual;
 }
 
 double rfspace_source_c::set_gain( double gain, const std::string & name, size_t chan )
@@ -1746,3 +1793,6 @@ osmosdr::freq_range_t rfspace_source_c::get_bandwidth_range( size_t chan )
 
   return bandwidths;
 }
+
+OSMOSDR_REGISTER_SOURCE( rfspace, "rfspace sdr-iq sdr-ip netsdr cloudiq", PROBE_NETWORK,
+                         make_rfspace_source_c, rfspace_source_c::get_devices( fake ) );
@@ -99,6 +99,7 @@ public:
   osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
   double set_center_freq( double freq, size_t chan = 0 );
   double get_center_freq( size_t chan = 0 );
+  bool tags_changes() { return true; }
   double set_freq_corr( double ppm, size_t chan = 0 );
   double get_freq_corr( size_t chan = 0 );
 
@@ -130,6 +131,7 @@ private: /* functions */
 
   void usb_read_task();
   void tcp_keepalive_task();
+  uint64_t samples_received();
 
 private: /* members */
   enum radio_type
@@ -169,6 +171,8 @@ private: /* members */
   boost::circular_buffer<gr_complex> *_fifo;
   boost::mutex _fifo_lock;
   boost::condition_variable _samp_avail;
+  uint64_t _samp_in; /* samples received per channel since opening */
+  change_tags _changes[2];
 
   std::vector< unsigned char > _resp;
   boost::mutex _resp_lock;
@@ -28,14 +28,19 @@
 #endif
 
 #include "rtl_source_c.h"
+#include "driver_registry.h"
 #include <gnuradio/io_signature.h>
 
 #include <boost/assign.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/make_shared.hpp>
 
 #include <stdexcept>
 #include <iostream>
+#include <cmath>
 #include <stdio.h>
 
 #include <rtl-sdr.h>
@@ -81,13 +86,17 @@ rtl_source_c::rtl_source_c (const std::string &args)
   : gr::sync_block ("rtl_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
+    _soft_agc(false),
+    _stats(false),
+    _exec(boost::make_shared<device_executor>()),
     _dev(NULL),
     _buf(NULL),
     _running(false),
     _no_tuner(false),
     _auto_gain(false),
     _if_gain(0),
-    _skipped(0)
+    _skipped(0),
+    _record_only(false)
 {
   int ret;
   int index;
@@ -100,6 +109,9 @@ rtl_source_c::rtl_source_c (const std::string &args)
 
   dict_t dict = params_to_dict(args);
 
+  _timer.init( dict, "rtl" );
+  _defaults.init( dict );
+
   if (dict.count("rtl")) {
     std::string value = dict["rtl"];
 
@@ -138,6 +150,10 @@ rtl_source_c::rtl_source_c (const std::string &args)
 
   std::cerr << std::endl;
 
+  _pool_key = strlen(serial) ? "rtl:" + std::string(serial)
+                             : "rtl#" + boost::lexical_cast< std::string >( dev_index );
+  _linger = pool_linger( dict );
+
   if (dict.count("rtl_xtal"))
     rtl_freq = (unsigned int)boost::lexical_cast< double >( dict["rtl_xtal"] );
 
@@ -153,7 +169,20 @@ rtl_source_c::rtl_source_c (const std::string &args)
   if (dict.count("bias"))
     bias_tee = boost::lexical_cast<bool>( dict["bias"] );
 
+  if (dict.count("record_only"))
+    _record_only = boost::lexical_cast<bool>( dict["record_only"] );
+
+  if (dict.count("decim"))
+    _decim.set_decimation( parse_decimation( dict["decim"] ) );
+
+  if (dict.count("soft_agc"))
+    _soft_agc = boost::lexical_cast<bool>( dict["soft_agc"] );
+
+  if (dict.count("stats"))
+    _stats = boost::lexical_cast<bool>( dict["stats"] );
+
   _buf_num = _buf_len = _buf_head = _buf_used = _buf_offset = 0;
+  _samp_in = 0;
 
   if (dict.count("buffers"))
     _buf_num = boost::lexical_cast< unsigned int >( dict["buffers"] );
@@ -175,13 +204,23 @@ rtl_source_c::rtl_source_c (const std::string &args)
   _samp_avail = _buf_len / BYTES_PER_SAMPLE;
 
   // create a lookup table for gr_complex values
-  for (unsigned int i = 0; i < 0x100; i++)
+  for (unsigned int i = 0; i < 0x100; i++) {
     _lut.push_back((i - 127.4f) / 128.0f);
+    _lut16.push_back(int16_t(lrintf((i - 127.4f) / 128.0f * halfband_decim::FULL_SCALE)));
+  }
 
-  _dev = NULL;
-  ret = rtlsdr_open( &_dev, dev_index );
-  if (ret < 0)
-    throw std::runtime_error("Failed to open rtlsdr device.");
+  _dev = (rtlsdr_dev_t *)device_pool::instance().claim( _pool_key, _settings );
+  if ( ! _dev ) {
+    ret = rtlsdr_open( &_dev, dev_index );
+    if (ret < 0)
+      throw std::runtime_error("Failed to open rtlsdr device.");
+
+    _settings.reset( new device_settings );
+    _settings->store( "direct_samp", 0 ); /* as after power-up */
+    _settings->store( "offset_tune", 0 );
+  }
+
+  _timer.phase( "open" );
 
   if (rtl_freq > 0 || tuner_freq > 0) {
     if (rtl_freq)
@@ -195,40 +234,74 @@ rtl_source_c::rtl_source_c (const std::string &args)
         str(boost::format("Failed to set xtal frequencies. Error %d.") % ret ));
   }
 
-  ret = rtlsdr_set_sample_rate( _dev, 1024000 );
-  if (ret < 0)
-    throw std::runtime_error("Failed to set default samplerate.");
+  _defaults.add( "rate", [this]() {
+    _agc.set_sample_rate( 1024000 );
+
+    if (_settings->cached( "rate", 1024000 ))
+      return;
+
+    if (rtlsdr_set_sample_rate( _dev, 1024000 ) < 0)
+      throw std::runtime_error("Failed to set default samplerate.");
+
+    _settings->store( "rate", 1024000 );
 
-  ret = rtlsdr_set_tuner_gain_mode(_dev, int(!_auto_gain));
-  if (ret < 0)
-    throw std::runtime_error("Failed to set tuner gain mode.");
+    if (_recorder)
+      _recorder->set_sample_rate( rtlsdr_get_sample_rate( _dev ) );
+  } );
 
-  ret = rtlsdr_set_agc_mode(_dev, int(_auto_gain));
-  if (ret < 0)
-    throw std::runtime_error("Failed to set agc mode.");
+  _defaults.add( "gain_mode", [this]() {
+    bool hw_agc = _auto_gain && ! _soft_agc;
 
-  if (direct_samp) {
+    if (_settings->cached( "gain_mode", hw_agc ))
+      return;
+
+    if (rtlsdr_set_tuner_gain_mode(_dev, int(!hw_agc)) < 0)
+      throw std::runtime_error("Failed to set tuner gain mode.");
+
+    if (rtlsdr_set_agc_mode(_dev, int(hw_agc)) < 0)
+      throw std::runtime_error("Failed to set agc mode.");
+
+    _settings->store( "gain_mode", hw_agc );
+  } );
+
+  if ( ! _settings->cached( "direct_samp", direct_samp ) ) {
     ret = rtlsdr_set_direct_sampling(_dev, direct_samp);
     if (ret < 0)
       throw std::runtime_error("Failed to enable direct sampling.");
-    _no_tuner = true;
+    _settings->store( "direct_samp", direct_samp );
   }
+  _no_tuner = direct_samp != 0;
 
-  if (offset_tune) {
+  if ( ! _settings->cached( "offset_tune", offset_tune ) ) {
     ret = rtlsdr_set_offset_tuning(_dev, offset_tune);
     if (ret < 0)
       throw std::runtime_error("Failed to enable offset tuning.");
+    _settings->store( "offset_tune", offset_tune );
   }
 
-  ret = rtlsdr_set_bias_tee(_dev, bias_tee);
-  if (ret < 0)
-    throw std::runtime_error("Failed to set bias tee.");
-
-  ret = rtlsdr_reset_buffer( _dev );
-  if (ret < 0)
-    throw std::runtime_error("Failed to reset usb buffers.");
+  /* off after power-up, fast opens leave it alone unless asked for */
+  if (dict.count("bias") || !_defaults.deferred()) {
+    ret = rtlsdr_set_bias_tee(_dev, bias_tee);
+    if (ret < 0)
+      throw std::runtime_error("Failed to set bias tee.");
+  }
 
-  set_if_gain( 24 ); /* preset to a reasonable default (non-GRC use case) */
+  _defaults.add( "reset_buffer", [this]() {
+    if (rtlsdr_reset_buffer( _dev ) < 0)
+      throw std::runtime_error("Failed to reset usb buffers.");
+  } );
+
+  /* preset to a reasonable default (non-GRC use case) */
+  _defaults.add( "if_gain", [this]() { set_if_gain( 24 ); } );
+
+  if (dict.count("record")) {
+    _recorder.reset( new raw_recorder( dict["record"], "cu8", BYTES_PER_SAMPLE,
+                                       "RTL-SDR" ) );
+    _recorder->set_sample_rate( rtlsdr_get_sample_rate( _dev ) );
+    _recorder->set_center_freq( get_center_freq() );
+  } else if (_record_only) {
+    throw std::runtime_error("Parameter 'record_only' requires 'record'.");
+  }
 
   _buf = (unsigned char **)malloc(_buf_num * sizeof(unsigned char *));
 
@@ -236,6 +309,8 @@ rtl_source_c::rtl_source_c (const std::string &args)
     for(unsigned int i = 0; i < _buf_num; ++i)
       _buf[i] = (unsigned char *)malloc(_buf_len);
   }
+
+  _timer.phase( "configure" );
 }
 
 /*
@@ -243,6 +318,9 @@ rtl_source_c::rtl_source_c (const std::string &args)
  */
 rtl_source_c::~rtl_source_c ()
 {
+  /* gain steps still queued use the device */
+  boost::atomic_load( &_exec )->call( [](){} );
+
   if (_dev) {
     if (_running)
     {
@@ -251,7 +329,8 @@ rtl_source_c::~rtl_source_c ()
       _thread.join();
     }
 
-    rtlsdr_close( _dev );
+    device_pool::instance().release( _pool_key, _dev, close_device,
+                                     _settings, _linger );
     _dev = NULL;
   }
 
@@ -265,8 +344,17 @@ rtl_source_c::~rtl_source_c ()
   }
 }
 
+void rtl_source_c::close_device( void *dev )
+{
+  rtlsdr_close( (rtlsdr_dev_t *)dev );
+}
+
 bool rtl_source_c::start()
 {
+  _timer.phase( "idle" );
+
+  _defaults.apply();
+
   _running = true;
   _thread = gr::thread::thread(_rtlsdr_wait, this);
 
@@ -296,11 +384,21 @@ void rtl_source_c::rtlsdr_callback(unsigned char *buf, uint32_t len)
     return;
   }
 
+  _timer.first_sample();
+
+  if (_recorder) {
+    _recorder->push(buf, len);
+
+    if (_record_only) /* work() stays idle, no conversion takes place */
+      return;
+  }
+
   {
     boost::mutex::scoped_lock lock( _buf_mutex );
 
     int buf_tail = (_buf_head + _buf_used) % _buf_num;
     memcpy(_buf[buf_tail], buf, len);
+    _samp_in += len / BYTES_PER_SAMPLE;
 
     if (_buf_used == _buf_num) {
       std::cerr << "O" << std::flush;
@@ -313,6 +411,63 @@ void rtl_source_c::rtlsdr_callback(unsigned char *buf, uint32_t len)
   _buf_cond.notify_one();
 }
 
+/* the position of the first sample of the next transfer, after decimation */
+uint64_t rtl_source_c::samples_received()
+{
+  boost::mutex::scoped_lock lock( _buf_mutex );
+
+  return _samp_in / _decim.get_decimation();
+}
+
+/*
+ * Measures the raw samples ahead of their conversion into the output at
+ * produced and tags the statistics of each complete window there. A step
+ * of the software gain control is queued on the executor, work() does not
+ * wait for the control transfers.
+ */
+void rtl_source_c::measure( const unsigned char *buf, int n, int produced )
+{
+  if ( ! _agc.measure( buf, n, false ) )
+    return;
+
+  if ( _stats )
+    add_item_tag( 0, nitems_written( 0 ) + produced, pmt::mp( "rx_stats" ), _agc.to_pmt() );
+
+  if ( _soft_agc && _auto_gain && _agc.queue_step() )
+    boost::atomic_load( &_exec )->post( boost::bind( &rtl_source_c::step_gain, this ) );
+}
+
+void rtl_source_c::set_executor( const boost::shared_ptr< device_executor > &exec )
+{
+  boost::shared_ptr< device_executor > own;
+  if ( ! exec )
+    own = boost::make_shared< device_executor >();
+
+  boost::atomic_store( &_exec, exec ? exec : own );
+}
+
+/* takes a step of the software gain control, set_gain() posts it as rx_gain */
+void rtl_source_c::step_gain()
+{
+  /* manual gain set meanwhile leaves an empty ladder, the step is dropped */
+  std::vector< double > gains;
+  if ( _auto_gain ) {
+    BOOST_FOREACH( const osmosdr::range_t &range, get_gain_range( 0 ) )
+      gains.push_back( range.start() );
+  }
+
+  /* the tuner gains are sorted, start from the one closest to the current */
+  double gain = get_gain( 0 );
+  size_t current = 0;
+  for (size_t i = 1; i < gains.size(); i++)
+    if ( std::abs( gains[i] - gain ) < std::abs( gains[current] - gain ) )
+      current = i;
+
+  size_t next = _agc.step( current, gains.size() );
+  if ( next != current )
+    set_gain( gains[next], 0 );
+}
+
 void rtl_source_c::_rtlsdr_wait(rtl_source_c *obj)
 {
   obj->rtlsdr_wait();
@@ -335,25 +490,58 @@ int rtl_source_c::work( int noutput_items,
                         gr_vector_void_star &output_items )
 {
   gr_complex *out = (gr_complex *)output_items[0];
+  const int decim = _decim.get_decimation();
+  uint64_t pos;
 
   {
     boost::mutex::scoped_lock lock( _buf_mutex );
 
     while (_buf_used < 3 && _running) // collect at least 3 buffers
       _buf_cond.wait( lock );
+
+    /* the head buffer is the oldest one still held */
+    pos = (_samp_in - _buf_used * (_buf_len / BYTES_PER_SAMPLE) + _buf_offset) / decim;
   }
 
   if (!_running)
     return WORK_DONE;
 
   while (noutput_items && _buf_used) {
-    const int nout = std::min(noutput_items, _samp_avail);
     const unsigned char *buf = _buf[_buf_head] + _buf_offset * 2;
+    int nout;
+
+    if (decim > 1) {
+      /* whole multiples of the decimation leave exactly nin / decim */
+      int nin = std::min(noutput_items * decim, _samp_avail);
+      if (nin > decim)
+        nin -= nin % decim;
+
+      if (_soft_agc || _stats)
+        measure(buf, nin, out - (gr_complex *)output_items[0]);
+
+      const int n = _decim.decimate(buf, nin, &_lut16[0], out);
+      if (_corrector.enabled())
+        _corrector.correct(out, n);
+      out += n;
+      noutput_items -= n;
+      nout = nin;
+    } else {
+      nout = std::min(noutput_items, _samp_avail);
+
+      if (_soft_agc || _stats)
+        measure(buf, nout, out - (gr_complex *)output_items[0]);
 
-    for (int i = 0; i < nout; ++i)
-      *out++ = gr_complex(_lut[buf[i * 2]], _lut[buf[i * 2 + 1]]);
+      if (_corrector.enabled()) {
+        _corrector.convert(buf, nout, &_lut[0], out);
+        out += nout;
+      } else {
+        for (int i = 0; i < nout; ++i)
+          *out++ = gr_complex(_lut[buf[i * 2]], _lut[buf[i * 2 + 1]]);
+      }
+
+      noutput_items -= nout;
+    }
 
-    noutput_items -= nout;
     _samp_avail -= nout;
 
     if (!_samp_avail) {
@@ -370,7 +558,12 @@ int rtl_source_c::work( int noutput_items,
     }
   }
 
-  return (out - ((gr_complex *)output_items[0]));
+  int produced = out - ((gr_complex *)output_items[0]);
+
+  BOOST_FOREACH( const gr::tag_t &change, _changes.take( pos, produced, nitems_written( 0 ) ) )
+    add_item_tag( 0, change );
+
+  return produced;
 }
 
 std::vector<std::string> rtl_source_c::get_devices()
@@ -432,22 +625,36 @@ osmosdr::meta_range_t rtl_source_c::get_sample_rates()
 //  range += osmosdr::range_t( 3000000 ); // may work
 //  range += osmosdr::range_t( 3200000 ); // max rate
 
-  return range;
+  return decimate_rates( range, _decim.get_decimation() );
 }
 
 double rtl_source_c::set_sample_rate(double rate)
 {
-  if (_dev) {
-    rtlsdr_set_sample_rate( _dev, (uint32_t)rate );
+  _defaults.cancel( "rate" );
+
+  /* the device runs at the rate before decimation */
+  uint32_t native = uint32_t(rate * _decim.get_decimation());
+
+  if (_dev && ! _settings->cached( "rate", native )) {
+    if ( ! rtlsdr_set_sample_rate( _dev, native ) ) {
+      _settings->store( "rate", native );
+      _changes.post( "rx_rate", get_sample_rate(), samples_received() );
+    }
+
+    if (_recorder)
+      _recorder->set_sample_rate( rtlsdr_get_sample_rate( _dev ) );
   }
 
+  if (_dev)
+    _agc.set_sample_rate( rtlsdr_get_sample_rate( _dev ) );
+
   return get_sample_rate();
 }
 
 double rtl_source_c::get_sample_rate()
 {
   if (_dev)
-    return (double)rtlsdr_get_sample_rate( _dev );
+    return (double)rtlsdr_get_sample_rate( _dev ) / _decim.get_decimation();
 
   return 0;
 }
@@ -488,8 +695,15 @@ osmosdr::freq_range_t rtl_source_c::get_freq_range( size_t chan )
 
 double rtl_source_c::set_center_freq( double freq, size_t chan )
 {
-  if (_dev)
-    rtlsdr_set_center_freq( _dev, (uint32_t)freq );
+  if (_dev && ! _settings->cached( "freq", uint32_t(freq) )) {
+    if ( ! rtlsdr_set_center_freq( _dev, (uint32_t)freq ) ) {
+      _settings->store( "freq", uint32_t(freq) );
+      _changes.post( "rx_freq", get_center_freq( chan ), samples_received() );
+    }
+
+    if (_recorder)
+      _recorder->set_center_freq( get_center_freq( chan ) );
+  }
 
   return get_center_freq( chan );
 }
@@ -568,12 +782,19 @@ osmosdr::gain_range_t rtl_source_c::get_gain_range( const std::string & name, si
 
 bool rtl_source_c::set_gain_mode( bool automatic, size_t chan )
 {
-  if (_dev) {
-    if (!rtlsdr_set_tuner_gain_mode(_dev, int(!automatic))) {
+  _defaults.cancel( "gain_mode" );
+
+  /* the software gain control leaves the tuner in manual mode */
+  bool hw_agc = automatic && ! _soft_agc;
+
+  if (_dev && ! _settings->cached( "gain_mode", hw_agc )) {
+    if (!rtlsdr_set_tuner_gain_mode(_dev, int(!hw_agc))) {
       _auto_gain = automatic;
+      rtlsdr_set_agc_mode(_dev, int(hw_agc));
+      _settings->store( "gain_mode", hw_agc );
     }
-
-    rtlsdr_set_agc_mode(_dev, int(automatic));
+  } else {
+    _auto_gain = automatic;
   }
 
   return get_gain_mode(chan);
@@ -588,8 +809,15 @@ double rtl_source_c::set_gain( double gain, size_t chan )
 {
   osmosdr::gain_range_t rf_gains = rtl_source_c::get_gain_range( chan );
 
-  if (_dev) {
-    rtlsdr_set_tuner_gain( _dev, int(rf_gains.clip(gain) * 10.0) );
+  _defaults.flush( "gain_mode" ); /* manual gains need manual mode */
+
+  int value = int(rf_gains.clip(gain) * 10.0);
+
+  if (_dev && ! _settings->cached( "gain", value )) {
+    if ( ! rtlsdr_set_tuner_gain( _dev, value ) ) {
+      _settings->store( "gain", value );
+      _changes.post( "rx_gain", get_gain( chan ), samples_received() );
+    }
   }
 
   return get_gain( chan );
@@ -623,6 +851,8 @@ double rtl_source_c::get_gain( const std::string & name, size_t chan )
 
 double rtl_source_c::set_if_gain(double gain, size_t chan)
 {
+  _defaults.cancel( "if_gain" );
+
   if ( _dev ) {
     if ( rtlsdr_get_tuner_type(_dev) != RTLSDR_TUNER_E4000 ) {
       _if_gain = 0;
@@ -676,10 +906,11 @@ double rtl_source_c::set_if_gain(double gain, size_t chan)
   }
   std::cerr << " = " << sum << std::endl;
 #endif
-  if (_dev) {
+  if (_dev && ! _settings->cached( "if_gain", gain )) {
     for (unsigned int stage = 1; stage <= gains.size(); stage++) {
       rtlsdr_set_tuner_if_gain( _dev, stage, int(gains[ stage ] * 10.0));
     }
+    _settings->store( "if_gain", gain );
   }
 
   _if_gain = gain;
@@ -704,3 +935,60 @@ std::string rtl_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+void rtl_source_c::set_dc_offset_mode( int mode, size_t chan )
+{
+  _corrector.set_dc_offset_mode( mode );
+}
+
+void rtl_source_c::set_dc_offset( const std::complex<double> &offset, size_t chan )
+{
+  _corrector.set_dc_offset( offset );
+}
+
+void rtl_source_c::set_iq_balance_mode( int mode, size_t chan )
+{
+  _corrector.set_iq_balance_mode( mode );
+}
+
+void rtl_source_c::set_iq_balance( const std::complex<double> &balance, size_t chan )
+{
+  _corrector.set_iq_balance( balance );
+}
+
+double rtl_source_c::get_settle_time( size_t chan )
+{
+  if ( ! _dev || _no_tuner )
+    return tuner_settle_time( "" );
+
+  switch ( rtlsdr_get_tuner_type(_dev) ) {
+  case RTLSDR_TUNER_E4000: return tuner_settle_time( "E4000" );
+  case RTLSDR_TUNER_FC0012: return tuner_settle_time( "FC0012" );
+  case RTLSDR_TUNER_FC0013: return tuner_settle_time( "FC0013" );
+  case RTLSDR_TUNER_FC2580: return tuner_settle_time( "FC2580" );
+  case RTLSDR_TUNER_R820T: return tuner_settle_time( "R820T" );
+  case RTLSDR_TUNER_R828D: return tuner_settle_time( "R828D" );
+  default: return tuner_settle_time( "" );
+  }
+}
+
+osmosdr::channel_settings rtl_source_c::configure( const osmosdr::channel_settings &settings,
+                                                   size_t chan )
+{
+  /* rate and bandwidth go before the frequency, so the tuner filters
+   * and IF are programmed once, and values the device already has are
+   * skipped through the settings cache */
+  osmosdr::channel_settings actual;
+  {
+    /* one rx_retune tag instead of the tags of each setter */
+    change_tags::hold hold( _changes );
+    actual = apply_channel_settings( this, settings, chan );
+  }
+
+  _changes.post_retune( actual, samples_received() );
+
+  return actual;
+}
+
+OSMOSDR_REGISTER_SOURCE( rtl, "rtl", PROBE_USB,
+                         make_rtl_source_c, rtl_source_c::get_devices() );
@@ -29,6 +29,13 @@
 #include <boost/thread/condition_variable.hpp>
 
 #include "source_iface.h"
+#include "iq_corrector.h"
+#include "soft_agc.h"
+#include "device_executor.h"
+#include "raw_recorder.h"
+#include "device_startup.h"
+#include "device_pool.h"
+#include "halfband_decim.h"
 
 class rtl_source_c;
 typedef struct rtlsdr_dev rtlsdr_dev_t;
@@ -93,6 +100,8 @@ public:
   osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
   double set_center_freq( double freq, size_t chan = 0 );
   double get_center_freq( size_t chan = 0 );
+  bool tags_changes() { return true; }
+  void set_executor( const boost::shared_ptr< device_executor > &exec );
   double set_freq_corr( double ppm, size_t chan = 0 );
   double get_freq_corr( size_t chan = 0 );
 
@@ -112,6 +121,17 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  void set_dc_offset_mode( int mode, size_t chan = 0 );
+  void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
+
+  void set_iq_balance_mode( int mode, size_t chan = 0 );
+  void set_iq_balance( const std::complex<double> &balance, size_t chan = 0 );
+
+  osmosdr::channel_settings configure( const osmosdr::channel_settings &settings,
+                                       size_t chan = 0 );
+
+  double get_settle_time( size_t chan = 0 );
+
 protected:
   bool start();
   bool stop();
@@ -121,8 +141,19 @@ private:
   void rtlsdr_callback(unsigned char *buf, uint32_t len);
   static void _rtlsdr_wait(rtl_source_c *obj);
   void rtlsdr_wait();
+  static void close_device(void *dev);
+  uint64_t samples_received();
+  void measure( const unsigned char *buf, int n, int produced );
+  void step_gain();
 
   std::vector<float> _lut;
+  std::vector<int16_t> _lut16; /* for decimation, full scale at FULL_SCALE */
+  halfband_decim _decim;
+  iq_corrector _corrector;
+  soft_agc _agc;
+  bool _soft_agc; /* automatic gain steps the tuner gain on _exec */
+  bool _stats; /* tags the statistics of each window of _agc */
+  boost::shared_ptr< device_executor > _exec; /* runs the steps of _agc */
 
   rtlsdr_dev_t *_dev;
   gr::thread::thread _thread;
@@ -137,11 +168,23 @@ private:
 
   unsigned int _buf_offset;
   int _samp_avail;
+  uint64_t _samp_in; /* samples put into the buffers since opening */
 
   bool _no_tuner;
   bool _auto_gain;
   double _if_gain;
   unsigned int _skipped;
+
+  boost::shared_ptr<raw_recorder> _recorder;
+  bool _record_only;
+
+  startup_timer _timer;
+  deferred_defaults _defaults;
+  change_tags _changes;
+
+  std::string _pool_key;
+  double _linger;
+  device_settings_sptr _settings;
 };
 
 #endif /* INCLUDED_RTLSDR_SOURCE_C_H */
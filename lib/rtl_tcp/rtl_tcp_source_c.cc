@@ -18,6 +18,8 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <string>
 #include <sstream>
@@ -28,6 +30,7 @@
 #include <gnuradio/io_signature.h>
 
 #include "rtl_tcp_source_c.h"
+#include "driver_registry.h"
 #include "arg_helpers.h"
 
 #if defined(_WIN32)
@@ -186,6 +189,9 @@ rtl_tcp_source_c::rtl_tcp_source_c(const std::string &args) :
   if (dict.count("bias"))
     bias_tee = boost::lexical_cast<bool>( dict["bias"] );
 
+  if (dict.count("decim"))
+    d_decim.set_decimation( parse_decimation( dict["decim"] ) );
+
   if (!host.length())
     host = "127.0.0.1";
 
@@ -223,9 +229,12 @@ rtl_tcp_source_c::rtl_tcp_source_c(const std::string &args) :
                  "can't initialize source socket" );
 
   d_temp_buff = new unsigned char[payload_size];   // allow it to hold up to payload_size bytes
+  d_temp_size = payload_size;
   d_LUT = new float[0x100];
-  for (int i = 0; i < 0x100; ++i)
+  for (int i = 0; i < 0x100; ++i) {
     d_LUT[i] = (((float)(i & 0xff)) - 127.4f) * (1.0f / 128.0f);
+    d_LUT16.push_back(int16_t(lrintf(d_LUT[i] * halfband_decim::FULL_SCALE)));
+  }
 
   // create socket
   d_socket = socket(ip_src->ai_family, ip_src->ai_socktype,
@@ -339,7 +348,14 @@ int rtl_tcp_source_c::work(int noutput_items,
 			   gr_vector_void_star &output_items)
 {
   gr_complex *out = (gr_complex *)output_items[0];
-  int bytesleft = noutput_items * BYTES_PER_SAMPLE;
+  const int decim = d_decim.get_decimation();
+
+  /* whole multiples of the decimation leave exactly noutput_items */
+  if (decim > 1)
+    noutput_items = std::max(1, std::min(noutput_items,
+                                          d_temp_size / (BYTES_PER_SAMPLE * decim)));
+
+  int bytesleft = noutput_items * decim * BYTES_PER_SAMPLE;
   int index = 0;
   int receivedbytes = 0;
   while (bytesleft > 0) {
@@ -353,6 +369,18 @@ int rtl_tcp_source_c::work(int noutput_items,
     index += receivedbytes;
   }
 
+  if (decim > 1) {
+    int n = d_decim.decimate(d_temp_buff, noutput_items * decim, &d_LUT16[0], out);
+    if (_corrector.enabled())
+      _corrector.correct(out, n);
+    return n;
+  }
+
+  if (_corrector.enabled()) {
+    _corrector.convert(d_temp_buff, noutput_items, d_LUT, out);
+    return noutput_items;
+  }
+
   for (int i = 0; i < noutput_items; i++)
     out[i] = gr_complex(d_LUT[d_temp_buff[i * 2]], d_LUT[d_temp_buff[i * 2 + 1]]);
 
@@ -401,12 +429,13 @@ osmosdr::meta_range_t rtl_tcp_source_c::get_sample_rates( void )
 //  range += osmosdr::range_t( 3000000 ); // may work
 //  range += osmosdr::range_t( 3200000 ); // max rate
 
-  return range;
+  return decimate_rates( range, d_decim.get_decimation() );
 }
 
 double rtl_tcp_source_c::set_sample_rate( double rate )
 {
-  struct command cmd = { 0x02, htonl(rate) };
+  /* the server runs the device at the rate before decimation */
+  struct command cmd = { 0x02, htonl(uint32_t(rate * d_decim.get_decimation())) };
   send(d_socket, (const char*)&cmd, sizeof(cmd), 0);
 
   _rate = rate;
@@ -697,3 +726,31 @@ std::string rtl_tcp_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+void rtl_tcp_source_c::set_dc_offset_mode( int mode, size_t chan )
+{
+  _corrector.set_dc_offset_mode( mode );
+}
+
+void rtl_tcp_source_c::set_dc_offset( const std::complex<double> &offset, size_t chan )
+{
+  _corrector.set_dc_offset( offset );
+}
+
+void rtl_tcp_source_c::set_iq_balance_mode( int mode, size_t chan )
+{
+  _corrector.set_iq_balance_mode( mode );
+}
+
+void rtl_tcp_source_c::set_iq_balance( const std::complex<double> &balance, size_t chan )
+{
+  _corrector.set_iq_balance( balance );
+}
+
+double rtl_tcp_source_c::get_settle_time( size_t chan )
+{
+  return tuner_settle_time( _no_tuner ? "" : get_tuner_name() );
+}
+
+OSMOSDR_REGISTER_SOURCE( rtl_tcp, "rtl_tcp", PROBE_SOFTWARE,
+                         make_rtl_tcp_source_c, rtl_tcp_source_c::get_devices( fake ) );
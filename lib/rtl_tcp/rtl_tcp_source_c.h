@@ -23,6 +23,8 @@
 #include <gnuradio/sync_block.h>
 
 #include "source_iface.h"
+#include "iq_corrector.h"
+#include "halfband_decim.h"
 
 class rtl_tcp_source_c;
 
@@ -90,6 +92,14 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  void set_dc_offset_mode( int mode, size_t chan = 0 );
+  void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
+
+  void set_iq_balance_mode( int mode, size_t chan = 0 );
+  void set_iq_balance( const std::complex<double> &balance, size_t chan = 0 );
+
+  double get_settle_time( size_t chan = 0 );
+
 private:
   int d_socket;		  // handle to socket
   double _freq, _rate, _gain, _corr;
@@ -101,7 +111,11 @@ private:
   unsigned int d_tuner_gain_count;
   unsigned int d_tuner_if_gain_count;
   unsigned char *d_temp_buff; // hold buffer between calls
+  int d_temp_size;            // of d_temp_buff in bytes
   float *d_LUT;
+  std::vector<int16_t> d_LUT16; // for decimation, full scale at FULL_SCALE
+  halfband_decim d_decim;
+  iq_corrector _corrector;
 };
 
 #endif // RTL_TCP_SOURCE_C_H
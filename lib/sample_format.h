@@ -0,0 +1,136 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef SAMPLE_FORMAT_H
+#define SAMPLE_FORMAT_H
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <stdint.h>
+
+#include <gnuradio/gr_complex.h>
+
+/*
+ * Compact storage formats used to keep samples in memory, on disk or in
+ * shared memory. The names follow the SigMF datatype convention.
+ */
+enum sample_format
+{
+  SAMPLE_FORMAT_CF32, /* complex float, as produced by the flowgraph */
+  SAMPLE_FORMAT_SC16, /* complex int16 scaled to full range */
+  SAMPLE_FORMAT_SC8   /* complex int8 scaled to full range */
+};
+
+inline sample_format parse_sample_format( const std::string &name )
+{
+  if ( name.empty() || "cf32" == name || "cf32_le" == name )
+    return SAMPLE_FORMAT_CF32;
+  else if ( "sc16" == name || "ci16" == name || "ci16_le" == name )
+    return SAMPLE_FORMAT_SC16;
+  else if ( "sc8" == name || "ci8" == name )
+    return SAMPLE_FORMAT_SC8;
+
+  throw std::runtime_error( "Unsupported sample format '" + name + "'." );
+}
+
+inline const char *sample_format_sigmf( sample_format fmt )
+{
+  switch ( fmt ) {
+  case SAMPLE_FORMAT_SC16: return "ci16_le";
+  case SAMPLE_FORMAT_SC8: return "ci8";
+  default: return "cf32_le";
+  }
+}
+
+/* size of one complex sample in bytes */
+inline size_t sample_format_size( sample_format fmt )
+{
+  switch ( fmt ) {
+  case SAMPLE_FORMAT_SC16: return 2 * sizeof(int16_t);
+  case SAMPLE_FORMAT_SC8: return 2 * sizeof(int8_t);
+  default: return sizeof(gr_complex);
+  }
+}
+
+template <typename T>
+inline T sample_format_clip( float val, float scale )
+{
+  val *= scale;
+
+  if ( val > scale )
+    return T(scale);
+  if ( val < -scale )
+    return T(-scale);
+
+  return T(val);
+}
+
+/* convert num complex float samples into the storage format at dst */
+inline void sample_format_pack( sample_format fmt, const gr_complex *src,
+                                void *dst, size_t num )
+{
+  switch ( fmt ) {
+  case SAMPLE_FORMAT_SC16: {
+    int16_t *out = (int16_t *)dst;
+    for ( size_t i = 0; i < num; i++ ) {
+      *out++ = sample_format_clip< int16_t >( src[i].real(), 32767.0f );
+      *out++ = sample_format_clip< int16_t >( src[i].imag(), 32767.0f );
+    }
+    break;
+  }
+  case SAMPLE_FORMAT_SC8: {
+    int8_t *out = (int8_t *)dst;
+    for ( size_t i = 0; i < num; i++ ) {
+      *out++ = sample_format_clip< int8_t >( src[i].real(), 127.0f );
+      *out++ = sample_format_clip< int8_t >( src[i].imag(), 127.0f );
+    }
+    break;
+  }
+  default:
+    memcpy( dst, src, num * sizeof(gr_complex) );
+  }
+}
+
+/* convert num samples in storage format at src back to complex float */
+inline void sample_format_unpack( sample_format fmt, const void *src,
+                                  gr_complex *dst, size_t num )
+{
+  switch ( fmt ) {
+  case SAMPLE_FORMAT_SC16: {
+    const int16_t *in = (const int16_t *)src;
+    for ( size_t i = 0; i < num; i++, in += 2 )
+      dst[i] = gr_complex( in[0] / 32767.0f, in[1] / 32767.0f );
+    break;
+  }
+  case SAMPLE_FORMAT_SC8: {
+    const int8_t *in = (const int8_t *)src;
+    for ( size_t i = 0; i < num; i++, in += 2 )
+      dst[i] = gr_complex( in[0] / 127.0f, in[1] / 127.0f );
+    break;
+  }
+  default:
+    memcpy( dst, src, num * sizeof(gr_complex) );
+  }
+}
+
+#endif // SAMPLE_FORMAT_H
@@ -30,6 +30,7 @@
 #endif
 
 #include "sdrplay_source_c.h"
+#include "driver_registry.h"
 #include <gnuradio/io_signature.h>
 #include "osmosdr/source.h"
 
@@ -598,3 +599,6 @@ osmosdr::freq_range_t sdrplay_source_c::get_bandwidth_range( size_t chan )
 
    return range;
 }
+
+OSMOSDR_REGISTER_SOURCE( sdrplay, "sdrplay", PROBE_USB,
+                         make_sdrplay_source_c, sdrplay_source_c::get_devices() );
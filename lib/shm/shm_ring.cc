@@ -0,0 +1,378 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <dirent.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <boost/thread/thread.hpp>
+
+#include "shm_ring.h"
+
+#define SHM_RING_MAGIC "OSMOSHM1"
+
+#define LOAD(var) __atomic_load_n( &(var), __ATOMIC_ACQUIRE )
+#define STORE(var, val) __atomic_store_n( &(var), (val), __ATOMIC_RELEASE )
+
+static std::string shm_path( const std::string &name )
+{
+  return "/" SHM_RING_PREFIX + name;
+}
+
+shm_ring::shm_ring( const std::string &name, sample_format fmt, uint64_t size ) :
+  _name(name),
+  _producer(true),
+  _hdr(NULL),
+  _data(NULL),
+  _map_len(0),
+  _item_size(sample_format_size(fmt)),
+  _dev(0),
+  _ino(0)
+{
+  /* round up to a power of two */
+  uint64_t ring_size = 4096;
+  while ( ring_size < size )
+    ring_size <<= 1;
+
+  std::string path = shm_path( name );
+
+  int fd = shm_open( path.c_str(), O_RDONLY, 0 );
+  if ( fd >= 0 ) {
+    /* refuse to steal the ring from a running producer */
+    struct stat st;
+    if ( fstat( fd, &st ) == 0 && size_t(st.st_size) >= sizeof(shm_ring_header) ) {
+      shm_ring_header hdr;
+      if ( pread( fd, &hdr, sizeof(hdr), 0 ) == ssize_t(sizeof(hdr)) &&
+           0 == memcmp( hdr.magic, SHM_RING_MAGIC, sizeof(hdr.magic) ) &&
+           hdr.owner != uint32_t(getpid()) &&
+           ( kill( hdr.owner, 0 ) == 0 || errno == EPERM ) ) {
+        close( fd );
+        throw std::runtime_error( "Shared memory '" + name + "' is in use by another producer." );
+      }
+    }
+    close( fd );
+
+    /* consumers may still map the old ring, resizing it would fault them.
+     * Put a fresh object under the name instead, they reattach to it. */
+    shm_unlink( path.c_str() );
+  }
+
+  fd = shm_open( path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644 );
+  if ( fd < 0 )
+    throw std::runtime_error( "Failed to create shared memory '" + name + "': " +
+                              strerror(errno) );
+
+  size_t data = (sizeof(shm_ring_header) + 4095) & ~size_t(4095);
+  size_t len = data + ring_size * _item_size;
+
+  if ( ftruncate( fd, len ) < 0 ) {
+    close( fd );
+    shm_unlink( path.c_str() );
+    throw std::runtime_error( "Failed to size shared memory '" + name + "': " +
+                              strerror(errno) );
+  }
+
+  map( fd, len );
+
+  memset( _hdr, 0, sizeof(shm_ring_header) );
+  _hdr->format = fmt;
+  _hdr->owner = getpid();
+  _hdr->size = ring_size;
+  _hdr->data = data;
+  _data = (char *)_hdr + data;
+
+  /* consumers only accept the ring once the magic is there */
+  __atomic_thread_fence( __ATOMIC_RELEASE );
+  memcpy( _hdr->magic, SHM_RING_MAGIC, sizeof(_hdr->magic) );
+}
+
+shm_ring::shm_ring( const std::string &name ) :
+  _name(name),
+  _producer(false),
+  _hdr(NULL),
+  _data(NULL),
+  _map_len(0),
+  _item_size(0),
+  _dev(0),
+  _ino(0)
+{
+  int fd = shm_open( shm_path( name ).c_str(), O_RDWR, 0 );
+  if ( fd < 0 )
+    throw std::runtime_error( "Failed to open shared memory '" + name + "': " +
+                              strerror(errno) );
+
+  struct stat st;
+  if ( fstat( fd, &st ) < 0 || size_t(st.st_size) < sizeof(shm_ring_header) ) {
+    close( fd );
+    throw std::runtime_error( "Shared memory '" + name + "' is not ready." );
+  }
+
+  map( fd, st.st_size );
+
+  if ( memcmp( _hdr->magic, SHM_RING_MAGIC, sizeof(_hdr->magic) ) ||
+       _hdr->data + _hdr->size * sample_format_size( get_format() ) > _map_len )
+    throw std::runtime_error( "Shared memory '" + name + "' holds no sample ring." );
+
+  _item_size = sample_format_size( get_format() );
+  _data = (char *)_hdr + _hdr->data;
+}
+
+shm_ring::~shm_ring()
+{
+  if ( _hdr ) {
+    munmap( _hdr, _map_len );
+
+    if ( _producer )
+      shm_unlink( shm_path( _name ).c_str() );
+  }
+}
+
+void shm_ring::map( int fd, size_t len )
+{
+  struct stat st;
+  if ( fstat( fd, &st ) == 0 ) {
+    _dev = st.st_dev;
+    _ino = st.st_ino;
+  }
+
+  /* consumers need write access to the control slot */
+  void *addr = mmap( NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+  close( fd );
+
+  if ( MAP_FAILED == addr )
+    throw std::runtime_error( "Failed to map shared memory '" + _name + "': " +
+                              strerror(errno) );
+
+  _hdr = (shm_ring_header *)addr;
+  _map_len = len;
+}
+
+std::vector< std::string > shm_ring::list()
+{
+  std::vector< std::string > names;
+  std::string prefix = SHM_RING_PREFIX;
+
+  DIR *dir = opendir( "/dev/shm" );
+  if ( ! dir )
+    return names;
+
+  struct dirent *ent;
+  while ( (ent = readdir( dir )) != NULL ) {
+    std::string name = ent->d_name;
+    if ( name.compare( 0, prefix.size(), prefix ) == 0 )
+      names.push_back( name.substr( prefix.size() ) );
+  }
+
+  closedir( dir );
+
+  return names;
+}
+
+char *shm_ring::prepare( size_t &num )
+{
+  uint64_t idx = _hdr->write_pos & (_hdr->size - 1);
+
+  num = std::min( uint64_t(num), _hdr->size - idx );
+
+  return _data + idx * _item_size;
+}
+
+void shm_ring::commit( size_t num )
+{
+  STORE( _hdr->write_pos, _hdr->write_pos + num );
+}
+
+void shm_ring::write( const void *data, size_t num )
+{
+  const char *p = (const char *)data;
+
+  while ( num ) {
+    size_t len = num;
+    char *dst = prepare( len );
+
+    memcpy( dst, p, len * _item_size );
+    commit( len );
+
+    p += len * _item_size;
+    num -= len;
+  }
+}
+
+void shm_ring::write_tag( uint64_t offset, const std::string &key,
+                          const std::string &value )
+{
+  if ( key.size() >= SHM_RING_TAG_KEY || value.size() > SHM_RING_TAG_VAL )
+    return; /* does not fit, consumers won't see it */
+
+  uint64_t pos = _hdr->tag_pos;
+  shm_ring_tag &tag = _hdr->tags[ pos & (SHM_RING_TAGS - 1) ];
+
+  tag.offset = offset;
+  strncpy( tag.key, key.c_str(), SHM_RING_TAG_KEY );
+  tag.len = value.size();
+  memcpy( tag.value, value.data(), value.size() );
+
+  STORE( _hdr->tag_pos, pos + 1 );
+}
+
+void shm_ring::set_meta( double rate, double freq, double gain )
+{
+  uint32_t seq = _hdr->meta_seq;
+
+  STORE( _hdr->meta_seq, seq + 1 );
+  __atomic_thread_fence( __ATOMIC_SEQ_CST );
+  _hdr->rate = rate;
+  _hdr->freq = freq;
+  _hdr->gain = gain;
+  STORE( _hdr->meta_seq, seq + 2 );
+}
+
+void shm_ring::get_meta( double &rate, double &freq, double &gain ) const
+{
+  uint32_t seq;
+
+  do {
+    while ( (seq = LOAD( _hdr->meta_seq )) & 1 )
+      ;
+    rate = _hdr->rate;
+    freq = _hdr->freq;
+    gain = _hdr->gain;
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+  } while ( seq != LOAD( _hdr->meta_seq ) );
+}
+
+bool shm_ring::take_request( std::string &req )
+{
+  uint32_t seq = LOAD( _hdr->ctrl_seq );
+
+  if ( seq == _hdr->ctrl_ack )
+    return false;
+
+  req.assign( _hdr->ctrl, std::min( uint32_t(SHM_RING_CTRL), _hdr->ctrl_len ) );
+  STORE( _hdr->ctrl_ack, seq );
+
+  return true;
+}
+
+void shm_ring::post_request( const std::string &req )
+{
+  if ( req.size() > SHM_RING_CTRL )
+    throw std::runtime_error("Control request too long.");
+
+  /* serialize the consumers, then wait for the producer to take the
+   * previous request before the slot is overwritten */
+  for ( int i = 0; ; i++ ) {
+    uint32_t unlocked = 0;
+    if ( __atomic_compare_exchange_n( &_hdr->ctrl_lock, &unlocked, 1, false,
+                                      __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) ) {
+      if ( LOAD( _hdr->ctrl_seq ) == LOAD( _hdr->ctrl_ack ) )
+        break;
+
+      STORE( _hdr->ctrl_lock, uint32_t(0) ); /* slot still busy */
+    }
+
+    if ( i == 500 || ! producer_alive() ) {
+      std::cerr << "Producer of '" << _name << "' does not take requests, "
+                << "dropping '" << req << "'" << std::endl;
+      return;
+    }
+
+    boost::this_thread::sleep( boost::posix_time::milliseconds(1) );
+  }
+
+  memcpy( _hdr->ctrl, req.data(), req.size() );
+  _hdr->ctrl_len = req.size();
+  STORE( _hdr->ctrl_seq, _hdr->ctrl_seq + 1 );
+  STORE( _hdr->ctrl_lock, uint32_t(0) );
+}
+
+uint64_t shm_ring::get_write_pos() const
+{
+  return LOAD( _hdr->write_pos );
+}
+
+const char *shm_ring::at( uint64_t pos ) const
+{
+  return _data + (pos & (_hdr->size - 1)) * _item_size;
+}
+
+bool shm_ring::read_tags( uint64_t &tag_pos, uint64_t start, uint64_t end,
+                          std::vector< shm_ring_tag > &tags ) const
+{
+  uint64_t head = LOAD( _hdr->tag_pos );
+  bool complete = true;
+
+  /* the slot of head - SHM_RING_TAGS is the next one to be rewritten */
+  if ( head - tag_pos >= SHM_RING_TAGS ) {
+    tag_pos = head - SHM_RING_TAGS + 1;
+    complete = false;
+  }
+
+  for ( ; tag_pos < head; tag_pos++ ) {
+    shm_ring_tag tag = _hdr->tags[ tag_pos & (SHM_RING_TAGS - 1) ];
+
+    /* the slot may have been reused while it was copied */
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    if ( LOAD( _hdr->tag_pos ) - tag_pos >= SHM_RING_TAGS ) {
+      complete = false;
+      continue;
+    }
+
+    if ( tag.offset >= end )
+      break; /* keep it for the next call */
+
+    if ( tag.offset >= start ) {
+      tag.key[SHM_RING_TAG_KEY - 1] = 0;
+      tags.push_back( tag );
+    }
+  }
+
+  return complete;
+}
+
+bool shm_ring::producer_alive() const
+{
+  return kill( _hdr->owner, 0 ) == 0 || errno == EPERM;
+}
+
+bool shm_ring::replaced() const
+{
+  int fd = shm_open( shm_path( _name ).c_str(), O_RDONLY, 0 );
+  if ( fd < 0 )
+    return false; /* no producer yet */
+
+  struct stat st;
+  bool other = fstat( fd, &st ) == 0 &&
+               ( st.st_dev != _dev || st.st_ino != _ino );
+  close( fd );
+
+  return other;
+}
@@ -0,0 +1,159 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "sample_format.h"
+
+#define SHM_RING_PREFIX   "osmosdr-"
+#define SHM_RING_TAGS     256  /* tag slots, power of two */
+#define SHM_RING_TAG_KEY  32
+#define SHM_RING_TAG_VAL  88   /* serialized pmt */
+#define SHM_RING_CTRL     256
+
+/*
+ * The shared memory layout. It is written by a single producer and read
+ * by any number of consumers, which never write to the sample area. All
+ * counters increase monotonically and are accessed with atomic loads and
+ * stores; a position p lives at p % size in its ring.
+ */
+struct shm_ring_tag
+{
+  uint64_t offset; /* absolute sample offset */
+  char key[SHM_RING_TAG_KEY];
+  uint32_t len;
+  char value[SHM_RING_TAG_VAL];
+};
+
+struct shm_ring_header
+{
+  char magic[8];
+  uint32_t format;    /* sample_format */
+  uint32_t owner;     /* pid of the producer */
+  uint64_t size;      /* ring size in samples, a power of two */
+  uint64_t data;      /* offset of the sample area from the header */
+
+  uint64_t write_pos; /* samples written so far */
+  uint64_t tag_pos;   /* tags written so far */
+
+  uint32_t meta_seq;  /* odd while the metadata is being updated */
+  uint32_t pad0;
+  double rate;
+  double freq;
+  double gain;
+
+  /* control side channel from the consumers to the producer */
+  uint32_t ctrl_lock;
+  uint32_t ctrl_seq;  /* incremented for every posted request */
+  uint32_t ctrl_ack;  /* last request taken by the producer */
+  uint32_t ctrl_len;
+  char ctrl[SHM_RING_CTRL];
+
+  shm_ring_tag tags[SHM_RING_TAGS];
+};
+
+/*!
+ * A multi-reader sample ring in POSIX shared memory (/dev/shm).
+ */
+class shm_ring
+{
+public:
+  /* create (or take over from a dead producer) a ring as the producer */
+  shm_ring( const std::string &name, sample_format fmt, uint64_t size );
+
+  /* attach to an existing ring as a consumer */
+  shm_ring( const std::string &name );
+
+  ~shm_ring();
+
+  static std::vector< std::string > list();
+
+  sample_format get_format() const { return sample_format(_hdr->format); }
+  size_t get_item_size() const { return _item_size; }
+  uint64_t get_size() const { return _hdr->size; }
+
+  /* producer side */
+
+  /*!
+   * Space for the next samples. Returns the location of the next write
+   * position and sets num to the contiguous space available there.
+   */
+  char *prepare( size_t &num );
+
+  /* publish num samples stored at the location returned by prepare() */
+  void commit( size_t num );
+
+  /* copy num samples in storage format into the ring and publish them */
+  void write( const void *data, size_t num );
+  void write_tag( uint64_t offset, const std::string &key, const std::string &value );
+  void set_meta( double rate, double freq, double gain );
+
+  /* take a pending control request, returns false if there is none */
+  bool take_request( std::string &req );
+
+  /* consumer side */
+
+  uint64_t get_write_pos() const;
+
+  /* location of position pos in the sample area */
+  const char *at( uint64_t pos ) const;
+
+  /*!
+   * Tags with offsets in [start, end). Returns false if tags in that
+   * range have already been overwritten.
+   */
+  bool read_tags( uint64_t &tag_pos, uint64_t start, uint64_t end,
+                  std::vector< shm_ring_tag > &tags ) const;
+
+  void get_meta( double &rate, double &freq, double &gain ) const;
+
+  /* post a control request to the producer, e.g. "freq=100e6" */
+  void post_request( const std::string &req );
+
+  bool producer_alive() const;
+
+  /*!
+   * True once a restarted producer has created a new ring under the same
+   * name. The old mapping stays valid but won't see any more samples.
+   */
+  bool replaced() const;
+
+private:
+  void map( int fd, size_t len );
+
+  std::string _name;
+  bool _producer;
+  shm_ring_header *_hdr;
+  char *_data;
+  size_t _map_len;
+  size_t _item_size;
+  dev_t _dev;
+  ino_t _ino;
+};
+
+#endif // SHM_RING_H
@@ -0,0 +1,287 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <iostream>
+
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <gnuradio/io_signature.h>
+
+#include "shm_sink_c.h"
+#include "driver_registry.h"
+
+#include "arg_helpers.h"
+
+#define RING_SIZE (1 << 22) /* samples, about 1.7 s at 2.4 Msps */
+
+shm_sink_c_sptr make_shm_sink_c(const std::string &args)
+{
+  return gnuradio::get_initial_sptr(new shm_sink_c(args));
+}
+
+shm_sink_c::shm_sink_c(const std::string &args) :
+  gr::sync_block("shm_sink_c",
+                 gr::io_signature::make(1, 1, sizeof (gr_complex)),
+                 gr::io_signature::make(0, 0, 0)),
+  _fmt(SAMPLE_FORMAT_CF32),
+  _rate(0),
+  _freq(0),
+  _gain(0)
+{
+  std::string name = "osmosdr";
+  uint64_t size = RING_SIZE;
+
+  dict_t dict = params_to_dict(args);
+
+  if (dict.count("shm") && dict["shm"].length())
+    name = dict["shm"];
+
+  if (dict.count("format"))
+    _fmt = parse_sample_format( dict["format"] );
+
+  if (dict.count("size"))
+    size = boost::lexical_cast< uint64_t >( dict["size"] );
+
+  if (dict.count("rate"))
+    _rate = boost::lexical_cast< double >( dict["rate"] );
+
+  if (dict.count("freq"))
+    _freq = boost::lexical_cast< double >( dict["freq"] );
+
+  _ring.reset( new shm_ring( name, _fmt, size ) );
+
+  std::cerr << "Publishing " << sample_format_sigmf( _fmt ) << " samples to "
+            << "shared memory '" << name << "' (" << _ring->get_size()
+            << " samples)" << std::endl;
+
+  publish_meta();
+
+  message_port_register_out( pmt::mp("command") );
+}
+
+shm_sink_c::~shm_sink_c()
+{
+}
+
+void shm_sink_c::publish_meta()
+{
+  _ring->set_meta( _rate, _freq, _gain );
+}
+
+/* turn "freq=100e6,gain=20" into a command dictionary */
+void shm_sink_c::forward_request( const std::string &req )
+{
+  dict_t dict = params_to_dict( req );
+  pmt::pmt_t cmd = pmt::make_dict();
+
+  BOOST_FOREACH( dict_t::value_type &entry, dict ) {
+    pmt::pmt_t val;
+
+    try {
+      val = pmt::from_double( boost::lexical_cast< double >( entry.second ) );
+    } catch ( boost::bad_lexical_cast & ) {
+      val = pmt::intern( entry.second );
+    }
+
+    cmd = pmt::dict_add( cmd, pmt::intern( entry.first ), val );
+  }
+
+  message_port_pub( pmt::mp("command"), cmd );
+}
+
+int shm_sink_c::work( int noutput_items,
+                      gr_vector_const_void_star &input_items,
+                      gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+
+  std::string req;
+  while ( _ring->take_request( req ) )
+    forward_request( req );
+
+  /* tags first, they must be visible once their samples are */
+  std::vector< gr::tag_t > tags;
+  get_tags_in_range( tags, 0, nitems_read(0), nitems_read(0) + noutput_items );
+
+  bool meta_changed = false;
+  BOOST_FOREACH( gr::tag_t &tag, tags ) {
+    /* keep the metadata in line with what the device reports */
+    if ( pmt::eq( tag.key, pmt::mp("rx_freq") ) && pmt::is_number( tag.value ) ) {
+      _freq = pmt::to_double( tag.value );
+      meta_changed = true;
+    } else if ( pmt::eq( tag.key, pmt::mp("rx_rate") ) && pmt::is_number( tag.value ) ) {
+      _rate = pmt::to_double( tag.value );
+      meta_changed = true;
+    }
+
+    _ring->write_tag( tag.offset, pmt::symbol_to_string( tag.key ),
+                      pmt::serialize_str( tag.value ) );
+  }
+
+  if ( meta_changed )
+    publish_meta();
+
+  /* convert straight into the ring */
+  int done = 0;
+  while ( done < noutput_items ) {
+    size_t num = noutput_items - done;
+    char *dst = _ring->prepare( num );
+
+    sample_format_pack( _fmt, in + done, dst, num );
+    _ring->commit( num );
+
+    done += num;
+  }
+
+  return noutput_items;
+}
+
+std::string shm_sink_c::name()
+{
+  return "Shared Memory Sink";
+}
+
+std::vector<std::string> shm_sink_c::get_devices( bool fake )
+{
+  std::vector<std::string> devices;
+
+  if ( fake )
+  {
+    std::string args = "shm=osmosdr,rate=1e6,freq=100e6";
+    args += ",label='Shared Memory Producer'";
+    devices.push_back( args );
+  }
+
+  return devices;
+}
+
+size_t shm_sink_c::get_num_channels( void )
+{
+  return 1;
+}
+
+osmosdr::meta_range_t shm_sink_c::get_sample_rates( void )
+{
+  osmosdr::meta_range_t range;
+
+  range += osmosdr::range_t( 1, 1e9 ); /* whatever the producer runs at */
+
+  return range;
+}
+
+double shm_sink_c::set_sample_rate( double rate )
+{
+  _rate = rate;
+  publish_meta();
+
+  return get_sample_rate();
+}
+
+double shm_sink_c::get_sample_rate( void )
+{
+  return _rate;
+}
+
+osmosdr::freq_range_t shm_sink_c::get_freq_range( size_t chan )
+{
+  return osmosdr::freq_range_t( 0, 1e12 );
+}
+
+double shm_sink_c::set_center_freq( double freq, size_t chan )
+{
+  _freq = freq;
+  publish_meta();
+
+  return get_center_freq( chan );
+}
+
+double shm_sink_c::get_center_freq( size_t chan )
+{
+  return _freq;
+}
+
+double shm_sink_c::set_freq_corr( double ppm, size_t chan )
+{
+  return get_freq_corr( chan );
+}
+
+double shm_sink_c::get_freq_corr( size_t chan )
+{
+  return 0;
+}
+
+std::vector<std::string> shm_sink_c::get_gain_names( size_t chan )
+{
+  return std::vector< std::string >();
+}
+
+osmosdr::gain_range_t shm_sink_c::get_gain_range( size_t chan )
+{
+  return osmosdr::gain_range_t();
+}
+
+osmosdr::gain_range_t shm_sink_c::get_gain_range( const std::string & name, size_t chan )
+{
+  return get_gain_range( chan );
+}
+
+double shm_sink_c::set_gain( double gain, size_t chan )
+{
+  _gain = gain;
+  publish_meta();
+
+  return get_gain( chan );
+}
+
+double shm_sink_c::set_gain( double gain, const std::string & name, size_t chan )
+{
+  return set_gain( gain, chan );
+}
+
+double shm_sink_c::get_gain( size_t chan )
+{
+  return _gain;
+}
+
+double shm_sink_c::get_gain( const std::string & name, size_t chan )
+{
+  return get_gain( chan );
+}
+
+std::vector< std::string > shm_sink_c::get_antennas( size_t chan )
+{
+  return std::vector< std::string >();
+}
+
+std::string shm_sink_c::set_antenna( const std::string & antenna, size_t chan )
+{
+  return get_antenna( chan );
+}
+
+std::string shm_sink_c::get_antenna( size_t chan )
+{
+  return "";
+}
+
+OSMOSDR_REGISTER_SINK( shm, "shm", PROBE_SOFTWARE,
+                         make_shm_sink_c, shm_sink_c::get_devices( fake ) );
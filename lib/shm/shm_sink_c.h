@@ -0,0 +1,103 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef SHM_SINK_C_H
+#define SHM_SINK_C_H
+
+#include <gnuradio/sync_block.h>
+
+#include <boost/scoped_ptr.hpp>
+
+#include "sink_iface.h"
+#include "shm_ring.h"
+
+class shm_sink_c;
+
+typedef boost::shared_ptr< shm_sink_c > shm_sink_c_sptr;
+
+shm_sink_c_sptr make_shm_sink_c( const std::string & args = "" );
+
+/*!
+ * Publishes the input stream, its tags and the rate/frequency/gain
+ * metadata into a shared memory ring for local shm sources to consume.
+ *
+ * Control requests of the consumers are emitted as dictionaries on the
+ * "command" message port, to be connected to the block owning the device.
+ */
+class shm_sink_c :
+    public gr::sync_block,
+    public sink_iface
+{
+private:
+  friend shm_sink_c_sptr make_shm_sink_c(const std::string &args);
+
+  shm_sink_c(const std::string &args);
+
+public:
+  ~shm_sink_c();
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  std::string name();
+
+  static std::vector< std::string > get_devices( bool fake = false );
+
+  size_t get_num_channels( void );
+
+  osmosdr::meta_range_t get_sample_rates( void );
+  double set_sample_rate( double rate );
+  double get_sample_rate( void );
+
+  osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
+  double set_center_freq( double freq, size_t chan = 0 );
+  double get_center_freq( size_t chan = 0 );
+  double set_freq_corr( double ppm, size_t chan = 0 );
+  double get_freq_corr( size_t chan = 0 );
+
+  std::vector<std::string> get_gain_names( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( const std::string & name, size_t chan = 0 );
+  double set_gain( double gain, size_t chan = 0 );
+  double set_gain( double gain, const std::string & name, size_t chan = 0 );
+  double get_gain( size_t chan = 0 );
+  double get_gain( const std::string & name, size_t chan = 0 );
+
+  std::vector< std::string > get_antennas( size_t chan = 0 );
+  std::string set_antenna( const std::string & antenna, size_t chan = 0 );
+  std::string get_antenna( size_t chan = 0 );
+
+  bool has_request_port( void ) { return true; }
+
+private:
+  void publish_meta();
+  void forward_request( const std::string &req );
+
+  boost::scoped_ptr< shm_ring > _ring;
+  sample_format _fmt;
+
+  double _rate;
+  double _freq;
+  double _gain;
+};
+
+#endif // SHM_SINK_C_H
@@ -0,0 +1,378 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <gnuradio/io_signature.h>
+
+#include "shm_source_c.h"
+#include "driver_registry.h"
+
+#include "arg_helpers.h"
+
+#define POLL_INTERVAL_MS  1
+#define POLL_TIMEOUT_MS   100
+
+shm_source_c_sptr make_shm_source_c(const std::string &args)
+{
+  return gnuradio::get_initial_sptr(new shm_source_c(args));
+}
+
+shm_source_c::shm_source_c(const std::string &args) :
+  gr::sync_block("shm_source_c",
+                 gr::io_signature::make(0, 0, 0),
+                 gr::io_signature::make(1, 1, sizeof (gr_complex))),
+  _name("osmosdr"),
+  _control(false),
+  _read_pos(0),
+  _tag_pos(0),
+  _lost(0)
+{
+  dict_t dict = params_to_dict(args);
+
+  if (dict.count("shm") && dict["shm"].length())
+    _name = dict["shm"];
+
+  /* consumers only watch unless they are allowed to steer the device */
+  if (dict.count("control"))
+    _control = boost::lexical_cast< bool >( dict["control"] );
+
+  _ring.reset( new shm_ring( _name ) );
+
+  if ( ! _ring->producer_alive() )
+    std::cerr << "WARNING: The producer of shared memory '" << _name
+              << "' is not running." << std::endl;
+
+  std::cerr << "Using shared memory '" << _name << "' ("
+            << sample_format_sigmf( _ring->get_format() ) << ", "
+            << get_sample_rate() << " sps)" << std::endl;
+}
+
+shm_source_c::~shm_source_c()
+{
+  if ( _lost )
+    std::cerr << "Lost " << _lost << " samples from shared memory '"
+              << _name << "'" << std::endl;
+}
+
+boost::shared_ptr< shm_ring > shm_source_c::ring()
+{
+  boost::mutex::scoped_lock lock( _ring_lock );
+
+  return _ring;
+}
+
+bool shm_source_c::reattach()
+{
+  boost::shared_ptr< shm_ring > ring;
+
+  try {
+    ring.reset( new shm_ring( _name ) );
+  } catch ( std::exception & ) {
+    return false; /* the new ring is not ready yet */
+  }
+
+  {
+    boost::mutex::scoped_lock lock( _ring_lock );
+    _ring = ring;
+  }
+
+  std::cerr << "Reattached to restarted producer of shared memory '"
+            << _name << "'" << std::endl;
+
+  start();
+
+  return true;
+}
+
+bool shm_source_c::start()
+{
+  /* join at the live edge */
+  _read_pos = _ring->get_write_pos();
+  _tag_pos = 0;
+
+  std::vector< shm_ring_tag > stale;
+  _ring->read_tags( _tag_pos, 0, _read_pos, stale );
+
+  return true;
+}
+
+int shm_source_c::work( int noutput_items,
+                        gr_vector_const_void_star &input_items,
+                        gr_vector_void_star &output_items )
+{
+  gr_complex *out = (gr_complex *)output_items[0];
+
+  uint64_t size = _ring->get_size();
+  uint64_t write_pos = _ring->get_write_pos();
+
+  for ( int waited = 0;
+        write_pos == _read_pos && waited < POLL_TIMEOUT_MS;
+        waited += POLL_INTERVAL_MS ) {
+    boost::this_thread::sleep( boost::posix_time::milliseconds(POLL_INTERVAL_MS) );
+    write_pos = _ring->get_write_pos();
+  }
+
+  /* a restarted producer leaves the old ring behind, follow it */
+  if ( write_pos == _read_pos ) {
+    if ( _ring->replaced() )
+      reattach();
+    return 0;
+  }
+
+  uint64_t lost = 0;
+
+  /* keep half a ring of margin when catching up */
+  if ( write_pos - _read_pos > size - size / 4 ) {
+    lost = write_pos - size / 2 - _read_pos;
+    _read_pos += lost;
+  }
+
+  size_t num = std::min( uint64_t(noutput_items), write_pos - _read_pos );
+  uint64_t start = _read_pos;
+
+  for ( size_t done = 0; done < num; ) {
+    uint64_t idx = (start + done) & (size - 1);
+    size_t len = std::min( uint64_t(num - done), size - idx );
+
+    sample_format_unpack( _ring->get_format(), _ring->at( start + done ),
+                          out + done, len );
+    done += len;
+  }
+
+  /* the producer may have overwritten what was just copied */
+  if ( _ring->get_write_pos() - start > size ) {
+    uint64_t skip = std::min( uint64_t(num), _ring->get_write_pos() - start - size );
+    lost += skip;
+    memset( out, 0, skip * sizeof(gr_complex) );
+  }
+
+  _read_pos += num;
+
+  std::vector< shm_ring_tag > tags;
+  if ( ! _ring->read_tags( _tag_pos, start, start + num, tags ) )
+    std::cerr << "T" << std::flush; /* tags lost */
+
+  BOOST_FOREACH( shm_ring_tag &tag, tags ) {
+    try {
+      add_item_tag( 0, nitems_written(0) + (tag.offset - start),
+                    pmt::intern( tag.key ),
+                    pmt::deserialize_str( std::string( tag.value, tag.len ) ) );
+    } catch ( std::exception & ) {
+      /* not deserializable, drop it */
+    }
+  }
+
+  if ( lost ) {
+    _lost += lost;
+    std::cerr << "L" << std::flush;
+    add_item_tag( 0, nitems_written(0), pmt::mp("rx_lost"), pmt::from_uint64( lost ) );
+  }
+
+  return num;
+}
+
+std::string shm_source_c::name()
+{
+  return "Shared Memory Source";
+}
+
+std::vector<std::string> shm_source_c::get_devices( bool fake )
+{
+  std::vector<std::string> devices;
+
+  BOOST_FOREACH( std::string name, shm_ring::list() )
+  {
+    std::string args = "shm=" + name;
+    args += ",label='Shared Memory " + name + "'";
+    devices.push_back( args );
+  }
+
+  return devices;
+}
+
+size_t shm_source_c::get_num_channels( void )
+{
+  return 1;
+}
+
+void shm_source_c::request( const std::string &key, double value )
+{
+  if ( ! _control )
+    return;
+
+  ring()->post_request( key + "=" + boost::lexical_cast< std::string >( value ) );
+}
+
+osmosdr::meta_range_t shm_source_c::get_sample_rates( void )
+{
+  osmosdr::meta_range_t range;
+
+  range += osmosdr::range_t( get_sample_rate() );
+
+  return range;
+}
+
+double shm_source_c::set_sample_rate( double rate )
+{
+  request( "rate", rate );
+
+  return _control ? rate : get_sample_rate();
+}
+
+double shm_source_c::get_sample_rate( void )
+{
+  double rate, freq, gain;
+  ring()->get_meta( rate, freq, gain );
+
+  return rate;
+}
+
+osmosdr::freq_range_t shm_source_c::get_freq_range( size_t chan )
+{
+  return osmosdr::freq_range_t( 0, 1e12 );
+}
+
+double shm_source_c::set_center_freq( double freq, size_t chan )
+{
+  request( "freq", freq );
+
+  /* the producer updates the metadata once it has retuned */
+  return _control ? freq : get_center_freq( chan );
+}
+
+double shm_source_c::get_center_freq( size_t chan )
+{
+  double rate, freq, gain;
+  ring()->get_meta( rate, freq, gain );
+
+  return freq;
+}
+
+double shm_source_c::set_freq_corr( double ppm, size_t chan )
+{
+  request( "ppm", ppm );
+
+  return get_freq_corr( chan );
+}
+
+double shm_source_c::get_freq_corr( size_t chan )
+{
+  return 0;
+}
+
+std::vector<std::string> shm_source_c::get_gain_names( size_t chan )
+{
+  return std::vector< std::string >();
+}
+
+osmosdr::gain_range_t shm_source_c::get_gain_range( size_t chan )
+{
+  return osmosdr::gain_range_t();
+}
+
+osmosdr::gain_range_t shm_source_c::get_gain_range( const std::string & name, size_t chan )
+{
+  return get_gain_range( chan );
+}
+
+bool shm_source_c::set_gain_mode( bool automatic, size_t chan )
+{
+  request( "gain_mode", automatic );
+
+  return automatic;
+}
+
+double shm_source_c::set_gain( double gain, size_t chan )
+{
+  request( "gain", gain );
+
+  return _control ? gain : get_gain( chan );
+}
+
+double shm_source_c::set_gain( double gain, const std::string & name, size_t chan )
+{
+  return set_gain( gain, chan );
+}
+
+double shm_source_c::get_gain( size_t chan )
+{
+  double rate, freq, gain;
+  ring()->get_meta( rate, freq, gain );
+
+  return gain;
+}
+
+double shm_source_c::get_gain( const std::string & name, size_t chan )
+{
+  return get_gain( chan );
+}
+
+double shm_source_c::set_if_gain( double gain, size_t chan )
+{
+  request( "if_gain", gain );
+
+  return gain;
+}
+
+double shm_source_c::set_bb_gain( double gain, size_t chan )
+{
+  request( "bb_gain", gain );
+
+  return gain;
+}
+
+std::vector< std::string > shm_source_c::get_antennas( size_t chan )
+{
+  return std::vector< std::string >();
+}
+
+std::string shm_source_c::set_antenna( const std::string & antenna, size_t chan )
+{
+  if ( _control ) {
+    ring()->post_request( "antenna=" + antenna );
+    _antenna = antenna;
+  }
+
+  return get_antenna( chan );
+}
+
+std::string shm_source_c::get_antenna( size_t chan )
+{
+  return _antenna;
+}
+
+double shm_source_c::set_bandwidth( double bandwidth, size_t chan )
+{
+  request( "bandwidth", bandwidth );
+
+  return bandwidth;
+}
+
+OSMOSDR_REGISTER_SOURCE( shm, "shm", PROBE_SOFTWARE,
+                         make_shm_source_c, shm_source_c::get_devices( fake ) );
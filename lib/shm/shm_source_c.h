@@ -0,0 +1,120 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef SHM_SOURCE_C_H
+#define SHM_SOURCE_C_H
+
+#include <gnuradio/sync_block.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "source_iface.h"
+#include "shm_ring.h"
+
+class shm_source_c;
+
+typedef boost::shared_ptr< shm_source_c > shm_source_c_sptr;
+
+shm_source_c_sptr make_shm_source_c( const std::string & args = "" );
+
+/*!
+ * Consumes the samples published by a shm sink of another local process.
+ *
+ * Each consumer tracks its own read position in the shared ring. When it
+ * falls behind by more than the ring holds, it skips ahead, reports the
+ * number of lost samples on stderr and tags the first sample after the
+ * gap with "rx_lost". Tuning and gain requests are forwarded to the
+ * producer process. When the producer is restarted, the consumer
+ * reattaches to its new ring at the live edge.
+ */
+class shm_source_c :
+    public gr::sync_block,
+    public source_iface
+{
+private:
+  friend shm_source_c_sptr make_shm_source_c(const std::string &args);
+
+  shm_source_c(const std::string &args);
+
+public:
+  ~shm_source_c();
+
+  bool start();
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  std::string name();
+
+  static std::vector< std::string > get_devices( bool fake = false );
+
+  size_t get_num_channels( void );
+
+  osmosdr::meta_range_t get_sample_rates( void );
+  double set_sample_rate( double rate );
+  double get_sample_rate( void );
+
+  osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
+  double set_center_freq( double freq, size_t chan = 0 );
+  double get_center_freq( size_t chan = 0 );
+  double set_freq_corr( double ppm, size_t chan = 0 );
+  double get_freq_corr( size_t chan = 0 );
+
+  std::vector<std::string> get_gain_names( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( const std::string & name, size_t chan = 0 );
+  bool set_gain_mode( bool automatic, size_t chan = 0 );
+  double set_gain( double gain, size_t chan = 0 );
+  double set_gain( double gain, const std::string & name, size_t chan = 0 );
+  double get_gain( size_t chan = 0 );
+  double get_gain( const std::string & name, size_t chan = 0 );
+  double set_if_gain( double gain, size_t chan = 0 );
+  double set_bb_gain( double gain, size_t chan = 0 );
+
+  std::vector< std::string > get_antennas( size_t chan = 0 );
+  std::string set_antenna( const std::string & antenna, size_t chan = 0 );
+  std::string get_antenna( size_t chan = 0 );
+
+  double set_bandwidth( double bandwidth, size_t chan = 0 );
+
+  /* samples lost because this consumer fell behind */
+  uint64_t get_lost( void ) { return _lost; }
+
+private:
+  void request( const std::string &key, double value );
+  boost::shared_ptr< shm_ring > ring();
+  bool reattach();
+
+  /* swapped by work() on reattach, guarded for the control calls */
+  boost::shared_ptr< shm_ring > _ring;
+  boost::mutex _ring_lock;
+  std::string _name;
+  bool _control;
+
+  uint64_t _read_pos;
+  uint64_t _tag_pos;
+  uint64_t _lost;
+  std::string _antenna;
+};
+
+#endif // SHM_SOURCE_C_H
@@ -25,6 +25,8 @@
 #include <osmosdr/time_spec.h>
 #include <gnuradio/basic_block.h>
 
+#include "channel_config.h"
+
 /*!
  * TODO: document
  *
@@ -255,6 +257,17 @@ public:
   virtual osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 )
     { return osmosdr::freq_range_t(); }
 
+  /*!
+   * Apply several settings of a channel at once.
+   * The default applies them one after the other through the setters.
+   * \param settings the settings to change, NaN for those left alone
+   * \param chan the channel index 0 to N-1
+   * \return the actual values of the given settings
+   */
+  virtual osmosdr::channel_settings configure( const osmosdr::channel_settings &settings,
+                                               size_t chan = 0 )
+    { return apply_channel_settings( this, settings, chan ); }
+
   /*!
    * Set the time source for the device.
    * This sets the method of time synchronization,
@@ -363,6 +376,18 @@ public:
    * \param time_spec the new time
    */
   virtual void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec) { }
+
+  /*!
+   * Whether the block takes messages on a "command" input port, which
+   * will then be exposed by the osmosdr sink.
+   */
+  virtual bool has_command_port( void ) { return false; }
+
+  /*!
+   * Whether the block emits requests on a "command" output port, meant
+   * for the block owning the device.
+   */
+  virtual bool has_request_port( void ) { return false; }
 };
 
 #endif // OSMOSDR_SINK_IFACE_H
@@ -27,32 +27,17 @@
 #include "config.h"
 #endif
 
+#include <cmath>
+
 #include <gnuradio/io_signature.h>
 #include <gnuradio/constants.h>
 
-#ifdef ENABLE_UHD
-#include "uhd_sink_c.h"
-#endif
-#ifdef ENABLE_HACKRF
-#include "hackrf_sink_c.h"
-#endif
-#ifdef ENABLE_BLADERF
-#include "bladerf_sink_c.h"
-#endif
-#ifdef ENABLE_SOAPY
-#include "soapy_sink_c.h"
-#endif
-#ifdef ENABLE_REDPITAYA
-#include "redpitaya_sink_c.h"
-#endif
-#ifdef ENABLE_FREESRP
-#include <freesrp_sink_c.h>
-#endif
-#ifdef ENABLE_FILE
-#include "file_sink_c.h"
-#endif
+#include <boost/bind.hpp>
 
 #include "arg_helpers.h"
+#include "command_handler.h"
+#include "driver_registry.h"
+#include "resampler_cc.h"
 #include "sink_impl.h"
 
 /*
@@ -72,85 +57,33 @@ sink_impl::sink_impl( const std::string &args )
   : gr::hier_block2 ("sink_impl",
         args_to_io_signature(args),
         gr::io_signature::make(0, 0, 0)),
-    _sample_rate(NAN)
+    _sample_rate(NAN),
+    _exact_rate(false)
 {
   size_t channel = 0;
   bool device_specified = false;
 
   std::vector< std::string > arg_list = args_to_vector(args);
 
-  std::vector< std::string > dev_types;
-
-#ifdef ENABLE_UHD
-  dev_types.push_back("uhd");
-#endif
-#ifdef ENABLE_HACKRF
-  dev_types.push_back("hackrf");
-#endif
-#ifdef ENABLE_BLADERF
-  dev_types.push_back("bladerf");
-#endif
-#ifdef ENABLE_SOAPY
-  dev_types.push_back("soapy");
-#endif
-#ifdef ENABLE_REDPITAYA
-  dev_types.push_back("redpitaya");
-#endif
-#ifdef ENABLE_FREESRP
-  dev_types.push_back("freesrp");
-#endif
-#ifdef ENABLE_FILE
-  dev_types.push_back("file");
-#endif
-
   std::cerr << "gr-osmosdr "
             << GR_OSMOSDR_VERSION << " (" << GR_OSMOSDR_LIBVER << ") "
             << "gnuradio " << gr::version() << std::endl;
   std::cerr << "built-in sink types: ";
-  BOOST_FOREACH(std::string dev_type, dev_types)
+  BOOST_FOREACH(std::string dev_type, sink_types())
     std::cerr << dev_type << " ";
   std::cerr << std::endl;
 
   BOOST_FOREACH(std::string arg, arg_list) {
-    dict_t dict = params_to_dict(arg);
-    BOOST_FOREACH(std::string dev_type, dev_types) {
-      if ( dict.count( dev_type ) ) {
-        device_specified = true;
-        break;
-      }
+    sink_driver driver;
+    if ( find_sink_driver( params_to_dict(arg), driver ) ) {
+      device_specified = true;
+      break;
     }
   }
 
   if ( ! device_specified ) {
-    std::vector< std::string > dev_list;
-#ifdef ENABLE_UHD
-    BOOST_FOREACH( std::string dev, uhd_sink_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_BLADERF
-    BOOST_FOREACH( std::string dev, bladerf_sink_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_HACKRF
-    BOOST_FOREACH( std::string dev, hackrf_sink_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_SOAPY
-    BOOST_FOREACH( std::string dev, soapy_sink_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_REDPITAYA
-    BOOST_FOREACH( std::string dev, redpitaya_sink_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_FREESRP
-    BOOST_FOREACH( std::string dev, freesrp_sink_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_FILE
-    BOOST_FOREACH( std::string dev, file_sink_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
+    std::vector< std::string > dev_list =
+      probe_devices( sink_probes(), osmosdr::device_t("nofake,nosoftware") );
 
 //    std::cerr << std::endl;
 //    BOOST_FOREACH( std::string dev, dev_list )
@@ -162,6 +95,9 @@ sink_impl::sink_impl( const std::string &args )
       throw std::runtime_error("No supported devices found (check the connection and/or udev rules).");
   }
 
+  std::vector< gr::basic_block_sptr > cmd_blocks;
+  std::vector< gr::basic_block_sptr > req_blocks;
+
   BOOST_FOREACH(std::string arg, arg_list) {
 
     dict_t dict = params_to_dict(arg);
@@ -170,57 +106,37 @@ sink_impl::sink_impl( const std::string &args )
 //    BOOST_FOREACH( dict_t::value_type &entry, dict )
 //      std::cerr << "'" << entry.first << "' = '" << entry.second << "'" << std::endl;
 
+    if ( dict.count("rate_mode") )
+      _exact_rate = parse_rate_mode( dict["rate_mode"] );
+
     sink_iface *iface = NULL;
     gr::basic_block_sptr block;
 
-#ifdef ENABLE_UHD
-    if ( dict.count("uhd") ) {
-      uhd_sink_c_sptr sink = make_uhd_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
-#endif
-#ifdef ENABLE_HACKRF
-    if ( dict.count("hackrf") ) {
-      hackrf_sink_c_sptr sink = make_hackrf_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
-#endif
-#ifdef ENABLE_BLADERF
-    if ( dict.count("bladerf") ) {
-      bladerf_sink_c_sptr sink = make_bladerf_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
-#endif
-#ifdef ENABLE_SOAPY
-    if ( dict.count("soapy") ) {
-      soapy_sink_c_sptr sink = make_soapy_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
-#endif
-#ifdef ENABLE_REDPITAYA
-    if ( dict.count("redpitaya") ) {
-      redpitaya_sink_c_sptr sink = make_redpitaya_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
-#endif
-#ifdef ENABLE_FREESRP
-    if ( dict.count("freesrp") ) {
-      freesrp_sink_c_sptr sink = make_freesrp_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
-#endif
-#ifdef ENABLE_FILE
-    if ( dict.count("file") ) {
-      file_sink_c_sptr sink = make_file_sink_c( arg );
-      block = sink; iface = sink.get();
-    }
-#endif
+    sink_driver driver;
+    if ( find_sink_driver( dict, driver ) )
+      block = driver.make( arg, iface );
+
+    if ( iface != NULL && iface->has_command_port() )
+      cmd_blocks.push_back( block );
+
+    if ( iface != NULL && iface->has_request_port() )
+      req_blocks.push_back( block );
 
     if ( iface != NULL && long(block.get()) != 0 ) {
       _devs.push_back( iface );
+      _routes.add_device( iface, _devs.size() - 1 );
 
       for (size_t i = 0; i < iface->get_num_channels(); i++) {
-        connect(self(), channel++, block, i);
+        if ( _exact_rate ) {
+          resampler_cc_sptr resampler = make_resampler_cc();
+
+          connect(self(), channel++, resampler, 0);
+          connect(resampler, 0, block, i);
+
+          _resamplers.push_back( resampler );
+        } else {
+          connect(self(), channel++, block, i);
+        }
       }
     } else if ( (iface != NULL) || (long(block.get()) != 0) )
       throw std::runtime_error("Either iface or block are NULL.");
@@ -229,24 +145,51 @@ sink_impl::sink_impl( const std::string &args )
 
   if (!_devs.size())
     throw std::runtime_error("No devices specified via device arguments.");
+
+  /* settings sent as commands are applied on the thread of their handler */
+  command_handler_sptr commands =
+      make_command_handler( boost::bind( &apply_command< sink_impl >, this, _1 ) );
+
+  message_port_register_hier_in( pmt::mp("command") );
+  message_port_register_hier_out( pmt::mp("status") );
+
+  msg_connect( self(), pmt::mp("command"), commands, pmt::mp("command") );
+  msg_connect( commands, pmt::mp("status"), self(), pmt::mp("status") );
+
+  /* also forward them (e.g. capture triggers) to the devices taking them */
+  BOOST_FOREACH( gr::basic_block_sptr block, cmd_blocks )
+    msg_connect( self(), pmt::mp("command"), block, pmt::mp("command") );
+
+  /* requests of shared memory consumers, for the owner of the device */
+  if ( ! req_blocks.empty() ) {
+    message_port_register_hier_out( pmt::mp("command") );
+
+    BOOST_FOREACH( gr::basic_block_sptr block, req_blocks )
+      msg_connect( block, pmt::mp("command"), self(), pmt::mp("command") );
+  }
 }
 
-size_t sink_impl::get_num_channels()
+void sink_impl::invalidate_caps( size_t chan )
 {
-  size_t channels = 0;
-
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    channels += dev->get_num_channels();
+  _ranges.invalidate( chan );
+  _names.invalidate( chan );
+}
 
-  return channels;
+size_t sink_impl::get_num_channels()
+{
+  return _routes.size();
 }
 
 #define NO_DEVICES_MSG  "FATAL: No device(s) available to work with."
 
 osmosdr::meta_range_t sink_impl::get_sample_rates()
 {
-  if ( ! _devs.empty() )
-    return _devs[0]->get_sample_rates(); // assume same devices used in the group
+  /* the resamplers start from any rate up to the highest one of the device */
+  if ( ! _devs.empty() && _exact_rate )
+    return osmosdr::meta_range_t( 1, get_native_rates( 0 ).stop() );
+
+  if ( ! _devs.empty() ) // assume same devices used in the group
+    return get_native_rates( 0 );
 #if 0
   else
     throw std::runtime_error(NO_DEVICES_MSG);
@@ -254,6 +197,22 @@ osmosdr::meta_range_t sink_impl::get_sample_rates()
   return osmosdr::meta_range_t();
 }
 
+osmosdr::meta_range_t sink_impl::get_native_rates( size_t dev_index )
+{
+  sink_iface *dev = _devs[ dev_index ];
+
+  return _ranges.get( _routes.first( dev_index ), "rates",
+                      [dev]() { return dev->get_sample_rates(); } );
+}
+
+/* the channels of the device at dev_index are resampled from rate to native */
+void sink_impl::set_exact_rate( size_t dev_index, double native, double rate )
+{
+  for (size_t chan = 0; chan < _routes.size(); chan++)
+    if ( _routes.find( chan )->dev_index == dev_index && chan < _resamplers.size() )
+      _resamplers[ chan ]->set_rates( rate, native );
+}
+
 double sink_impl::set_sample_rate(double rate)
 {
   double sample_rate = 0;
@@ -263,10 +222,20 @@ double sink_impl::set_sample_rate(double rate)
     if (_devs.empty())
       throw std::runtime_error(NO_DEVICES_MSG);
 #endif
-    BOOST_FOREACH( sink_iface *dev, _devs )
-      sample_rate = dev->set_sample_rate(rate);
+    for (size_t i = 0; i < _devs.size(); i++) {
+      if ( _exact_rate ) {
+        double native = _devs[i]->set_sample_rate( pick_native_rate( get_native_rates( i ), rate ) );
+        set_exact_rate( i, native, rate );
+        sample_rate = rate;
+      } else {
+        sample_rate = _devs[i]->set_sample_rate(rate);
+      }
+    }
 
     _sample_rate = sample_rate;
+
+    /* filter ranges may follow the rate */
+    _ranges.invalidate();
   }
 
   return sample_rate;
@@ -276,6 +245,9 @@ double sink_impl::get_sample_rate()
 {
   double sample_rate = 0;
 
+  if ( _exact_rate && ! std::isnan( _sample_rate ) )
+    return _sample_rate;
+
   if (!_devs.empty())
     sample_rate = _devs[0]->get_sample_rate(); // assume same devices used in the group
 #if 0
@@ -287,299 +259,334 @@ double sink_impl::get_sample_rate()
 
 osmosdr::freq_range_t sink_impl::get_freq_range( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_freq_range( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _ranges.get( chan, "freq",
+                        [route]() { return route->dev->get_freq_range( route->dev_chan ); } );
 
   return osmosdr::freq_range_t();
 }
 
 double sink_impl::set_center_freq( double freq, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _center_freq[ chan ] != freq ) {
-          _center_freq[ chan ] = freq;
-          return dev->set_center_freq( freq, dev_chan );
-        } else { return _center_freq[ chan ]; }
-      }
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    sink_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    if ( _center_freq[ chan ] != freq ) {
+      _center_freq[ chan ] = freq;
+      return dev->set_center_freq( freq, dev_chan );
+    } else { return _center_freq[ chan ]; }
+  }
 
   return 0;
 }
 
 double sink_impl::get_center_freq( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_center_freq( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return route->dev->get_center_freq( route->dev_chan );
 
   return 0;
 }
 
 double sink_impl::set_freq_corr( double ppm, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _freq_corr[ chan ] != ppm ) {
-          _freq_corr[ chan ] = ppm;
-          return dev->set_freq_corr( ppm, dev_chan );
-        } else { return _freq_corr[ chan ]; }
-      }
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    sink_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    if ( _freq_corr[ chan ] != ppm ) {
+      _freq_corr[ chan ] = ppm;
+      return dev->set_freq_corr( ppm, dev_chan );
+    } else { return _freq_corr[ chan ]; }
+  }
 
   return 0;
 }
 
 double sink_impl::get_freq_corr( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_freq_corr( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return route->dev->get_freq_corr( route->dev_chan );
 
   return 0;
 }
 
 std::vector<std::string> sink_impl::get_gain_names( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain_names( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _names.get( chan, "gains",
+                        [route]() { return route->dev->get_gain_names( route->dev_chan ); } );
 
   return std::vector< std::string >();
 }
 
 osmosdr::gain_range_t sink_impl::get_gain_range( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain_range( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _ranges.get( chan, "gain",
+                        [route]() { return route->dev->get_gain_range( route->dev_chan ); } );
 
   return osmosdr::gain_range_t();
 }
 
 osmosdr::gain_range_t sink_impl::get_gain_range( const std::string & name, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain_range( name, dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _ranges.get( chan, "gain:" + name,
+                        [route, name]() {
+                          return route->dev->get_gain_range( name, route->dev_chan );
+                        } );
 
   return osmosdr::gain_range_t();
 }
 
 bool sink_impl::set_gain_mode( bool automatic, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _gain_mode[ chan ] != automatic ) {
-          _gain_mode[ chan ] = automatic;
-          bool mode = dev->set_gain_mode( automatic, dev_chan );
-          if (!automatic) // reapply gain value when switched to manual mode
-            dev->set_gain( _gain[ chan ], dev_chan );
-          return mode;
-        } else { return _gain_mode[ chan ]; }
-      }
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    sink_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    if ( _gain_mode[ chan ] != automatic ) {
+      _gain_mode[ chan ] = automatic;
+      bool mode = dev->set_gain_mode( automatic, dev_chan );
+      if (!automatic) // reapply gain value when switched to manual mode
+        dev->set_gain( _gain[ chan ], dev_chan );
+      return mode;
+    } else { return _gain_mode[ chan ]; }
+  }
 
   return false;
 }
 
 bool sink_impl::get_gain_mode( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain_mode( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return route->dev->get_gain_mode( route->dev_chan );
 
   return false;
 }
 
 double sink_impl::set_gain( double gain, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _gain[ chan ] != gain ) {
-          _gain[ chan ] = gain;
-          return dev->set_gain( gain, dev_chan );
-        } else { return _gain[ chan ]; }
-      }
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    sink_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    if ( _gain[ chan ] != gain ) {
+      _gain[ chan ] = gain;
+      return dev->set_gain( gain, dev_chan );
+    } else { return _gain[ chan ]; }
+  }
 
   return 0;
 }
 
 double sink_impl::set_gain( double gain, const std::string & name, size_t chan)
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->set_gain( gain, name, dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return route->dev->set_gain( gain, name, route->dev_chan );
 
   return 0;
 }
 
 double sink_impl::get_gain( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return route->dev->get_gain( route->dev_chan );
 
   return 0;
 }
 
 double sink_impl::get_gain( const std::string & name, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain( name, dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return route->dev->get_gain( name, route->dev_chan );
 
   return 0;
 }
 
 double sink_impl::set_if_gain( double gain, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _if_gain[ chan ] != gain ) {
-          _if_gain[ chan ] = gain;
-          return dev->set_if_gain( gain, dev_chan );
-        } else { return _if_gain[ chan ]; }
-      }
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    sink_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    if ( _if_gain[ chan ] != gain ) {
+      _if_gain[ chan ] = gain;
+      return dev->set_if_gain( gain, dev_chan );
+    } else { return _if_gain[ chan ]; }
+  }
 
   return 0;
 }
 
 double sink_impl::set_bb_gain( double gain, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _bb_gain[ chan ] != gain ) {
-          _bb_gain[ chan ] = gain;
-          return dev->set_bb_gain( gain, dev_chan );
-        } else { return _bb_gain[ chan ]; }
-      }
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    sink_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    if ( _bb_gain[ chan ] != gain ) {
+      _bb_gain[ chan ] = gain;
+      return dev->set_bb_gain( gain, dev_chan );
+    } else { return _bb_gain[ chan ]; }
+  }
 
   return 0;
 }
 
 std::vector< std::string > sink_impl::get_antennas( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_antennas( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _names.get( chan, "antennas",
+                        [route]() { return route->dev->get_antennas( route->dev_chan ); } );
 
   return std::vector< std::string >();
 }
 
 std::string sink_impl::set_antenna( const std::string & antenna, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _antenna[ chan ] != antenna ) {
-          _antenna[ chan ] = antenna;
-          return dev->set_antenna( antenna, dev_chan );
-        } else { return _antenna[ chan ]; }
-      }
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    sink_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    if ( _antenna[ chan ] != antenna ) {
+      _antenna[ chan ] = antenna;
+      invalidate_caps( chan ); /* other ports may cover other ranges */
+      return dev->set_antenna( antenna, dev_chan );
+    } else { return _antenna[ chan ]; }
+  }
 
   return "";
 }
 
 std::string sink_impl::get_antenna( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_antenna( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return route->dev->get_antenna( route->dev_chan );
 
   return "";
 }
 
 void sink_impl::set_dc_offset( const std::complex<double> &offset, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        dev->set_dc_offset( offset, dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    route->dev->set_dc_offset( offset, route->dev_chan );
 }
 
 void sink_impl::set_iq_balance( const std::complex<double> &balance, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        dev->set_iq_balance( balance, dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    route->dev->set_iq_balance( balance, route->dev_chan );
 }
 
 double sink_impl::set_bandwidth( double bandwidth, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _bandwidth[ chan ] != bandwidth || 0.0f == bandwidth ) {
-          _bandwidth[ chan ] = bandwidth;
-          return dev->set_bandwidth( bandwidth, dev_chan );
-        } else { return _bandwidth[ chan ]; }
-      }
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    sink_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    if ( _bandwidth[ chan ] != bandwidth || 0.0f == bandwidth ) {
+      _bandwidth[ chan ] = bandwidth;
+      return dev->set_bandwidth( bandwidth, dev_chan );
+    } else { return _bandwidth[ chan ]; }
+  }
 
   return 0;
 }
 
 double sink_impl::get_bandwidth( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_bandwidth( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return route->dev->get_bandwidth( route->dev_chan );
 
   return 0;
 }
 
 osmosdr::freq_range_t sink_impl::get_bandwidth_range( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( sink_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_bandwidth_range( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _ranges.get( chan, "bandwidth",
+                        [route]() { return route->dev->get_bandwidth_range( route->dev_chan ); } );
 
   return osmosdr::freq_range_t();
 }
 
+osmosdr::channel_settings sink_impl::configure( const osmosdr::channel_settings &settings,
+                                                  size_t chan )
+{
+  typedef osmosdr::channel_settings cs;
+
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    sink_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    /* keep the caches of the individual setters in sync, the rate
+     * only changes on this device so the group rate is unknown now */
+    if ( cs::is_set( settings.sample_rate ) ) {
+      _sample_rate = NAN;
+      _ranges.invalidate();
+    }
+    if ( cs::is_set( settings.center_freq ) )
+      _center_freq[ chan ] = settings.center_freq;
+    if ( cs::is_set( settings.gain ) )
+      _gain[ chan ] = settings.gain;
+    if ( cs::is_set( settings.if_gain ) )
+      _if_gain[ chan ] = settings.if_gain;
+    if ( cs::is_set( settings.bb_gain ) )
+      _bb_gain[ chan ] = settings.bb_gain;
+    if ( cs::is_set( settings.bandwidth ) )
+      _bandwidth[ chan ] = settings.bandwidth;
+    if ( ! settings.antenna.empty() ) {
+      _antenna[ chan ] = settings.antenna;
+      invalidate_caps( chan );
+    }
+
+    /* with exact rates the device runs at a native rate close by */
+    osmosdr::channel_settings native = settings;
+    if ( _exact_rate && cs::is_set( settings.sample_rate ) )
+      native.sample_rate = pick_native_rate( get_native_rates( route->dev_index ),
+                                             settings.sample_rate );
+
+    osmosdr::channel_settings actual = dev->configure( native, dev_chan );
+
+    if ( _exact_rate && cs::is_set( settings.sample_rate ) ) {
+      set_exact_rate( route->dev_index, dev->get_sample_rate(), settings.sample_rate );
+      actual.sample_rate = settings.sample_rate;
+    }
+
+    return actual;
+  }
+
+  return osmosdr::channel_settings();
+}
+
 void sink_impl::set_time_source(const std::string &source, const size_t mboard)
 {
   if (mboard != osmosdr::ALL_MBOARDS){
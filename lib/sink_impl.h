@@ -23,9 +23,14 @@
 #include "osmosdr/sink.h"
 
 #include "sink_iface.h"
+#include "channel_routes.h"
 
 #include <map>
 
+#include <boost/shared_ptr.hpp>
+
+class resampler_cc;
+
 class sink_impl : public osmosdr::sink
 {
 public:
@@ -68,6 +73,9 @@ public:
   double get_bandwidth( size_t chan = 0 );
   osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
 
+  osmosdr::channel_settings configure( const osmosdr::channel_settings &settings,
+                                       size_t chan = 0 );
+
   void set_time_source(const std::string &source, const size_t mboard = 0);
   std::string get_time_source(const size_t mboard);
   std::vector<std::string> get_time_sources(const size_t mboard);
@@ -83,7 +91,17 @@ public:
   void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec);
 
 private:
+  typedef channel_routes< sink_iface >::route route_t;
+
+  void invalidate_caps( size_t chan );
+  osmosdr::meta_range_t get_native_rates( size_t dev_index );
+  void set_exact_rate( size_t dev_index, double native, double rate );
+
   std::vector< sink_iface * > _devs;
+  channel_routes< sink_iface > _routes;
+
+  caps_cache< osmosdr::meta_range_t > _ranges;
+  caps_cache< std::vector< std::string > > _names;
 
   /* cache to prevent multiple device calls with the same value coming from grc */
   double _sample_rate;
@@ -95,6 +113,9 @@ private:
   std::map< size_t, double > _bb_gain;
   std::map< size_t, std::string > _antenna;
   std::map< size_t, double > _bandwidth;
+
+  bool _exact_rate; /* rate_mode=exact, resampling to a native rate */
+  std::vector< boost::shared_ptr< resampler_cc > > _resamplers;
 };
 
 #endif /* INCLUDED_OSMOSDR_SINK_IMPL_H */
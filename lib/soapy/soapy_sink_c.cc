@@ -39,6 +39,7 @@
 
 #include "arg_helpers.h"
 #include "soapy_sink_c.h"
+#include "driver_registry.h"
 #include "soapy_common.h"
 #include <SoapySDR/Device.hpp>
 #include <SoapySDR/Version.hpp>
@@ -390,3 +391,5 @@ void soapy_sink_c::set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec)
     _device->setHardwareTime(time_spec.to_ticks(1e9), "UNKNOWN_PPS");
 }
 
+OSMOSDR_REGISTER_SINK( soapy, "soapy", PROBE_USB | PROBE_NETWORK,
+                         make_soapy_sink_c, soapy_sink_c::get_devices() );
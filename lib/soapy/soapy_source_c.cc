@@ -39,6 +39,7 @@
 
 #include "arg_helpers.h"
 #include "soapy_source_c.h"
+#include "driver_registry.h"
 #include "soapy_common.h"
 #include "osmosdr/source.h"
 #include <SoapySDR/Device.hpp>
@@ -101,6 +102,13 @@ int soapy_source_c::work( int noutput_items,
         noutput_items, flags, timeNs);
 
     if (ret < 0) return 0; //call again
+
+    for (size_t i = 0; i < _nchan; i++)
+    {
+        gr::tag_t tag;
+        if (ret > 0 && _retune.take(i, nitems_written(i), tag))
+            this->add_item_tag(i, tag);
+    }
     return ret;
 }
 
@@ -346,6 +354,21 @@ osmosdr::freq_range_t soapy_source_c::get_bandwidth_range( size_t chan )
     return result;
 }
 
+double soapy_source_c::get_settle_time( size_t chan )
+{
+    if (_device->getDriverKey() == "lime")
+        return tuner_settle_time("LMS7002M");
+    return tuner_settle_time("");
+}
+
+osmosdr::channel_settings soapy_source_c::configure( const osmosdr::channel_settings &settings,
+                                                     size_t chan )
+{
+    osmosdr::channel_settings actual = apply_channel_settings(this, settings, chan);
+    _retune.arm(chan, actual);
+    return actual;
+}
+
 void soapy_source_c::set_time_source(const std::string &source,
                                const size_t)
 {
@@ -413,3 +436,6 @@ void soapy_source_c::set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spe
 {
     _device->setHardwareTime(time_spec.to_ticks(1e9), "UNKNOWN_PPS");
 }
+
+OSMOSDR_REGISTER_SOURCE( soapy, "soapy", PROBE_USB | PROBE_NETWORK,
+                         make_soapy_source_c, soapy_source_c::get_devices() );
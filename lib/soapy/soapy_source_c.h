@@ -114,6 +114,9 @@ void set_iq_balance( const std::complex<double> &balance, size_t chan );
 double set_bandwidth( double bandwidth, size_t chan );
 double get_bandwidth( size_t chan ) ;
 osmosdr::freq_range_t get_bandwidth_range( size_t chan );
+osmosdr::channel_settings configure( const osmosdr::channel_settings &settings,
+                                     size_t chan );
+double get_settle_time( size_t chan );
 void set_time_source(const std::string &source,
                                const size_t mboard);
 std::string get_time_source(const size_t mboard);
@@ -135,6 +138,7 @@ private:
     SoapySDR::Device *_device;
     SoapySDR::Stream *_stream;
     size_t _nchan;
+    retune_tags _retune;
 };
 
 #endif /* INCLUDED_SOAPY_SOURCE_C_H */
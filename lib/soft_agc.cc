@@ -0,0 +1,150 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "soft_agc.h"
+
+#define WINDOW     0.05   /* seconds */
+#define HOLD       0.25   /* seconds after a gain step */
+#define CLIP_LIMIT 1e-4   /* ratio of clipped components */
+#define CLIP_HEAVY 1e-2   /* ratio of clipped components */
+#define HEAVY_STEPS 3
+#define UP_PEAK    32     /* -12 dBFS */
+
+soft_agc::soft_agc() :
+  _held( 0 ),
+  _queued( false )
+{
+  _current = _last = window_stats();
+  set_sample_rate( 2.048e6 );
+}
+
+void soft_agc::set_sample_rate( double rate )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _window_len = std::max( uint64_t(rate * WINDOW), uint64_t(1) );
+  _hold_len = uint64_t(rate * HOLD);
+}
+
+void soft_agc::accumulate( const unsigned char *iq, size_t n, bool is_signed,
+                           window_stats &stats )
+{
+  /* integer sums over both components, offset binary is centered at 128 */
+  uint64_t clipped = 0, energy = 0;
+  int peak = stats.peak;
+
+  for (size_t i = 0; i < n * 2; ++i) {
+    int s = is_signed ? int(int8_t(iq[i])) : int(iq[i]) - 128;
+    int a = s < 0 ? -s : s;
+
+    peak = std::max( peak, a );
+    clipped += (s == -128 || s == 127);
+    energy += uint64_t(s * s);
+  }
+
+  stats.samples += n;
+  stats.clipped += clipped;
+  stats.peak = peak;
+  stats.energy += energy;
+}
+
+bool soft_agc::measure( const unsigned char *iq, size_t n, bool is_signed )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  accumulate( iq, n, is_signed, _current );
+  _held += n;
+
+  if ( _current.samples < _window_len )
+    return false;
+
+  _last = _current;
+  _current = window_stats();
+
+  return true;
+}
+
+soft_agc::window_stats soft_agc::last()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  return _last;
+}
+
+size_t soft_agc::step( size_t current, size_t count )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _queued = false;
+
+  if ( ! count || ! _last.samples || _held < _hold_len )
+    return current;
+
+  double clip_ratio = double(_last.clipped) / (_last.samples * 2);
+  size_t next = current;
+
+  if ( clip_ratio > CLIP_LIMIT ) {
+    size_t steps = clip_ratio > CLIP_HEAVY ? HEAVY_STEPS : 1;
+    next = current > steps ? current - steps : 0;
+  } else if ( _last.peak < UP_PEAK && current + 1 < count ) {
+    next = current + 1;
+  }
+
+  if ( next != current ) {
+    /* the partial window and the queued samples are still at the old gain */
+    _held = 0;
+    _current = window_stats();
+  }
+
+  return next;
+}
+
+bool soft_agc::queue_step()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( _queued || ! _last.samples || _held < _hold_len )
+    return false;
+
+  _queued = true;
+
+  return true;
+}
+
+pmt::pmt_t soft_agc::to_pmt()
+{
+  window_stats stats = last();
+
+  double samples = std::max( stats.samples, uint64_t(1) );
+  double peak = 20 * std::log10( std::max( stats.peak, 1 ) / 128.0 );
+  double power = 10 * std::log10( std::max( stats.energy / samples, 1.0 ) / (128.0 * 128.0) );
+
+  pmt::pmt_t dict = pmt::make_dict();
+  dict = pmt::dict_add( dict, pmt::mp( "peak" ), pmt::from_double( peak ) );
+  dict = pmt::dict_add( dict, pmt::mp( "power" ), pmt::from_double( power ) );
+  dict = pmt::dict_add( dict, pmt::mp( "clipped" ),
+                        pmt::from_double( stats.clipped / (samples * 2) ) );
+  return dict;
+}
@@ -0,0 +1,101 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_SOFT_AGC_H
+#define OSMOSDR_SOFT_AGC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <boost/thread/mutex.hpp>
+
+#include <pmt/pmt.h>
+
+#include <osmosdr/api.h>
+
+/*
+ * Gain control on the host for 8 bit front-ends, driven by the statistics
+ * of their raw samples. measure() collects the peak, the number of clipped
+ * components and the energy of the samples in windows of WINDOW seconds.
+ * After each window step() picks the next position on the gain ladder of
+ * the device: one step down as soon as more than CLIP_LIMIT of the
+ * components clip, several on heavy clipping, and one step up once the
+ * peak stays below UP_PEAK. The gap between both thresholds exceeds any
+ * single step of the ladders, so the loop does not toggle between two
+ * neighbouring gains. After a step the loop holds for HOLD seconds, which
+ * covers the samples still queued at the old gain and limits the rate of
+ * gain changes.
+ */
+class OSMOSDR_API soft_agc
+{
+public:
+  struct window_stats
+  {
+    uint64_t samples;
+    uint64_t clipped; /* I or Q components at either end of the range */
+    int peak;         /* the largest magnitude of a component, up to 128 */
+    uint64_t energy;  /* the sum of I^2 + Q^2 */
+  };
+
+  soft_agc();
+
+  /* the raw sample rate sets the length of the windows and the hold */
+  void set_sample_rate( double rate );
+
+  /*
+   * Measures n samples of 8 bit I/Q, offset binary unless is_signed is
+   * set, and returns true whenever a window is complete.
+   */
+  bool measure( const unsigned char *iq, size_t n, bool is_signed );
+
+  /* the statistics of the last complete window */
+  window_stats last();
+
+  /*
+   * Returns the position to go to on a ladder of count gains, ordered from
+   * the lowest, given the current position after the last window. The
+   * current position is returned while nothing is to change.
+   */
+  size_t step( size_t current, size_t count );
+
+  /*
+   * Returns true when a step is due and none is queued yet. The caller
+   * then queues one call of step() off the streaming thread.
+   */
+  bool queue_step();
+
+  /* the last window as dictionary of peak and power in dBFS and clip ratio */
+  pmt::pmt_t to_pmt();
+
+private:
+  static void accumulate( const unsigned char *iq, size_t n, bool is_signed,
+                          window_stats &stats );
+
+  boost::mutex _mutex;
+  uint64_t _window_len;
+  uint64_t _hold_len;
+  uint64_t _held; /* samples measured since the last step */
+  bool _queued;   /* a call of step() is pending */
+  window_stats _current;
+  window_stats _last;
+};
+
+#endif // OSMOSDR_SOFT_AGC_H
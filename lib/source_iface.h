@@ -25,6 +25,13 @@
 #include <osmosdr/time_spec.h>
 #include <gnuradio/basic_block.h>
 
+#include <boost/shared_ptr.hpp>
+
+#include "channel_config.h"
+#include "tuner_settle.h"
+
+class device_executor;
+
 /*!
  * TODO: document
  *
@@ -287,6 +294,42 @@ public:
   virtual osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 )
     { return osmosdr::freq_range_t(); }
 
+  /*!
+   * Apply several settings of a channel at once.
+   * The default applies them one after the other through the setters.
+   * \param settings the settings to change, NaN for those left alone
+   * \param chan the channel index 0 to N-1
+   * \return the actual values of the given settings
+   */
+  virtual osmosdr::channel_settings configure( const osmosdr::channel_settings &settings,
+                                               size_t chan = 0 )
+    { return apply_channel_settings( this, settings, chan ); }
+
+  /*!
+   * Get the time the tuner needs to settle after a retune.
+   * Samples received within it are discarded while hopping.
+   * \param chan the channel index 0 to N-1
+   * \return the settle time in seconds
+   */
+  virtual double get_settle_time( size_t chan = 0 )
+    { return tuner_settle_time( "" ); }
+
+  /*!
+   * Whether the device tags the first sample received after a change of
+   * the center frequency, sample rate or gain with rx_freq, rx_rate or
+   * rx_gain. Hopping starts the settle time at that tag when it does.
+   */
+  virtual bool tags_changes() { return false; }
+
+  /*!
+   * Set the executor that runs the control calls of the device. Devices
+   * that change their settings on their own, like the host gain control,
+   * queue those changes there instead of calling the driver from work().
+   * A null executor hands it back, the device then uses one of its own.
+   * \param exec the executor of the device
+   */
+  virtual void set_executor( const boost::shared_ptr< device_executor > &exec ) {}
+
   /*!
    * Set the time source for the device.
    * This sets the method of time synchronization,
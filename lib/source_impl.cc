@@ -27,81 +27,50 @@
 #include "config.h"
 #endif
 
+#include <set>
+
 #include <gnuradio/io_signature.h>
 #include <gnuradio/blocks/null_source.h>
 #include <gnuradio/blocks/throttle.h>
 #include <gnuradio/constants.h>
 
-#ifdef ENABLE_OSMOSDR
-#include <osmosdr_src_c.h>
-#endif
-
-#ifdef ENABLE_FCD
-#include <fcd_source_c.h>
-#endif
-
-#ifdef ENABLE_FILE
-#include <file_source_c.h>
-#endif
-
-#ifdef ENABLE_RTL
-#include <rtl_source_c.h>
-#endif
-
-#ifdef ENABLE_RTL_TCP
-#include <rtl_tcp_source_c.h>
-#endif
-
-#ifdef ENABLE_UHD
-#include <uhd_source_c.h>
-#endif
-
-#ifdef ENABLE_MIRI
-#include <miri_source_c.h>
-#endif
-
-#ifdef ENABLE_SDRPLAY
-#include <sdrplay_source_c.h>
-#endif
-
-#ifdef ENABLE_HACKRF
-#include <hackrf_source_c.h>
-#endif
-
-#ifdef ENABLE_BLADERF
-#include <bladerf_source_c.h>
-#endif
-
-#ifdef ENABLE_RFSPACE
-#include <rfspace_source_c.h>
-#endif
-
-#ifdef ENABLE_AIRSPY
-#include <airspy_source_c.h>
-#endif
-
-#ifdef ENABLE_AIRSPYHF
-#include <airspyhf_source_c.h>
-#endif
-
-#ifdef ENABLE_SOAPY
-#include <soapy_source_c.h>
-#endif
-
-#ifdef ENABLE_REDPITAYA
-#include <redpitaya_source_c.h>
-#endif
-
-#ifdef ENABLE_FREESRP
-#include <freesrp_source_c.h>
-#endif
-
-#ifdef ENABLE_SPYSERVER
-#include <spyserver_source_c.h>
-#endif
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
 
 #include "arg_helpers.h"
+#include "channelizer_cc.h"
+#include "command_handler.h"
+#include "device_startup.h"
+#include "device_executor.h"
+#include "driver_registry.h"
+#include "hop_gate_cc.h"
+#include "nco_cc.h"
+#include "resampler_cc.h"
 #include "source_impl.h"
+#include "spectrum_probe_c.h"
+#include "squelch_gate_cc.h"
+
+struct device_job
+{
+  std::string arg;
+  source_driver driver;
+  gr::basic_block_sptr block;
+  source_iface *iface;
+  std::string error;
+};
+
+static void make_device( device_job *job )
+{
+  try {
+    job->block = job->driver.make( job->arg, job->iface );
+  } catch ( std::exception &ex ) {
+    job->error = ex.what();
+  } catch ( ... ) {
+    job->error = "Failed to open device '" + job->arg + "'.";
+  }
+}
 
 /*
  * Create a new instance of source_impl and return
@@ -127,142 +96,28 @@ source_impl::source_impl( const std::string &args )
 
   std::vector< std::string > arg_list = args_to_vector(args);
 
-  std::vector< std::string > dev_types;
-
-#ifdef ENABLE_FILE
-  dev_types.push_back("file");
-#endif
-#ifdef ENABLE_OSMOSDR
-  dev_types.push_back("osmosdr");
-#endif
-#ifdef ENABLE_FCD
-  dev_types.push_back("fcd");
-#endif
-#ifdef ENABLE_RTL
-  dev_types.push_back("rtl");
-#endif
-#ifdef ENABLE_RTL_TCP
-  dev_types.push_back("rtl_tcp");
-#endif
-#ifdef ENABLE_UHD
-  dev_types.push_back("uhd");
-#endif
-#ifdef ENABLE_MIRI
-  dev_types.push_back("miri");
-#endif
-#ifdef ENABLE_SDRPLAY
-  dev_types.push_back("sdrplay");
-#endif
-#ifdef ENABLE_HACKRF
-  dev_types.push_back("hackrf");
-#endif
-#ifdef ENABLE_BLADERF
-  dev_types.push_back("bladerf");
-#endif
-#ifdef ENABLE_RFSPACE
-  dev_types.push_back("rfspace");
-#endif
-#ifdef ENABLE_AIRSPY
-  dev_types.push_back("airspy");
-#endif
-#ifdef ENABLE_AIRSPYHF
-  dev_types.push_back("airspyhf");
-#endif
-#ifdef ENABLE_SOAPY
-  dev_types.push_back("soapy");
-#endif
-#ifdef ENABLE_REDPITAYA
-  dev_types.push_back("redpitaya");
-#endif
-#ifdef ENABLE_FREESRP
-  dev_types.push_back("freesrp");
-#endif
-#ifdef ENABLE_SPYSERVER
-  dev_types.push_back("spyserver");
-#endif
   std::cerr << "gr-osmosdr "
             << GR_OSMOSDR_VERSION << " (" << GR_OSMOSDR_LIBVER << ") "
             << "gnuradio " << gr::version() << std::endl;
   std::cerr << "built-in source types: ";
-  BOOST_FOREACH(std::string dev_type, dev_types)
+  BOOST_FOREACH(std::string dev_type, source_types())
     std::cerr << dev_type << " ";
   std::cerr << std::endl;
 
-#ifdef ENABLE_RFSPACE
-  dev_types.push_back("sdr-iq"); /* additional aliases for rfspace backend */
-  dev_types.push_back("sdr-ip");
-  dev_types.push_back("netsdr");
-  dev_types.push_back("cloudiq");
-#endif
-
   BOOST_FOREACH(std::string arg, arg_list) {
-    dict_t dict = params_to_dict(arg);
-    BOOST_FOREACH(std::string dev_type, dev_types) {
-      if ( dict.count( dev_type ) ) {
-        device_specified = true;
-        break;
-      }
+    source_driver driver;
+    if ( find_source_driver( params_to_dict(arg), driver ) ) {
+      device_specified = true;
+      break;
     }
   }
 
   if ( ! device_specified ) {
     std::vector< std::string > dev_list;
-#ifdef ENABLE_OSMOSDR
-    BOOST_FOREACH( std::string dev, osmosdr_src_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_FCD
-    BOOST_FOREACH( std::string dev, fcd_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_RTL
-    BOOST_FOREACH( std::string dev, rtl_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_UHD
-    BOOST_FOREACH( std::string dev, uhd_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_MIRI
-    BOOST_FOREACH( std::string dev, miri_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_SDRPLAY
-    BOOST_FOREACH( std::string dev, sdrplay_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_BLADERF
-    BOOST_FOREACH( std::string dev, bladerf_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_RFSPACE
-    BOOST_FOREACH( std::string dev, rfspace_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_HACKRF
-    BOOST_FOREACH( std::string dev, hackrf_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_AIRSPY
-    BOOST_FOREACH( std::string dev, airspy_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_SPYSERVER
-    BOOST_FOREACH( std::string dev, spyserver_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_SOAPY
-    BOOST_FOREACH( std::string dev, soapy_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_REDPITAYA
-    BOOST_FOREACH( std::string dev, redpitaya_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
-#ifdef ENABLE_FREESRP
-    BOOST_FOREACH( std::string dev, freesrp_source_c::get_devices() )
-      dev_list.push_back( dev );
-#endif
+
+    BOOST_FOREACH( osmosdr::device_t dev,
+                   osmosdr::device::find( osmosdr::device_t("nofake,nosoftware") ) )
+      dev_list.push_back( dev.to_string() );
 
 //    std::cerr << std::endl;
 //    BOOST_FOREACH( std::string dev, dev_list )
@@ -274,6 +129,19 @@ source_impl::source_impl( const std::string &args )
       throw std::runtime_error("No supported devices found (check the connection and/or udev rules).");
   }
 
+  std::vector< device_job > jobs;
+  bool timing = false;
+  bool hop = false;
+  bool squelch = false;
+  double threshold = 0, hang = 0.1, preroll = 0.01;
+  size_t spectrum = 0, spectrum_avg = 4;
+  double spectrum_rate = 10;
+  std::vector< gr::basic_block_sptr > probes;
+
+  _settle = -1;
+  _nco_span = 0;
+  _exact_rate = false;
+
   BOOST_FOREACH(std::string arg, arg_list) {
 
     dict_t dict = params_to_dict(arg);
@@ -282,151 +150,192 @@ source_impl::source_impl( const std::string &args )
 //    BOOST_FOREACH( dict_t::value_type &entry, dict )
 //      std::cerr << "'" << entry.first << "' = '" << entry.second << "'" << std::endl;
 
-    source_iface *iface = NULL;
-    gr::basic_block_sptr block;
+    device_job job;
+    job.arg = arg;
+    job.iface = NULL;
 
-#ifdef ENABLE_OSMOSDR
-    if ( dict.count("osmosdr") ) {
-      osmosdr_src_c_sptr src = osmosdr_make_src_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+    if ( find_source_driver( dict, job.driver ) )
+      jobs.push_back( job );
 
-#ifdef ENABLE_FCD
-    if ( dict.count("fcd") ) {
-      fcd_source_c_sptr src = make_fcd_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+    timing |= dict_flag( dict, "timing" );
+    hop |= dict_flag( dict, "hop" );
 
-#ifdef ENABLE_FILE
-    if ( dict.count("file") ) {
-      file_source_c_sptr src = make_file_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+    if ( dict.count("settle") )
+      _settle = boost::lexical_cast< double >( dict["settle"] );
 
-#ifdef ENABLE_RTL
-    if ( dict.count("rtl") ) {
-      rtl_source_c_sptr src = make_rtl_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+    /* share of the passband the NCO covers, "nco" alone takes 80 % */
+    if ( dict.count("nco") )
+      _nco_span = dict["nco"].empty() ? 0.8 :
+                  boost::lexical_cast< double >( dict["nco"] );
 
-#ifdef ENABLE_RTL_TCP
-    if ( dict.count("rtl_tcp") ) {
-      rtl_tcp_source_c_sptr src = make_rtl_tcp_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+    if ( dict.count("rate_mode") )
+      _exact_rate = parse_rate_mode( dict["rate_mode"] );
 
-#ifdef ENABLE_UHD
-    if ( dict.count("uhd") ) {
-      uhd_source_c_sptr src = make_uhd_source_c( arg );
-      block = src; iface = src.get();
+    /* threshold in dBFS, hang and preroll in seconds */
+    if ( dict.count("squelch") ) {
+      squelch = true;
+      threshold = boost::lexical_cast< double >( dict["squelch"] );
     }
-#endif
 
-#ifdef ENABLE_MIRI
-    if ( dict.count("miri") ) {
-      miri_source_c_sptr src = make_miri_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+    if ( dict.count("hang") )
+      hang = boost::lexical_cast< double >( dict["hang"] );
 
-#ifdef ENABLE_SDRPLAY
-    if ( dict.count("sdrplay") ) {
-      sdrplay_source_c_sptr src = make_sdrplay_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+    if ( dict.count("preroll") )
+      preroll = boost::lexical_cast< double >( dict["preroll"] );
 
-#ifdef ENABLE_HACKRF
-    if ( dict.count("hackrf") ) {
-      hackrf_source_c_sptr src = make_hackrf_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+    /* FFT size, spectra per second and FFTs averaged per spectrum */
+    if ( dict.count("spectrum") )
+      spectrum = boost::lexical_cast< size_t >( dict["spectrum"] );
 
-#ifdef ENABLE_BLADERF
-    if ( dict.count("bladerf") ) {
-      bladerf_source_c_sptr src = make_bladerf_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+    if ( dict.count("spectrum_rate") )
+      spectrum_rate = boost::lexical_cast< double >( dict["spectrum_rate"] );
 
-#ifdef ENABLE_RFSPACE
-    if ( dict.count("rfspace") ||
-         dict.count("sdr-iq") ||
-         dict.count("sdr-ip") ||
-         dict.count("netsdr") ||
-         dict.count("cloudiq") ) {
-      rfspace_source_c_sptr src = make_rfspace_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+    if ( dict.count("spectrum_avg") )
+      spectrum_avg = boost::lexical_cast< size_t >( dict["spectrum_avg"] );
+  }
 
-#ifdef ENABLE_AIRSPY
-    if ( dict.count("airspy") ) {
-      airspy_source_c_sptr src = make_airspy_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+  osmosdr::time_spec_t open_start = osmosdr::time_spec_t::get_system_time();
 
-#ifdef ENABLE_AIRSPYHF
-    if ( dict.count("airspyhf") ) {
-      airspyhf_source_c_sptr src = make_airspyhf_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+  /* devices asking for a fast open are brought up concurrently */
+  boost::thread_group threads;
 
-#ifdef ENABLE_AIRSPY
-    if ( dict.count("spyserver") ) {
-      spyserver_source_c_sptr src = make_spyserver_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+  for (size_t i = 0; i < jobs.size(); i++)
+    if ( dict_flag( params_to_dict( jobs[i].arg ), "fast" ) )
+      threads.create_thread( boost::bind( make_device, &jobs[i] ) );
+    else
+      make_device( &jobs[i] );
 
-#ifdef ENABLE_SOAPY
-    if ( dict.count("soapy") ) {
-      soapy_source_c_sptr src = make_soapy_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+  threads.join_all();
 
-#ifdef ENABLE_REDPITAYA
-    if ( dict.count("redpitaya") ) {
-      redpitaya_source_c_sptr src = make_redpitaya_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+  if ( timing )
+    std::cerr << "Opened " << jobs.size() << " device(s) in "
+              << int((osmosdr::time_spec_t::get_system_time() - open_start)
+                     .get_real_secs() * 1e3 + 0.5) << " ms" << std::endl;
 
-#ifdef ENABLE_FREESRP
-    if ( dict.count("freesrp") ) {
-      freesrp_source_c_sptr src = make_freesrp_source_c( arg );
-      block = src; iface = src.get();
-    }
-#endif
+  BOOST_FOREACH( device_job &job, jobs )
+    if ( ! job.error.empty() )
+      throw std::runtime_error( job.error );
+
+  BOOST_FOREACH( device_job &job, jobs ) {
+
+    source_iface *iface = job.iface;
+    gr::basic_block_sptr block = job.block;
+    dict_t dict = params_to_dict( job.arg );
+
+    if ( iface != NULL && long(block.get()) != 0 && dict.count("channels") ) {
+      if ( _nco_span > 0 || hop || _exact_rate )
+        throw std::runtime_error("The channels argument can't be combined with nco, hop or rate_mode=exact.");
+
+      if ( iface->get_num_channels() != 1 )
+        throw std::runtime_error("Channelizing needs a device with a single channel.");
+
+      subchannels_t subchannels = parse_subchannels( dict["channels"] );
 
-    if ( iface != NULL && long(block.get()) != 0 ) {
       _devs.push_back( iface );
+      _channelizers.resize( _devs.size() );
 
-      for (size_t i = 0; i < iface->get_num_channels(); i++) {
+      /* the narrowband channels all live on the single device channel */
+      for (size_t i = 0; i < subchannels.size(); i++)
+        _routes.add_route( iface, 0, _devs.size() - 1 );
+
+      channelizer_cc_sptr channelizer =
+          make_channelizer_cc( subchannels, iface->get_sample_rate() );
+
+      connect(block, 0, channelizer, 0);
+
+      if ( spectrum ) {
+        /* of the wideband stream, given as the first of its channels */
+        spectrum_probe_c_sptr probe =
+            make_spectrum_probe_c( spectrum, spectrum_rate, spectrum_avg, channel );
+        connect(block, 0, probe, 0);
+        probes.push_back( probe );
+        _probes[ std::make_pair( iface, 0 ) ] = probe;
+        follow_probe( iface, 0, iface->get_sample_rate(), iface->get_center_freq( 0 ) );
+      }
 #ifdef HAVE_IQBALANCE
-        gr::iqbalance::optimize_c::sptr iq_opt = gr::iqbalance::optimize_c::make( 0 );
-        gr::iqbalance::fix_cc::sptr     iq_fix = gr::iqbalance::fix_cc::make();
+      /* one correction for the wideband stream all channels come from */
+      boost::shared_ptr< iq_stage_t > stage =
+          boost::make_shared< iq_stage_t >( block, 0 );
+      stage->dst = channelizer;
+
+      for (size_t i = 0; i < subchannels.size(); i++)
+        _iq_stages.push_back( stage );
+#endif
+      for (size_t i = 0; i < subchannels.size(); i++) {
+        if ( squelch ) {
+          /* learns the rate of the channel from its rx_rate tags */
+          squelch_gate_cc_sptr gate = make_squelch_gate_cc( threshold, hang, preroll );
+          connect(channelizer, i, gate, 0);
+          connect(gate, 0, self(), channel++);
+          _squelch_gates.push_back( gate );
+        } else {
+          connect(channelizer, i, self(), channel++);
+        }
+      }
 
-        connect(block, i, iq_fix, 0);
-        connect(iq_fix, 0, self(), channel++);
+      _channelizers.back() = channelizer;
+    } else if ( iface != NULL && long(block.get()) != 0 ) {
+      _devs.push_back( iface );
+      _routes.add_device( iface, _devs.size() - 1 );
 
-        connect(block, i, iq_opt, 0);
-        msg_connect(iq_opt, "iqbal_corr", iq_fix, "iqbal_corr");
+      for (size_t i = 0; i < iface->get_num_channels(); i++) {
+        std::vector< gr::basic_block_sptr > chain; /* behind the device */
+
+        if ( spectrum ) {
+          /* taps the device itself, ahead of the chain */
+          spectrum_probe_c_sptr probe =
+              make_spectrum_probe_c( spectrum, spectrum_rate, spectrum_avg, channel );
+          connect(block, i, probe, 0);
+          probes.push_back( probe );
+          _probes[ std::make_pair( iface, i ) ] = probe;
+          follow_probe( iface, i, iface->get_sample_rate(), iface->get_center_freq( i ) );
+        }
 
-        _iq_opt.push_back( iq_opt.get() );
-        _iq_fix.push_back( iq_fix.get() );
-#else
-        connect(block, i, self(), channel++);
+        if ( _nco_span > 0 ) {
+          nco_cc_sptr nco = make_nco_cc();
+          chain.push_back( nco );
+          _ncos.push_back( nco );
+        }
+
+        if ( hop ) {
+          hop_gate_cc_sptr gate = make_hop_gate_cc(
+                boost::bind( &source_impl::hop_retune, this, channel, _1 ) );
+          chain.push_back( gate );
+          _hop_gates.push_back( gate );
+        }
+
+        if ( _exact_rate ) {
+          resampler_cc_sptr resampler = make_resampler_cc();
+          chain.push_back( resampler );
+          _resamplers.push_back( resampler );
+        }
+
+        if ( squelch ) {
+          squelch_gate_cc_sptr gate = make_squelch_gate_cc( threshold, hang, preroll );
+          chain.push_back( gate );
+          _squelch_gates.push_back( gate );
+        }
+
+        gr::basic_block_sptr tail = block;
+        int port = i;
+
+        BOOST_FOREACH( gr::basic_block_sptr next, chain ) {
+          connect(tail, port, next, 0);
+          tail = next;
+          port = 0;
+        }
+
+        connect(tail, port, self(), channel);
+#ifdef HAVE_IQBALANCE
+        /* the correction goes right behind the device once enabled */
+        boost::shared_ptr< iq_stage_t > stage =
+            boost::make_shared< iq_stage_t >( block, i );
+        stage->dst = chain.empty() ? gr::basic_block_sptr( self() ) : chain.front();
+        stage->dst_port = chain.empty() ? channel : 0;
+
+        _iq_stages.push_back( stage );
 #endif
+        channel++;
       }
     } else if ( (iface != NULL) || (long(block.get()) != 0) )
       throw std::runtime_error("Either iface or block are NULL.");
@@ -435,25 +344,112 @@ source_impl::source_impl( const std::string &args )
 
   if (!_devs.size())
     throw std::runtime_error("No devices specified via device arguments.");
+
+  for (size_t i = 0; i < _devs.size(); i++) {
+    _execs.push_back( boost::make_shared< device_executor >() );
+    _devs[i]->set_executor( _execs[i] );
+  }
+
+  /* settings sent as commands are applied on the thread of their handler */
+  _commands = make_command_handler( boost::bind( &apply_command< source_impl >, this, _1 ) );
+
+  message_port_register_hier_in( pmt::mp("command") );
+  message_port_register_hier_out( pmt::mp("status") );
+
+  msg_connect( self(), pmt::mp("command"), _commands, pmt::mp("command") );
+  msg_connect( _commands, pmt::mp("status"), self(), pmt::mp("status") );
+
+  /* power spectra of the devices, computed off the sample path */
+  if ( ! probes.empty() ) {
+    message_port_register_hier_out( pmt::mp("spectrum") );
+
+    BOOST_FOREACH( gr::basic_block_sptr probe, probes )
+      msg_connect( probe, pmt::mp("spectrum"), self(), pmt::mp("spectrum") );
+  }
 }
 
-size_t source_impl::get_num_channels()
+source_impl::~source_impl()
 {
-  size_t channels = 0;
+  /* the gates call back into us from their control threads */
+  BOOST_FOREACH( hop_gate_cc_sptr &gate, _hop_gates )
+    gate->stop();
+
+  /*
+   * The devices may outlive us in the flowgraph and share the executors,
+   * finish the calls still queued on our behalf and take the executors
+   * back before any member goes away.
+   */
+  for (size_t i = 0; i < _execs.size(); i++) {
+    _execs[i]->call( [](){} );
+    _devs[i]->set_executor( boost::shared_ptr< device_executor >() );
+  }
+}
 
-  BOOST_FOREACH( source_iface *dev, _devs )
-    channels += dev->get_num_channels();
+/*
+ * Queues setter for chan (or every channel with ALL_CHANS) on the executors
+ * of the devices involved. Channels already set to value according to cache
+ * are skipped unless force is given.
+ */
+boost::shared_future< double >
+source_impl::apply_setting( size_t chan, double value,
+                            std::map< size_t, double > &cache, bool force,
+                            const setter_t &setter )
+{
+  std::vector< device_executor::task_t > tasks;
+  std::set< std::pair< source_iface *, size_t > > queued;
+  bool found = false;
+  size_t first = chan, last = chan + 1;
+
+  if ( chan == osmosdr::ALL_CHANS ) {
+    first = 0;
+    last = _routes.size();
+  }
+
+  boost::mutex::scoped_lock lock( _cache_mutex );
+
+  for (size_t channel = first; channel < last; channel++) {
+    const route_t *route = _routes.find( channel );
+    if ( ! route )
+      break;
+
+    found = true;
+
+    if ( cache[ channel ] == value && ! force )
+      continue;
+
+    cache[ channel ] = value;
+
+    /* channels of a channelized device share the device channel */
+    if ( ! queued.insert( std::make_pair( route->dev, route->dev_chan ) ).second )
+      continue;
+
+    tasks.push_back( device_executor::task_t( _execs[ route->dev_index ].get(),
+                                              boost::bind( setter, route->dev,
+                                                           route->dev_chan ) ) );
+  }
+
+  if ( tasks.empty() )
+    return device_executor::ready( found ? value : 0 );
+
+  return device_executor::run_all( tasks );
+}
+
+void source_impl::invalidate_caps( size_t chan )
+{
+  _ranges.invalidate( chan );
+  _names.invalidate( chan );
+}
 
-  return channels;
+size_t source_impl::get_num_channels()
+{
+  return _routes.size();
 }
 
 bool source_impl::seek( long seek_point, int whence, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->seek( seek_point, whence, dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return route->dev->seek( seek_point, whence, route->dev_chan );
 
   return false;
 }
@@ -462,8 +458,12 @@ bool source_impl::seek( long seek_point, int whence, size_t chan )
 
 osmosdr::meta_range_t source_impl::get_sample_rates()
 {
-  if ( ! _devs.empty() )
-    return _devs[0]->get_sample_rates(); // assume same devices used in the group
+  /* the resamplers reach any rate up to the highest one of the device */
+  if ( ! _devs.empty() && _exact_rate )
+    return osmosdr::meta_range_t( 1, get_native_rates( 0 ).stop() );
+
+  if ( ! _devs.empty() ) // assume same devices used in the group
+    return get_native_rates( 0 );
 #if 0
   else
     throw std::runtime_error(NO_DEVICES_MSG);
@@ -471,48 +471,147 @@ osmosdr::meta_range_t source_impl::get_sample_rates()
   return osmosdr::meta_range_t();;
 }
 
+osmosdr::meta_range_t source_impl::get_native_rates( size_t dev_index )
+{
+  source_iface *dev = _devs[ dev_index ];
+
+  return _ranges.get( _routes.first( dev_index ), "rates",
+                      [this, dev_index, dev]() {
+                        return query( dev_index, [dev]() { return dev->get_sample_rates(); } );
+                      } );
+}
+
+/* the channels of the device at dev_index are resampled from native to rate */
+void source_impl::set_exact_rate( size_t dev_index, double native, double rate )
+{
+  for (size_t chan = 0; chan < _routes.size(); chan++)
+    if ( _routes.find( chan )->dev_index == dev_index && chan < _resamplers.size() )
+      _resamplers[ chan ]->set_rates( native, rate );
+}
+
 double source_impl::set_sample_rate(double rate)
 {
-  double sample_rate = 0;
+  return set_sample_rate_async( rate ).get();
+}
+
+boost::shared_future< double > source_impl::set_sample_rate_async( double rate )
+{
+  {
+    boost::mutex::scoped_lock lock( _cache_mutex );
+
+    if (_sample_rate == rate)
+      return device_executor::ready( rate );
+
+    /* unknown until every device of the group reports its new rate */
+    _sample_rate = NAN;
+  }
 
-  if (_sample_rate != rate) {
 #if 0
-    if (_devs.empty())
-      throw std::runtime_error(NO_DEVICES_MSG);
+  if (_devs.empty())
+    throw std::runtime_error(NO_DEVICES_MSG);
 #endif
-    BOOST_FOREACH( source_iface *dev, _devs )
-      sample_rate = dev->set_sample_rate(rate);
+
+  /* filter ranges may follow the rate */
+  _ranges.invalidate();
+
+  /* all devices of the group are set in parallel */
+  std::vector< device_executor::task_t > tasks;
+  boost::shared_ptr< size_t > pending = boost::make_shared< size_t >( _devs.size() );
+  size_t channel = 0;
+
+  for (size_t i = 0; i < _devs.size(); i++) {
+    source_iface *dev = _devs[i];
+    size_t first_chan = channel;
+    size_t nchan = _routes.count( i );
+
+    osmosdr::meta_range_t native_rates;
+    if ( _exact_rate )
+      native_rates = get_native_rates( i );
+
+    tasks.push_back( device_executor::task_t( _execs[i].get(),
+        [this, i, dev, first_chan, nchan, rate, native_rates, pending]() {
+      double sample_rate;
+
+      try {
+        if ( _exact_rate ) {
+          sample_rate = dev->set_sample_rate( pick_native_rate( native_rates, rate ) );
+          set_exact_rate( i, sample_rate, rate );
+        } else {
+          sample_rate = dev->set_sample_rate(rate);
+        }
+      } catch ( ... ) {
+        boost::mutex::scoped_lock lock( _cache_mutex );
+        *pending = 0; /* the group is not at any one rate */
+        throw;
+      }
+
+      if ( i < _channelizers.size() && _channelizers[i] )
+        _channelizers[i]->set_sample_rate( sample_rate );
+
+      follow_probe( dev, 0, sample_rate, NAN );
 
 #ifdef HAVE_IQBALANCE
-    size_t channel = 0;
-    BOOST_FOREACH( source_iface *dev, _devs ) {
-      for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
-        if ( channel < _iq_opt.size() ) {
-          gr::iqbalance::optimize_c *opt = _iq_opt[channel];
+      {
+        boost::mutex::scoped_lock lock( _iq_mutex );
 
-          if ( opt->period() > 0 ) { /* optimize is enabled */
+        /* only the stages in place and optimizing, each once */
+        for (size_t dev_chan = 0; dev_chan < nchan; dev_chan++) {
+          size_t channel = first_chan + dev_chan;
+
+          if ( channel >= _iq_stages.size() ||
+               (dev_chan > 0 && _iq_stages[channel] == _iq_stages[channel - 1]) )
+            continue;
+
+          gr::iqbalance::optimize_c::sptr opt = _iq_stages[channel]->opt;
+
+          if ( opt && opt->period() > 0 ) { /* optimize is enabled */
             opt->set_period( dev->get_sample_rate() / 5 );
             opt->reset();
           }
         }
-
-        channel++;
       }
-    }
 #endif
 
-    _sample_rate = sample_rate;
+      /* the offsets of the NCOs stay put in Hz */
+      for (size_t dev_chan = 0; dev_chan < nchan; dev_chan++)
+        if ( first_chan + dev_chan < _ncos.size() )
+          _ncos[ first_chan + dev_chan ]->set_sample_rate( sample_rate );
+
+      /* the gates behind a channelizer follow its rx_rate tags */
+      if ( ! (i < _channelizers.size() && _channelizers[i]) )
+        for (size_t dev_chan = 0; dev_chan < nchan; dev_chan++)
+          if ( first_chan + dev_chan < _squelch_gates.size() )
+            _squelch_gates[ first_chan + dev_chan ]->set_sample_rate(
+                  _exact_rate ? rate : sample_rate );
+
+      {
+        boost::mutex::scoped_lock lock( _cache_mutex );
+
+        /* the last device of the group to succeed caches what it runs at */
+        if ( *pending && --*pending == 0 )
+          _sample_rate = _exact_rate ? rate : sample_rate;
+      }
+
+      return _exact_rate ? rate : sample_rate;
+    } ) );
+
+    channel += nchan;
   }
 
-  return sample_rate;
+  return device_executor::run_all( tasks );
 }
 
 double source_impl::get_sample_rate()
 {
   double sample_rate = 0;
 
-  if (!_devs.empty())
-    sample_rate = _devs[0]->get_sample_rate(); // assume same devices used in the group
+  if ( ! _resamplers.empty() && _resamplers[0]->get_out_rate() > 0 )
+    return _resamplers[0]->get_out_rate();
+
+  if (!_devs.empty()) { // assume same devices used in the group
+    source_iface *dev = _devs[0];
+    sample_rate = query( 0, [dev]() { return dev->get_sample_rate(); } );
+  }
 #if 0
   else
     throw std::runtime_error(NO_DEVICES_MSG);
@@ -522,367 +621,635 @@ double source_impl::get_sample_rate()
 
 osmosdr::freq_range_t source_impl::get_freq_range( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_freq_range( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _ranges.get( chan, "freq",
+                        [this, route]() {
+                          return query( route->dev_index, [route]() {
+                            return route->dev->get_freq_range( route->dev_chan );
+                          } );
+                        } );
 
   return osmosdr::freq_range_t();
 }
 
 double source_impl::set_center_freq( double freq, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _center_freq[ chan ] != freq ) {
-          _center_freq[ chan ] = freq;
-          return dev->set_center_freq( freq, dev_chan );
-        } else { return _center_freq[ chan ]; }
-      }
+  return set_center_freq_async( freq, chan ).get();
+}
 
-  return 0;
+boost::shared_future< double > source_impl::set_center_freq_async( double freq, size_t chan )
+{
+  if ( _ncos.empty() )
+    return apply_setting( chan, freq, _center_freq, false,
+                          [this, freq]( source_iface *dev, size_t dev_chan ) {
+                            double actual = dev->set_center_freq( freq, dev_chan );
+                            follow_probe( dev, dev_chan, NAN, actual );
+                            return actual;
+                          } );
+
+  size_t first = chan, last = chan + 1;
+
+  if ( chan == osmosdr::ALL_CHANS ) {
+    first = 0;
+    last = _ncos.size();
+  }
+
+  std::vector< device_executor::task_t > tasks;
+  bool found = false;
+
+  for (size_t channel = first; channel < last && channel < _ncos.size(); channel++) {
+    found = true;
+
+    if ( fine_tune( channel, freq ) )
+      continue;
+
+    const route_t *route = _routes.find( channel );
+    {
+      boost::mutex::scoped_lock lock( _cache_mutex );
+      _center_freq[ channel ] = freq;
+    }
+
+    nco_cc_sptr nco = _ncos[ channel ];
+    tasks.push_back( device_executor::task_t( _execs[ route->dev_index ].get(),
+        [this, nco, freq, channel, route]() {
+          double actual = route->dev->set_center_freq( freq, route->dev_chan );
+          follow_probe( route->dev, route->dev_chan, NAN, actual );
+
+          nco->reset();
+
+          boost::mutex::scoped_lock lock( _nco_mutex );
+          _hw_freq[ channel ] = actual;
+
+          return actual;
+        } ) );
+  }
+
+  if ( tasks.empty() )
+    return device_executor::ready( found ? freq : 0 );
+
+  return device_executor::run_all( tasks );
+}
+
+/*
+ * Hands the rate of the device and the frequency of dev_chan to the
+ * spectrum probes, for the devices that don't tag them. The rate goes to
+ * the probes of every channel of the device. NAN leaves either as it is.
+ */
+void source_impl::follow_probe( source_iface *dev, size_t dev_chan,
+                                double rate, double freq )
+{
+  typedef osmosdr::channel_settings cs;
+  typedef std::map< std::pair< source_iface *, size_t >, spectrum_probe_c_sptr > probes_t;
+
+  for (probes_t::iterator it = _probes.lower_bound( std::make_pair( dev, size_t(0) ) );
+       it != _probes.end() && it->first.first == dev; ++it) {
+    if ( cs::is_set( rate ) )
+      it->second->set_sample_rate( rate );
+    if ( cs::is_set( freq ) && it->first.second == dev_chan )
+      it->second->set_center_freq( freq );
+  }
+}
+
+/*
+ * Moves chan to freq with its NCO when freq lies inside the share of the
+ * passband around the hardware frequency given by the nco argument.
+ */
+bool source_impl::fine_tune( size_t chan, double freq )
+{
+  if ( chan >= _ncos.size() )
+    return false;
+
+  const route_t *route = _routes.find( chan );
+  double rate = query( route->dev_index,
+                                 [route]() { return route->dev->get_sample_rate(); } );
+
+  {
+    boost::mutex::scoped_lock lock( _nco_mutex );
+
+    std::map< size_t, double >::iterator hw = _hw_freq.find( chan );
+    if ( hw == _hw_freq.end() || rate <= 0 )
+      return false;
+
+    double offset = freq - hw->second;
+    if ( std::abs( offset ) > _nco_span * rate / 2 )
+      return false;
+
+    _ncos[ chan ]->set_sample_rate( rate );
+    if ( offset != _ncos[ chan ]->get_offset() )
+      _ncos[ chan ]->set_offset( offset, freq );
+  }
+
+  boost::mutex::scoped_lock lock( _cache_mutex );
+  _center_freq[ chan ] = freq;
+
+  return true;
 }
 
 double source_impl::get_center_freq( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_center_freq( dev_chan );
+  if ( chan < _ncos.size() ) {
+    boost::mutex::scoped_lock lock( _nco_mutex );
+
+    std::map< size_t, double >::iterator hw = _hw_freq.find( chan );
+    if ( hw != _hw_freq.end() )
+      return hw->second + _ncos[ chan ]->get_offset();
+  }
+
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return query( route->dev_index, [route]() {
+      return route->dev->get_center_freq( route->dev_chan );
+    } );
 
   return 0;
 }
 
 double source_impl::set_freq_corr( double ppm, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _freq_corr[ chan ] != ppm ) {
-          _freq_corr[ chan ] = ppm;
-          return dev->set_freq_corr( ppm, dev_chan );
-        } else { return _freq_corr[ chan ]; }
-      }
+  return set_freq_corr_async( ppm, chan ).get();
+}
 
-  return 0;
+boost::shared_future< double > source_impl::set_freq_corr_async( double ppm, size_t chan )
+{
+  return apply_setting( chan, ppm, _freq_corr, false,
+                        [ppm]( source_iface *dev, size_t dev_chan ) {
+                          return dev->set_freq_corr( ppm, dev_chan );
+                        } );
 }
 
 double source_impl::get_freq_corr( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_freq_corr( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return query( route->dev_index, [route]() {
+      return route->dev->get_freq_corr( route->dev_chan );
+    } );
 
   return 0;
 }
 
 std::vector<std::string> source_impl::get_gain_names( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain_names( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _names.get( chan, "gains",
+                        [this, route]() {
+                          return query( route->dev_index, [route]() {
+                            return route->dev->get_gain_names( route->dev_chan );
+                          } );
+                        } );
 
   return std::vector< std::string >();
 }
 
 osmosdr::gain_range_t source_impl::get_gain_range( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain_range( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _ranges.get( chan, "gain",
+                        [this, route]() {
+                          return query( route->dev_index, [route]() {
+                            return route->dev->get_gain_range( route->dev_chan );
+                          } );
+                        } );
 
   return osmosdr::gain_range_t();
 }
 
 osmosdr::gain_range_t source_impl::get_gain_range( const std::string & name, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain_range( name, dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _ranges.get( chan, "gain:" + name,
+                        [this, route, name]() {
+                          return query( route->dev_index, [route, &name]() {
+                            return route->dev->get_gain_range( name, route->dev_chan );
+                          } );
+                        } );
 
   return osmosdr::gain_range_t();
 }
 
 bool source_impl::set_gain_mode( bool automatic, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _gain_mode[ chan ] != automatic ) {
-          _gain_mode[ chan ] = automatic;
-          bool mode = dev->set_gain_mode( automatic, dev_chan );
-          if (!automatic) // reapply gain value when switched to manual mode
-            dev->set_gain( _gain[ chan ], dev_chan );
-          return mode;
-        } else { return _gain_mode[ chan ]; }
-      }
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    source_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    boost::mutex::scoped_lock lock( _cache_mutex );
+
+    if ( _gain_mode[ chan ] != automatic ) {
+      _gain_mode[ chan ] = automatic;
+      bool mode = false;
+      double gain = _gain[ chan ];
+      lock.unlock();
+      _execs[ route->dev_index ]->call( [&]() {
+        mode = dev->set_gain_mode( automatic, dev_chan );
+        if (!automatic) // reapply gain value when switched to manual mode
+          dev->set_gain( gain, dev_chan );
+      } );
+      return mode;
+    } else { return _gain_mode[ chan ]; }
+  }
 
   return false;
 }
 
 bool source_impl::get_gain_mode( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain_mode( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return query( route->dev_index, [route]() {
+      return route->dev->get_gain_mode( route->dev_chan );
+    } );
 
   return false;
 }
 
 double source_impl::set_gain( double gain, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _gain[ chan ] != gain ) {
-          _gain[ chan ] = gain;
-          return dev->set_gain( gain, dev_chan );
-        } else { return _gain[ chan ]; }
-      }
+  return set_gain_async( gain, chan ).get();
+}
 
-  return 0;
+boost::shared_future< double > source_impl::set_gain_async( double gain, size_t chan )
+{
+  return apply_setting( chan, gain, _gain, false,
+                        [gain]( source_iface *dev, size_t dev_chan ) {
+                          return dev->set_gain( gain, dev_chan );
+                        } );
 }
 
 double source_impl::set_gain( double gain, const std::string & name, size_t chan)
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->set_gain( gain, name, dev_chan );
+  return set_gain_async( gain, name, chan ).get();
+}
 
-  return 0;
+boost::shared_future< double >
+source_impl::set_gain_async( double gain, const std::string & name, size_t chan )
+{
+  std::map< size_t, double > no_cache;
+
+  return apply_setting( chan, gain, no_cache, true,
+                        [gain, name]( source_iface *dev, size_t dev_chan ) {
+                          return dev->set_gain( gain, name, dev_chan );
+                        } );
 }
 
 double source_impl::get_gain( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return query( route->dev_index, [route]() {
+      return route->dev->get_gain( route->dev_chan );
+    } );
 
   return 0;
 }
 
 double source_impl::get_gain( const std::string & name, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain( name, dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return query( route->dev_index, [route, &name]() {
+      return route->dev->get_gain( name, route->dev_chan );
+    } );
 
   return 0;
 }
 
 double source_impl::set_if_gain( double gain, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _if_gain[ chan ] != gain ) {
-          _if_gain[ chan ] = gain;
-          return dev->set_if_gain( gain, dev_chan );
-        } else { return _if_gain[ chan ]; }
-      }
+  return set_if_gain_async( gain, chan ).get();
+}
 
-  return 0;
+boost::shared_future< double > source_impl::set_if_gain_async( double gain, size_t chan )
+{
+  return apply_setting( chan, gain, _if_gain, false,
+                        [gain]( source_iface *dev, size_t dev_chan ) {
+                          return dev->set_if_gain( gain, dev_chan );
+                        } );
 }
 
 double source_impl::set_bb_gain( double gain, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _bb_gain[ chan ] != gain ) {
-          _bb_gain[ chan ] = gain;
-          return dev->set_bb_gain( gain, dev_chan );
-        } else { return _bb_gain[ chan ]; }
-      }
+  return set_bb_gain_async( gain, chan ).get();
+}
 
-  return 0;
+boost::shared_future< double > source_impl::set_bb_gain_async( double gain, size_t chan )
+{
+  return apply_setting( chan, gain, _bb_gain, false,
+                        [gain]( source_iface *dev, size_t dev_chan ) {
+                          return dev->set_bb_gain( gain, dev_chan );
+                        } );
 }
 
 std::vector< std::string > source_impl::get_antennas( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_antennas( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _names.get( chan, "antennas",
+                        [this, route]() {
+                          return query( route->dev_index, [route]() {
+                            return route->dev->get_antennas( route->dev_chan );
+                          } );
+                        } );
 
   return std::vector< std::string >();
 }
 
 std::string source_impl::set_antenna( const std::string & antenna, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _antenna[ chan ] != antenna ) {
-          _antenna[ chan ] = antenna;
-          return dev->set_antenna( antenna, dev_chan );
-        } else { return _antenna[ chan ]; }
-      }
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    source_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    boost::mutex::scoped_lock lock( _cache_mutex );
+
+    if ( _antenna[ chan ] != antenna ) {
+      _antenna[ chan ] = antenna;
+      lock.unlock();
+      invalidate_caps( chan ); /* other ports may cover other ranges */
+      std::string actual;
+      _execs[ route->dev_index ]->call( [&]() {
+        actual = dev->set_antenna( antenna, dev_chan );
+      } );
+      return actual;
+    } else { return _antenna[ chan ]; }
+  }
 
   return "";
 }
 
 std::string source_impl::get_antenna( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_antenna( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return query( route->dev_index, [route]() {
+      return route->dev->get_antenna( route->dev_chan );
+    } );
 
   return "";
 }
 
 void source_impl::set_dc_offset_mode( int mode, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        dev->set_dc_offset_mode( mode, dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    _execs[ route->dev_index ]->call( [route, mode]() {
+      route->dev->set_dc_offset_mode( mode, route->dev_chan );
+    } );
 }
 
 void source_impl::set_dc_offset( const std::complex<double> &offset, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        dev->set_dc_offset( offset, dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    _execs[ route->dev_index ]->call( [route, &offset]() {
+      route->dev->set_dc_offset( offset, route->dev_chan );
+    } );
 }
 
 void source_impl::set_iq_balance_mode( int mode, size_t chan )
 {
-  size_t channel = 0;
+  const route_t *route = _routes.find( chan );
+  if ( ! route )
+    return;
+
 #ifdef HAVE_IQBALANCE
-  BOOST_FOREACH( source_iface *dev, _devs ) {
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
-      if ( chan == channel++ ) {
-        if ( chan < _iq_opt.size() && chan < _iq_fix.size() ) {
-          gr::iqbalance::optimize_c *opt = _iq_opt[chan];
-          gr::iqbalance::fix_cc *fix = _iq_fix[chan];
-
-          if ( IQBalanceOff == mode  ) {
-            opt->set_period( 0 );
-            /* store current values in order to be able to restore them later */
-            _vals[ chan ] = std::pair< float, float >( fix->mag(), fix->phase() );
-            fix->set_mag( 0.0f );
-            fix->set_phase( 0.0f );
-          } else if ( IQBalanceManual == mode ) {
-            if ( opt->period() == 0 ) { /* transition from Off to Manual */
-              /* restore previous values */
-              std::pair< float, float > val = _vals[ chan ];
-              fix->set_mag( val.first );
-              fix->set_phase( val.second );
-            }
-            opt->set_period( 0 );
-          } else if ( IQBalanceAutomatic == mode ) {
-            opt->set_period( dev->get_sample_rate() / 5 );
-            opt->reset();
-          }
-        }
+  if ( chan < _iq_stages.size() ) {
+    boost::mutex::scoped_lock lock( _iq_mutex );
+    iq_stage_t &stage = *_iq_stages[ chan ];
+
+    if ( IQBalanceOff == mode ) {
+      /* store current values in order to be able to restore them later */
+      if ( stage.fix )
+        stage.vals = std::pair< float, float >( stage.fix->mag(), stage.fix->phase() );
+      set_iq_stage( stage, false );
+    } else {
+      if ( set_iq_stage( stage, true ) ) { /* transition from Off */
+        /* restore previous values */
+        stage.fix->set_mag( stage.vals.first );
+        stage.fix->set_phase( stage.vals.second );
+      }
+
+      if ( IQBalanceManual == mode ) {
+        stage.opt->set_period( 0 );
+      } else if ( IQBalanceAutomatic == mode ) {
+        stage.opt->set_period( query( route->dev_index, [route]() {
+                                 return route->dev->get_sample_rate();
+                               } ) / 5 );
+        stage.opt->reset();
       }
     }
   }
 #else
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->set_iq_balance_mode( mode, dev_chan );
+  _execs[ route->dev_index ]->call( [route, mode]() {
+    route->dev->set_iq_balance_mode( mode, route->dev_chan );
+  } );
 #endif
 }
 
+#ifdef HAVE_IQBALANCE
+/*
+ * Puts the iqbalance blocks of stage in place or takes them out again, so
+ * no sample passes through them while the correction is off. Returns
+ * whether they were put in place. A flowgraph that has been started is
+ * locked for the change. Before that the hier block may not be part of
+ * one, and locking it would fail.
+ */
+bool source_impl::set_iq_stage( iq_stage_t &stage, bool enabled )
+{
+  if ( enabled == bool( stage.fix ) )
+    return false;
+
+  /* the devices may be hier blocks, the command handler is always a block */
+  bool started = bool( _commands->detail() );
+
+  if ( started )
+    lock();
+
+  if ( enabled ) {
+    stage.opt = gr::iqbalance::optimize_c::make( 0 );
+    stage.fix = gr::iqbalance::fix_cc::make();
+
+    disconnect(stage.src, stage.src_port, stage.dst, stage.dst_port);
+    connect(stage.src, stage.src_port, stage.fix, 0);
+    connect(stage.fix, 0, stage.dst, stage.dst_port);
+
+    connect(stage.src, stage.src_port, stage.opt, 0);
+    msg_connect(stage.opt, "iqbal_corr", stage.fix, "iqbal_corr");
+  } else {
+    msg_disconnect(stage.opt, "iqbal_corr", stage.fix, "iqbal_corr");
+    disconnect(stage.src, stage.src_port, stage.opt, 0);
+
+    disconnect(stage.fix, 0, stage.dst, stage.dst_port);
+    disconnect(stage.src, stage.src_port, stage.fix, 0);
+    connect(stage.src, stage.src_port, stage.dst, stage.dst_port);
+
+    stage.opt.reset();
+    stage.fix.reset();
+  }
+
+  if ( started )
+    unlock();
+
+  return enabled;
+}
+#endif
+
 void source_impl::set_iq_balance( const std::complex<double> &balance, size_t chan )
 {
-  size_t channel = 0;
+  const route_t *route = _routes.find( chan );
+  if ( ! route )
+    return;
+
 #ifdef HAVE_IQBALANCE
-  BOOST_FOREACH( source_iface *dev, _devs ) {
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
-      if ( chan == channel++ ) {
-        if ( chan < _iq_opt.size() && chan < _iq_fix.size() ) {
-          gr::iqbalance::optimize_c *opt = _iq_opt[chan];
-          gr::iqbalance::fix_cc *fix = _iq_fix[chan];
-
-          if ( opt->period() == 0 ) { /* automatic optimization desabled */
-            fix->set_mag( balance.real() );
-            fix->set_phase( balance.imag() );
-          }
-        }
-      }
+  if ( chan < _iq_stages.size() ) {
+    boost::mutex::scoped_lock lock( _iq_mutex );
+    iq_stage_t &stage = *_iq_stages[ chan ];
+
+    if ( ! stage.fix ) { /* off, for when manual mode is selected */
+      stage.vals = std::pair< float, float >( balance.real(), balance.imag() );
+    } else if ( stage.opt->period() == 0 ) { /* automatic optimization desabled */
+      stage.fix->set_mag( balance.real() );
+      stage.fix->set_phase( balance.imag() );
     }
   }
 #else
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->set_iq_balance( balance, dev_chan );
+  _execs[ route->dev_index ]->call( [route, &balance]() {
+    route->dev->set_iq_balance( balance, route->dev_chan );
+  } );
 #endif
 }
 
 double source_impl::set_bandwidth( double bandwidth, size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ ) {
-        if ( _bandwidth[ chan ] != bandwidth || 0.0f == bandwidth ) {
-          _bandwidth[ chan ] = bandwidth;
-          return dev->set_bandwidth( bandwidth, dev_chan );
-        } else { return _bandwidth[ chan ]; }
-      }
+  return set_bandwidth_async( bandwidth, chan ).get();
+}
 
-  return 0;
+boost::shared_future< double > source_impl::set_bandwidth_async( double bandwidth, size_t chan )
+{
+  return apply_setting( chan, bandwidth, _bandwidth, 0.0f == bandwidth,
+                        [bandwidth]( source_iface *dev, size_t dev_chan ) {
+                          return dev->set_bandwidth( bandwidth, dev_chan );
+                        } );
 }
 
 double source_impl::get_bandwidth( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_bandwidth( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return query( route->dev_index, [route]() {
+      return route->dev->get_bandwidth( route->dev_chan );
+    } );
 
   return 0;
 }
 
 osmosdr::freq_range_t source_impl::get_bandwidth_range( size_t chan )
 {
-  size_t channel = 0;
-  BOOST_FOREACH( source_iface *dev, _devs )
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_bandwidth_range( dev_chan );
+  const route_t *route = _routes.find( chan );
+  if ( route )
+    return _ranges.get( chan, "bandwidth",
+                        [this, route]() {
+                          return query( route->dev_index, [route]() {
+                            return route->dev->get_bandwidth_range( route->dev_chan );
+                          } );
+                        } );
 
   return osmosdr::freq_range_t();
 }
 
+osmosdr::channel_settings source_impl::configure( const osmosdr::channel_settings &settings,
+                                                  size_t chan )
+{
+  typedef osmosdr::channel_settings cs;
+
+  const route_t *route = _routes.find( chan );
+  if ( route ) {
+    source_iface *dev = route->dev;
+    size_t dev_chan = route->dev_chan;
+
+    /* keep the caches of the individual setters in sync, the rate
+     * only changes on this device so the group rate is unknown now */
+    {
+      boost::mutex::scoped_lock lock( _cache_mutex );
+
+      if ( cs::is_set( settings.sample_rate ) )
+        _sample_rate = NAN;
+      if ( cs::is_set( settings.center_freq ) )
+        _center_freq[ chan ] = settings.center_freq;
+      if ( cs::is_set( settings.gain ) )
+        _gain[ chan ] = settings.gain;
+      if ( cs::is_set( settings.if_gain ) )
+        _if_gain[ chan ] = settings.if_gain;
+      if ( cs::is_set( settings.bb_gain ) )
+        _bb_gain[ chan ] = settings.bb_gain;
+      if ( cs::is_set( settings.bandwidth ) )
+        _bandwidth[ chan ] = settings.bandwidth;
+      if ( ! settings.antenna.empty() )
+        _antenna[ chan ] = settings.antenna;
+    }
+    if ( cs::is_set( settings.sample_rate ) )
+      _ranges.invalidate();
+    if ( ! settings.antenna.empty() )
+      invalidate_caps( chan );
+
+    /* with exact rates the device runs at a native rate close by */
+    osmosdr::channel_settings native = settings;
+    if ( _exact_rate && cs::is_set( settings.sample_rate ) )
+      native.sample_rate = pick_native_rate( get_native_rates( route->dev_index ),
+                                             settings.sample_rate );
+
+    osmosdr::channel_settings actual;
+    double sample_rate = 0;
+    _execs[ route->dev_index ]->call( [&]() {
+      actual = dev->configure( native, dev_chan );
+      if ( cs::is_set( settings.sample_rate ) )
+        sample_rate = dev->get_sample_rate();
+    } );
+
+    follow_probe( dev, dev_chan,
+                  cs::is_set( settings.sample_rate ) ? sample_rate : NAN,
+                  ! cs::is_set( settings.center_freq ) ? NAN :
+                  cs::is_set( actual.center_freq ) ? actual.center_freq :
+                                                     settings.center_freq );
+
+    if ( cs::is_set( settings.sample_rate ) ) {
+      if ( route->dev_index < _channelizers.size() && _channelizers[ route->dev_index ] )
+        _channelizers[ route->dev_index ]->set_sample_rate( sample_rate );
+
+      if ( chan < _ncos.size() )
+        _ncos[ chan ]->set_sample_rate( sample_rate );
+
+      if ( _exact_rate ) {
+        set_exact_rate( route->dev_index, sample_rate, settings.sample_rate );
+        actual.sample_rate = settings.sample_rate;
+      }
+
+      if ( chan < _squelch_gates.size() &&
+           ! (route->dev_index < _channelizers.size() && _channelizers[ route->dev_index ]) )
+        _squelch_gates[ chan ]->set_sample_rate( _exact_rate ? settings.sample_rate : sample_rate );
+    }
+
+    /* the hardware was tuned to the channel itself */
+    if ( chan < _ncos.size() && cs::is_set( settings.center_freq ) ) {
+      _ncos[ chan ]->reset();
+
+      boost::mutex::scoped_lock lock( _nco_mutex );
+      _hw_freq[ chan ] = cs::is_set( actual.center_freq ) ?
+                         actual.center_freq : settings.center_freq;
+    }
+
+    return actual;
+  }
+
+  return osmosdr::channel_settings();
+}
+
 void source_impl::set_time_source(const std::string &source, const size_t mboard)
 {
   if (mboard != osmosdr::ALL_MBOARDS){
@@ -984,18 +1351,69 @@ void source_impl::set_time_unknown_pps(const osmosdr::time_spec_t &time_spec)
 
 
 void source_impl::set_biast( bool enabled ) {
-  BOOST_FOREACH( source_iface *dev, _devs )
+  for (size_t i = 0; i < _devs.size(); i++)
   {
-    dev->set_biast(enabled);
+    source_iface *dev = _devs[i];
+    _execs[i]->call( [dev, enabled]() { dev->set_biast(enabled); } );
   }
 }
 
 bool source_impl::get_biast() {
-  BOOST_FOREACH( source_iface *dev, _devs )
+  for (size_t i = 0; i < _devs.size(); i++)
   {
-    if (dev->get_biast()) {
+    source_iface *dev = _devs[i];
+    if (query( i, [dev]() { return dev->get_biast(); } )) {
       return true;
     }
   }
   return false;
 }
+
+/*
+ * Runs on the control thread of the hop gate of chan. Returns the number of
+ * samples the tuner needs to settle at the current sample rate.
+ */
+hop_settle_t source_impl::hop_retune( size_t chan, const osmosdr::hop_t &hop )
+{
+  const route_t *route = _routes.find( chan );
+  if ( ! route )
+    return hop_settle_t();
+
+  double before = get_center_freq( chan );
+  boost::shared_future< double > gain;
+
+  if ( osmosdr::channel_settings::is_set( hop.gain ) )
+    gain = set_gain_async( hop.gain, chan );
+
+  /* nothing settles when the NCO covers the step */
+  bool fine = fine_tune( chan, hop.freq );
+  if ( ! fine )
+    set_center_freq_async( hop.freq, chan ).get();
+
+  if ( gain.valid() )
+    gain.get();
+
+  double settle = fine ? 0 : _settle, rate = 0;
+  bool tags = false;
+  _execs[ route->dev_index ]->call( [&]() {
+    if ( settle < 0 )
+      settle = route->dev->get_settle_time( route->dev_chan );
+    rate = route->dev->get_sample_rate();
+    tags = route->dev->tags_changes();
+  } );
+
+  /* the NCO tags its new offset, the device a retune if it tags changes,
+   * neither when the frequency stayed the same. Waiting for the tag is
+   * given up after a second. */
+  bool tagged = get_center_freq( chan ) != before && ( fine || tags );
+
+  return hop_settle_t( size_t( settle * rate + 0.5 ), tagged, size_t( rate ) );
+}
+
+void source_impl::set_hop_schedule( const osmosdr::hop_schedule_t &schedule, size_t chan )
+{
+  if ( chan >= _hop_gates.size() )
+    throw std::runtime_error( "Hopping needs the hop device argument." );
+
+  _hop_gates[ chan ]->set_schedule( schedule );
+}
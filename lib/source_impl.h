@@ -28,13 +28,29 @@
 #endif
 
 #include <source_iface.h>
+#include "channel_routes.h"
+#include "hop_gate_cc.h"
 
 #include <map>
 
+#include <boost/function.hpp>
+#include <boost/utility/result_of.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+class device_executor;
+class channelizer_cc;
+class nco_cc;
+class resampler_cc;
+class squelch_gate_cc;
+class spectrum_probe_c;
+class command_handler;
+
 class source_impl : public osmosdr::source
 {
 public:
   source_impl( const std::string & args );
+  ~source_impl();
 
   size_t get_num_channels( void );
 
@@ -42,12 +58,15 @@ public:
 
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
+  boost::shared_future< double > set_sample_rate_async( double rate );
   double get_sample_rate( void );
 
   osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
   double set_center_freq( double freq, size_t chan = 0 );
+  boost::shared_future< double > set_center_freq_async( double freq, size_t chan = 0 );
   double get_center_freq( size_t chan = 0 );
   double set_freq_corr( double ppm, size_t chan = 0 );
+  boost::shared_future< double > set_freq_corr_async( double ppm, size_t chan = 0 );
   double get_freq_corr( size_t chan = 0 );
 
   std::vector<std::string> get_gain_names( size_t chan = 0 );
@@ -56,12 +75,16 @@ public:
   bool set_gain_mode( bool automatic, size_t chan = 0 );
   bool get_gain_mode( size_t chan = 0 );
   double set_gain( double gain, size_t chan = 0 );
+  boost::shared_future< double > set_gain_async( double gain, size_t chan = 0 );
   double set_gain( double gain, const std::string & name, size_t chan = 0 );
+  boost::shared_future< double > set_gain_async( double gain, const std::string & name, size_t chan = 0 );
   double get_gain( size_t chan = 0 );
   double get_gain( const std::string & name, size_t chan = 0 );
 
   double set_if_gain( double gain, size_t chan = 0 );
+  boost::shared_future< double > set_if_gain_async( double gain, size_t chan = 0 );
   double set_bb_gain( double gain, size_t chan = 0 );
+  boost::shared_future< double > set_bb_gain_async( double gain, size_t chan = 0 );
 
   std::vector< std::string > get_antennas( size_t chan = 0 );
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
@@ -74,9 +97,13 @@ public:
   void set_iq_balance( const std::complex<double> &balance, size_t chan = 0 );
 
   double set_bandwidth( double bandwidth, size_t chan = 0 );
+  boost::shared_future< double > set_bandwidth_async( double bandwidth, size_t chan = 0 );
   double get_bandwidth( size_t chan = 0 );
   osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
 
+  osmosdr::channel_settings configure( const osmosdr::channel_settings &settings,
+                                       size_t chan = 0 );
+
   void set_time_source(const std::string &source, const size_t mboard = 0);
   std::string get_time_source(const size_t mboard);
   std::vector<std::string> get_time_sources(const size_t mboard);
@@ -94,10 +121,44 @@ public:
   void set_biast( bool enabled );
   bool get_biast();
 
+  void set_hop_schedule( const osmosdr::hop_schedule_t &schedule, size_t chan = 0 );
+
 private:
+  typedef boost::function< double ( source_iface *, size_t ) > setter_t;
+  typedef channel_routes< source_iface >::route route_t;
+
+  void invalidate_caps( size_t chan );
+  osmosdr::meta_range_t get_native_rates( size_t dev_index );
+  void set_exact_rate( size_t dev_index, double native, double rate );
+  hop_settle_t hop_retune( size_t chan, const osmosdr::hop_t &hop );
+  bool fine_tune( size_t chan, double freq );
+  void follow_probe( source_iface *dev, size_t dev_chan, double rate, double freq );
+#ifdef HAVE_IQBALANCE
+  struct iq_stage_t;
+  bool set_iq_stage( iq_stage_t &stage, bool enabled );
+#endif
+  boost::shared_future< double > apply_setting( size_t chan, double value,
+                                                std::map< size_t, double > &cache,
+                                                bool force, const setter_t &setter );
+
+  /* runs a driver query on the executor of the device, behind its setters */
+  template< typename F >
+  typename boost::result_of< F () >::type query( size_t dev_index, F getter )
+  {
+    typename boost::result_of< F () >::type value;
+    _execs[ dev_index ]->call( [&]() { value = getter(); } );
+    return value;
+  }
+
   std::vector< source_iface * > _devs;
+  channel_routes< source_iface > _routes;
+
+  caps_cache< osmosdr::meta_range_t > _ranges;
+  caps_cache< std::vector< std::string > > _names;
 
-  /* cache to prevent multiple device calls with the same value coming from grc */
+  /* cache to prevent multiple device calls with the same value coming from grc,
+   * updated from the caller, hop gate and command threads under _cache_mutex */
+  boost::mutex _cache_mutex;
   double _sample_rate;
   std::map< size_t, double > _center_freq;
   std::map< size_t, double > _freq_corr;
@@ -107,11 +168,49 @@ private:
   std::map< size_t, double > _bb_gain;
   std::map< size_t, std::string > _antenna;
 #ifdef HAVE_IQBALANCE
-  std::vector< gr::iqbalance::fix_cc * > _iq_fix;
-  std::vector< gr::iqbalance::optimize_c * > _iq_opt;
-  std::map< size_t, std::pair<float, float> > _vals;
+  /* the iqbalance blocks only sit between src and dst while not off */
+  struct iq_stage_t
+  {
+    iq_stage_t( gr::basic_block_sptr block, int port )
+      : src( block ), src_port( port ), dst_port( 0 ), vals( 0.0f, 0.0f ) {}
+
+    gr::basic_block_sptr src;
+    int src_port;
+    gr::basic_block_sptr dst;
+    int dst_port;
+    gr::iqbalance::optimize_c::sptr opt;
+    gr::iqbalance::fix_cc::sptr fix;
+    std::pair< float, float > vals; /* kept for manual mode while off */
+  };
+
+  std::vector< boost::shared_ptr< iq_stage_t > > _iq_stages; /* by channel */
+  boost::mutex _iq_mutex;
 #endif
   std::map< size_t, double > _bandwidth;
+
+  std::vector< boost::shared_ptr< channelizer_cc > > _channelizers; /* by device */
+
+  boost::shared_ptr< command_handler > _commands; /* of the command port */
+
+  std::vector< boost::shared_ptr< hop_gate_cc > > _hop_gates;
+  double _settle; /* seconds, negative to use the tuner's own */
+
+  std::vector< boost::shared_ptr< nco_cc > > _ncos;
+  double _nco_span; /* share of the passband fine-tuned, 0 when disabled */
+  boost::mutex _nco_mutex;
+  std::map< size_t, double > _hw_freq; /* where the hardware was tuned last */
+
+  bool _exact_rate; /* rate_mode=exact, resampling from a native rate */
+  std::vector< boost::shared_ptr< resampler_cc > > _resamplers;
+
+  std::vector< boost::shared_ptr< squelch_gate_cc > > _squelch_gates; /* by channel */
+
+  /* by device channel, set up in the constructor */
+  std::map< std::pair< source_iface *, size_t >,
+            boost::shared_ptr< spectrum_probe_c > > _probes;
+
+  /* drained in the destructor, the devices hold them as well */
+  std::vector< boost::shared_ptr< device_executor > > _execs;
 };
 
 #endif /* INCLUDED_OSMOSDR_SOURCE_IMPL_H */
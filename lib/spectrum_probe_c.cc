@@ -0,0 +1,270 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <gnuradio/io_signature.h>
+
+#include <volk/volk.h>
+
+#include <boost/foreach.hpp>
+
+#include "spectrum_probe_c.h"
+
+spectrum_probe_c_sptr make_spectrum_probe_c( size_t size, double frame_rate,
+                                             size_t average, size_t chan )
+{
+  return gnuradio::get_initial_sptr( new spectrum_probe_c( size, frame_rate, average, chan ) );
+}
+
+spectrum_probe_c::spectrum_probe_c( size_t size, double frame_rate,
+                                    size_t average, size_t chan ) :
+  gr::sync_block( "spectrum_probe_c",
+                  gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+                  gr::io_signature::make( 0, 0, 0 ) ),
+  _size( size ),
+  _frame_rate( frame_rate ),
+  _average( std::max< size_t >( average, 1 ) ),
+  _chan( chan ),
+  _rate( 0 ),
+  _freq( 0 ),
+  _skip( 0 ),
+  _capture( size ),
+  _captured( 0 ),
+  _stop( false ),
+  _ready( false ),
+  _frame( size ),
+  _frame_rate_hz( 0 ),
+  _frame_freq( 0 ),
+  _rate_set( false ),
+  _freq_set( false ),
+  _set_rate( 0 ),
+  _set_freq( 0 ),
+  _fft( size, true ),
+  _window( size ),
+  _sum( size ),
+  _summed( 0 )
+{
+  if ( size < 16 )
+    throw std::runtime_error( "The spectrum size must be at least 16." );
+
+  if ( frame_rate <= 0 )
+    throw std::runtime_error( "The spectrum rate must be positive." );
+
+  /* 4 term blackman-harris, scaled for a full scale tone to read 0 dBFS */
+  double sum = 0;
+  for (size_t i = 0; i < size; i++) {
+    double x = 2 * M_PI * i / (size - 1);
+    _window[i] = 0.35875 - 0.48829 * std::cos( x ) +
+                 0.14128 * std::cos( 2 * x ) - 0.01168 * std::cos( 3 * x );
+    sum += _window[i];
+  }
+
+  for (size_t i = 0; i < size; i++)
+    _window[i] /= sum;
+
+  message_port_register_out( pmt::mp("spectrum") );
+}
+
+spectrum_probe_c::~spectrum_probe_c()
+{
+  stop();
+}
+
+bool spectrum_probe_c::start()
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _stop = false;
+
+  if ( ! _thread.joinable() )
+    _thread = boost::thread( &spectrum_probe_c::analyze, this );
+
+  return true;
+}
+
+bool spectrum_probe_c::stop()
+{
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+    _stop = true;
+  }
+
+  _cond.notify_all();
+
+  if ( _thread.joinable() )
+    _thread.join();
+
+  return true;
+}
+
+void spectrum_probe_c::set_sample_rate( double rate )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _set_rate = rate;
+  _rate_set = true;
+}
+
+void spectrum_probe_c::set_center_freq( double freq )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  _set_freq = freq;
+  _freq_set = true;
+}
+
+/* Keeps up with the rate and the frequency of the stream. */
+void spectrum_probe_c::follow( int noutput_items )
+{
+  std::vector< gr::tag_t > tags;
+  uint64_t start = nitems_read( 0 );
+
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+
+    if ( _rate_set )
+      _rate = _set_rate;
+    if ( _freq_set )
+      _freq = _set_freq;
+
+    _rate_set = _freq_set = false;
+  }
+
+  get_tags_in_range( tags, 0, start, start + noutput_items );
+
+  BOOST_FOREACH( const gr::tag_t &tag, tags ) {
+    if ( pmt::eq( tag.key, pmt::mp("rx_rate") ) && pmt::is_number( tag.value ) )
+      _rate = pmt::to_double( tag.value );
+    else if ( pmt::eq( tag.key, pmt::mp("rx_freq") ) && pmt::is_number( tag.value ) )
+      _freq = pmt::to_double( tag.value );
+  }
+}
+
+int spectrum_probe_c::work( int noutput_items,
+                            gr_vector_const_void_star &input_items,
+                            gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *)input_items[0];
+  size_t pos = 0;
+
+  follow( noutput_items );
+
+  while ( pos < size_t( noutput_items ) ) {
+    if ( _skip ) {
+      size_t n = std::min( _skip, noutput_items - pos );
+      _skip -= n;
+      pos += n;
+      continue;
+    }
+
+    size_t n = std::min( _size - _captured, noutput_items - pos );
+    memcpy( &_capture[ _captured ], in + pos, n * sizeof(gr_complex) );
+    _captured += n;
+    pos += n;
+
+    if ( _captured < _size )
+      break;
+
+    _captured = 0;
+
+    /* the start of the next capture, taken frame_rate * average times a second */
+    double interval = _rate / (_frame_rate * _average);
+    _skip = interval > _size ? size_t( interval ) - _size : 0;
+
+    boost::mutex::scoped_lock lock( _mutex );
+
+    if ( _ready ) /* still busy with the last one, this one is dropped */
+      continue;
+
+    _capture.swap( _frame );
+    _frame_rate_hz = _rate;
+    _frame_freq = _freq;
+    _ready = true;
+    _cond.notify_all();
+  }
+
+  return noutput_items;
+}
+
+void spectrum_probe_c::analyze()
+{
+  std::vector< float > power( _size );
+  std::vector< float > spectrum( _size );
+  double sum_rate = 0, sum_freq = 0;
+
+  boost::mutex::scoped_lock lock( _mutex );
+
+  while ( true ) {
+    while ( ! _ready && ! _stop )
+      _cond.wait( lock );
+
+    if ( _stop )
+      break;
+
+    gr_complex *buf = _fft.get_inbuf();
+    volk_32fc_32f_multiply_32fc( buf, &_frame[0], &_window[0], _size );
+    double rate = _frame_rate_hz, freq = _frame_freq;
+    _ready = false;
+
+    lock.unlock();
+
+    _fft.execute();
+    volk_32fc_magnitude_squared_32f( &power[0], _fft.get_outbuf(), _size );
+
+    /* retuning starts the average over */
+    if ( rate != sum_rate || freq != sum_freq ) {
+      sum_rate = rate;
+      sum_freq = freq;
+      _summed = 0;
+    }
+
+    if ( _summed )
+      volk_32f_x2_add_32f( &_sum[0], &_sum[0], &power[0], _size );
+    else
+      _sum.swap( power );
+
+    if ( ++_summed == _average ) {
+      /* the negative frequencies come first */
+      for (size_t i = 0; i < _size; i++) {
+        float mean = _sum[ (i + (_size + 1) / 2) % _size ] / _average;
+        spectrum[i] = 10 * std::log10( std::max( mean, 1e-20f ) );
+      }
+
+      _summed = 0;
+
+      pmt::pmt_t meta = pmt::make_dict();
+      meta = pmt::dict_add( meta, pmt::mp("chan"), pmt::from_long( _chan ) );
+      meta = pmt::dict_add( meta, pmt::mp("freq"), pmt::from_double( freq ) );
+      meta = pmt::dict_add( meta, pmt::mp("rate"), pmt::from_double( rate ) );
+      meta = pmt::dict_add( meta, pmt::mp("size"), pmt::from_long( _size ) );
+
+      message_port_pub( pmt::mp("spectrum"),
+                        pmt::cons( meta, pmt::init_f32vector( _size, spectrum ) ) );
+    }
+
+    lock.lock();
+  }
+}
@@ -0,0 +1,120 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_SPECTRUM_PROBE_C_H
+#define OSMOSDR_SPECTRUM_PROBE_C_H
+
+#include <vector>
+
+#include <gnuradio/sync_block.h>
+#include <gnuradio/fft/fft.h>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+class spectrum_probe_c;
+
+typedef boost::shared_ptr< spectrum_probe_c > spectrum_probe_c_sptr;
+
+/*
+ * size is the FFT size, frame_rate the spectra per second, each averaged
+ * over average FFTs. chan is given along with the spectra.
+ */
+spectrum_probe_c_sptr make_spectrum_probe_c( size_t size, double frame_rate,
+                                             size_t average, size_t chan );
+
+/*!
+ * \brief Publishes averaged power spectra of a stream at a low rate.
+ *
+ * The work function only copies the size samples of each FFT out of the
+ * stream, spaced so that frame_rate * average of them are taken per second
+ * (back to back while the rate is unknown), and skips all others. The FFTs
+ * run on a thread of their own, a capture arriving while it is still busy
+ * is dropped, so the stream never waits for them.
+ *
+ * Each spectrum is published on the spectrum port as a pair of a dictionary
+ * with chan, freq, rate and size, freq and rate as last set or tagged with
+ * rx_freq and rx_rate, and of a vector of the power of the bins in dBFS, a full
+ * scale tone reading 0 dBFS. The bins run from -rate/2 to rate/2.
+ */
+class spectrum_probe_c : public gr::sync_block
+{
+private:
+  friend spectrum_probe_c_sptr make_spectrum_probe_c( size_t size, double frame_rate,
+                                                      size_t average, size_t chan );
+
+  spectrum_probe_c( size_t size, double frame_rate, size_t average, size_t chan );
+
+public:
+  ~spectrum_probe_c();
+
+  bool start();
+  bool stop();
+
+  /* for devices that don't tag their changes, taken up by the next work() */
+  void set_sample_rate( double rate );
+  void set_center_freq( double freq );
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+private:
+  void follow( int noutput_items );
+  void analyze();
+
+  size_t _size;
+  double _frame_rate;
+  size_t _average;
+  size_t _chan;
+
+  /* on the stream */
+  double _rate;
+  double _freq;
+  size_t _skip;                       /* samples until the next capture */
+  std::vector< gr_complex > _capture;
+  size_t _captured;
+
+  /* handed over to the thread */
+  boost::mutex _mutex;
+  boost::condition_variable _cond;
+  boost::thread _thread;
+  bool _stop;
+  bool _ready;
+  std::vector< gr_complex > _frame;
+  double _frame_rate_hz; /* rate and freq of the capture in _frame */
+  double _frame_freq;
+
+  /* handed over to the stream */
+  bool _rate_set;
+  bool _freq_set;
+  double _set_rate;
+  double _set_freq;
+
+  /* on the thread */
+  gr::fft::fft_complex _fft;
+  std::vector< float > _window;
+  std::vector< float > _sum;
+  size_t _summed;
+};
+
+#endif // OSMOSDR_SPECTRUM_PROBE_C_H
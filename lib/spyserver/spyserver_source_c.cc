@@ -33,6 +33,7 @@
 #include <algorithm>
 
 #include <boost/assign.hpp>
+#include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/thread/thread.hpp>
@@ -40,6 +41,7 @@
 #include <gnuradio/io_signature.h>
 
 #include "spyserver_source_c.h"
+#include "driver_registry.h"
 #include "spyserver_protocol.h"
 
 #include "arg_helpers.h"
@@ -83,6 +85,7 @@ spyserver_source_c::spyserver_source_c (const std::string &args)
     last_sequence_number(0),
 
     streaming_mode(STREAM_MODE_IQ_ONLY),
+    _samp_in(0),
     _sample_rate(0),
     _center_freq(0),
     _gain(0),
@@ -526,6 +529,7 @@ void spyserver_source_c::process_uint8_samples() {
     _fifo->push_back(gr_complex(*sample - 128.f / 128.f, *(sample+1) - 128.f / 128.f));
     sample += 2;
   }
+  _samp_in += to_copy;
   _fifo_lock.unlock();
   if (to_copy) {
     _samp_avail.notify_one();
@@ -550,6 +554,7 @@ void spyserver_source_c::process_int16_samples() {
     _fifo->push_back(gr_complex(*sample / 32768.f, *(sample+1) / 32768.f));
     sample += 2;
   }
+  _samp_in += to_copy;
   _fifo_lock.unlock();
   if (to_copy) {
     _samp_avail.notify_one();
@@ -573,12 +578,20 @@ void spyserver_source_c::process_float_samples() {
     _fifo->push_back(gr_complex(*sample, *(sample+1)));
     sample += 2;
   }
+  _samp_in += to_copy;
   _fifo_lock.unlock();
   if (to_copy) {
     _samp_avail.notify_one();
   }
 }
 
+/* the position of the first sample of the next message */
+uint64_t spyserver_source_c::samples_received() {
+  boost::mutex::scoped_lock lock(_fifo_lock);
+
+  return _samp_in;
+}
+
 void spyserver_source_c::set_stream_state() {
   set_setting(SETTING_STREAMING_ENABLED, {(unsigned int)(streaming ? 1 : 0)});
 }
@@ -591,6 +604,7 @@ double spyserver_source_c::set_sample_rate(double sampleRate) {
               channel_decimation_stage_count = _sample_rates[i].second;
               set_setting(SETTING_IQ_DECIMATION, {channel_decimation_stage_count});
               _sample_rate = sampleRate;
+              _changes.post("rx_rate", sampleRate, samples_received());
               return get_sample_rate();
       }
     }
@@ -608,6 +622,7 @@ double spyserver_source_c::set_center_freq(double centerFrequency, size_t chan)
   if (centerFrequency <= 0xFFFFFFFF) {
     channel_center_frequency = (uint32_t) centerFrequency;
     set_setting(SETTING_IQ_FREQUENCY, {channel_center_frequency});
+    _changes.post("rx_freq", centerFrequency, samples_received());
     return centerFrequency;
   }
 
@@ -679,6 +694,8 @@ int spyserver_source_c::work( int noutput_items,
     n_samples_avail = _fifo->size();
   }
 
+  uint64_t pos = _samp_in - n_samples_avail;
+
   for(int i = 0; i < noutput_items; ++i) {
     out[i] = _fifo->at(0);
     _fifo->pop_front();
@@ -686,6 +703,9 @@ int spyserver_source_c::work( int noutput_items,
 
   //std::cerr << "-" << std::flush;
 
+  BOOST_FOREACH( const gr::tag_t &change, _changes.take( pos, noutput_items, nitems_written( 0 ) ) )
+    add_item_tag( 0, change );
+
   return noutput_items;
 }
 
@@ -784,6 +804,7 @@ double spyserver_source_c::set_gain( double gain, size_t chan )
   if (can_control) {
     _gain = gain;
     set_setting(SETTING_GAIN, {(uint32_t)gain});
+    _changes.post("rx_gain", gain, samples_received());
   } else {
     std::cerr << "Spyserver: The server does not allow you to change the gains." << std::endl;
   }
@@ -876,3 +897,6 @@ void spyserver_source_c::set_biast( bool enabled ) {
 bool spyserver_source_c::get_biast() {
   return false;
 }
+
+OSMOSDR_REGISTER_SOURCE( spyserver, "spyserver", PROBE_SOFTWARE,
+                         make_spyserver_source_c, spyserver_source_c::get_devices( fake ) );
@@ -99,6 +99,7 @@ public:
   osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
   double set_center_freq( double freq, size_t chan = 0 );
   double get_center_freq( size_t chan = 0 );
+  bool tags_changes() { return true; }
   double set_freq_corr( double ppm, size_t chan = 0 );
   double get_freq_corr( size_t chan = 0 );
 
@@ -162,6 +163,7 @@ private:
   void process_uint8_samples();
   void process_int16_samples();
   void process_float_samples();
+  uint64_t samples_received();
   void process_uint8_fft();
   void handle_new_message();
   void set_stream_state();
@@ -195,12 +197,15 @@ private:
   boost::circular_buffer<gr_complex> *_fifo;
   boost::mutex _fifo_lock;
   boost::condition_variable _samp_avail;
+  uint64_t _samp_in; /* samples put into the fifo since connecting */
 
   std::vector< std::pair<double, uint32_t> > _sample_rates;
   double _sample_rate;
   double _center_freq;
   double _gain;
   double _digitalGain;
+
+  change_tags _changes;
 };
 
 #endif /* INCLUDED_SPYSERVER_SOURCE_C_H */
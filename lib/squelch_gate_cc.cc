@@ -0,0 +1,257 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sys/time.h>
+
+#include <gnuradio/io_signature.h>
+
+#include <volk/volk.h>
+
+#include <boost/foreach.hpp>
+
+#include "squelch_gate_cc.h"
+
+#define DETECT_TIME 1e-3 /* seconds of samples per power measurement */
+#define DETECT_MIN  16
+#define DETECT_MAX  4096
+
+squelch_gate_cc_sptr make_squelch_gate_cc( double threshold, double hang, double preroll )
+{
+  return gnuradio::get_initial_sptr( new squelch_gate_cc( threshold, hang, preroll ) );
+}
+
+squelch_gate_cc::squelch_gate_cc( double threshold, double hang, double preroll ) :
+  gr::block( "squelch_gate_cc",
+             gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+             gr::io_signature::make( 1, 1, sizeof(gr_complex) ) ),
+  _threshold( std::pow( 10.0, threshold / 10 ) ),
+  _hang( hang ),
+  _preroll( preroll ),
+  _rate( 0 ),
+  _remaining( 0 ),
+  _open( false ),
+  _pending_pos( 0 ),
+  _anchored( false ),
+  _anchor_offset( 0 )
+{
+  /* samples are dropped, tags are moved along with the ones passed */
+  set_tag_propagation_policy( TPP_DONT );
+
+  resize();
+}
+
+void squelch_gate_cc::set_sample_rate( double rate )
+{
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( rate == _rate )
+    return;
+
+  _rate = rate;
+  resize();
+}
+
+/* Called with _mutex held. */
+void squelch_gate_cc::resize()
+{
+  _block_len = std::min< size_t >( DETECT_MAX,
+                 std::max< size_t >( DETECT_MIN, size_t( _rate * DETECT_TIME ) ) );
+  _hang_len = size_t( _hang * _rate );
+  _remaining = std::min( _remaining, _hang_len );
+
+  /* the newest samples stay */
+  _history.rset_capacity( size_t( _preroll * _rate ) );
+}
+
+/* Keeps the time base up with the tags coming in, called with _mutex held. */
+void squelch_gate_cc::follow( const gr::tag_t &tag )
+{
+  if ( pmt::eq( tag.key, pmt::mp("rx_time") ) && pmt::is_tuple( tag.value ) &&
+       pmt::length( tag.value ) == 2 ) {
+    _anchor_time = osmosdr::time_spec_t(
+          time_t( pmt::to_uint64( pmt::tuple_ref( tag.value, 0 ) ) ),
+          pmt::to_double( pmt::tuple_ref( tag.value, 1 ) ) );
+    _anchor_offset = tag.offset;
+    _anchored = true;
+  } else if ( pmt::eq( tag.key, pmt::mp("rx_rate") ) && pmt::is_number( tag.value ) ) {
+    double rate = pmt::to_double( tag.value );
+
+    if ( rate > 0 && rate != _rate ) {
+      _anchor_time = time_at( tag.offset );
+      _anchor_offset = tag.offset;
+      _rate = rate;
+      resize();
+    }
+  }
+}
+
+osmosdr::time_spec_t squelch_gate_cc::time_at( uint64_t offset )
+{
+  osmosdr::time_spec_t time = _anchor_time;
+
+  if ( _rate > 0 )
+    time += osmosdr::time_spec_t( double( int64_t( offset - _anchor_offset ) ) / _rate );
+
+  return time;
+}
+
+void squelch_gate_cc::pass( const gr_complex *in, gr_complex *out, int n,
+                            int consumed, int produced )
+{
+  memcpy( out, in, n * sizeof(gr_complex) );
+
+  std::vector< gr::tag_t > tags;
+  uint64_t start = nitems_read( 0 ) + consumed;
+
+  get_tags_in_range( tags, 0, start, start + n );
+
+  BOOST_FOREACH( gr::tag_t &tag, tags ) {
+    follow( tag );
+
+    tag.offset = nitems_written( 0 ) + produced + (tag.offset - start);
+    add_item_tag( 0, tag );
+  }
+}
+
+void squelch_gate_cc::hold( const gr_complex *in, int n, int consumed )
+{
+  size_t keep = std::min( size_t( n ), _history.capacity() );
+  _history.insert( _history.end(), in + n - keep, in + n );
+
+  std::vector< gr::tag_t > tags;
+  uint64_t start = nitems_read( 0 ) + consumed;
+
+  get_tags_in_range( tags, 0, start, start + n );
+
+  BOOST_FOREACH( const gr::tag_t &tag, tags ) {
+    follow( tag );
+
+    /* the time is given anew at the start of the burst */
+    if ( ! pmt::eq( tag.key, pmt::mp("rx_time") ) )
+      _held[ pmt::symbol_to_string( tag.key ) ] = tag;
+  }
+}
+
+/* Opens the gate ahead of the block at consumed, the preroll goes first. */
+void squelch_gate_cc::open( int consumed, int produced )
+{
+  uint64_t first = nitems_read( 0 ) + consumed - _history.size();
+  uint64_t offset = nitems_written( 0 ) + produced;
+  osmosdr::time_spec_t time = time_at( first );
+
+  add_item_tag( 0, offset, pmt::mp("burst_start"), pmt::PMT_T );
+  add_item_tag( 0, offset, pmt::mp("rx_time"),
+                pmt::make_tuple( pmt::from_uint64( time.get_full_secs() ),
+                                 pmt::from_double( time.get_frac_secs() ) ) );
+
+  BOOST_FOREACH( held_t::value_type &held, _held ) {
+    held.second.offset = offset;
+    add_item_tag( 0, held.second );
+  }
+  _held.clear();
+
+  _pending.assign( _history.begin(), _history.end() );
+  _pending_pos = 0;
+  _history.clear();
+
+  _remaining = _hang_len;
+  _open = true;
+}
+
+int squelch_gate_cc::general_work( int noutput_items,
+                                   gr_vector_int &ninput_items,
+                                   gr_vector_const_void_star &input_items,
+                                   gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *)input_items[0];
+  gr_complex *out = (gr_complex *)output_items[0];
+
+  int consumed = 0, produced = 0;
+
+  boost::mutex::scoped_lock lock( _mutex );
+
+  if ( ! _anchored ) {
+    struct timeval tv;
+    gettimeofday( &tv, NULL );
+
+    /* the newest sample has just arrived */
+    _anchor_time = osmosdr::time_spec_t( tv.tv_sec, tv.tv_usec * 1e-6 );
+    _anchor_offset = nitems_read( 0 ) + ninput_items[0];
+    _anchored = true;
+  }
+
+  while ( true ) {
+    if ( _pending_pos < _pending.size() ) {
+      int n = std::min( int( _pending.size() - _pending_pos ), noutput_items - produced );
+      if ( n <= 0 )
+        break;
+
+      memcpy( out + produced, &_pending[ _pending_pos ], n * sizeof(gr_complex) );
+      _pending_pos += n;
+      produced += n;
+      continue;
+    }
+
+    int n = std::min( int( _block_len ), ninput_items[0] - consumed );
+    if ( _open )
+      n = std::min( n, noutput_items - produced );
+    if ( n <= 0 )
+      break;
+
+    lv_32fc_t energy;
+    volk_32fc_x2_conjugate_dot_prod_32fc( &energy, in + consumed, in + consumed, n );
+    bool active = energy.real() >= _threshold * n;
+
+    if ( ! _open ) {
+      if ( active ) {
+        if ( produced == noutput_items )
+          break;
+
+        open( consumed, produced ); /* the block is measured again once open */
+      } else {
+        hold( in + consumed, n, consumed );
+        consumed += n;
+      }
+      continue;
+    }
+
+    pass( in + consumed, out + produced, n, consumed, produced );
+    consumed += n;
+    produced += n;
+
+    if ( active ) {
+      _remaining = _hang_len;
+    } else if ( _remaining > size_t( n ) ) {
+      _remaining -= n;
+    } else {
+      add_item_tag( 0, nitems_written( 0 ) + produced - 1, pmt::mp("burst_end"), pmt::PMT_T );
+      _open = false;
+    }
+  }
+
+  consume_each( consumed );
+
+  return produced;
+}
@@ -0,0 +1,109 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_SQUELCH_GATE_CC_H
+#define OSMOSDR_SQUELCH_GATE_CC_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gnuradio/block.h>
+
+#include <boost/circular_buffer.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <osmosdr/time_spec.h>
+
+class squelch_gate_cc;
+
+typedef boost::shared_ptr< squelch_gate_cc > squelch_gate_cc_sptr;
+
+/*
+ * threshold is the mean power in dBFS opening the gate, hang and preroll
+ * are in seconds.
+ */
+squelch_gate_cc_sptr make_squelch_gate_cc( double threshold, double hang, double preroll );
+
+/*!
+ * \brief Passes bursts of activity only, dropping the samples in between.
+ *
+ * The mean power is measured over blocks of about a millisecond. A block
+ * reaching the threshold opens the gate, which closes again once the power
+ * stayed below it for the hang time. The samples of the preroll time ahead
+ * of the opening block are passed as part of the burst.
+ *
+ * The first sample of a burst is tagged with burst_start and with its
+ * rx_time, taken from the rx_time tags coming in or else from the time of
+ * day the first samples arrived at, and advanced by the rx_rate tags. The
+ * last sample of a burst is tagged with burst_end. Tags of dropped samples
+ * are moved to the start of the next burst, the latest of each key.
+ */
+class squelch_gate_cc : public gr::block
+{
+private:
+  friend squelch_gate_cc_sptr make_squelch_gate_cc( double threshold, double hang,
+                                                    double preroll );
+
+  squelch_gate_cc( double threshold, double hang, double preroll );
+
+public:
+  /* sets the rate the times are counted in until an rx_rate tag comes in */
+  void set_sample_rate( double rate );
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+private:
+  typedef std::map< std::string, gr::tag_t > held_t; /* by key */
+
+  void resize();
+  void follow( const gr::tag_t &tag );
+  osmosdr::time_spec_t time_at( uint64_t offset );
+
+  void pass( const gr_complex *in, gr_complex *out, int n, int consumed, int produced );
+  void hold( const gr_complex *in, int n, int consumed );
+  void open( int consumed, int produced );
+
+  boost::mutex _mutex;
+  float _threshold; /* linear mean power */
+  double _hang;
+  double _preroll;
+  double _rate;
+
+  size_t _block_len;
+  size_t _hang_len;
+  size_t _remaining; /* of the hang time */
+  bool _open;
+
+  boost::circular_buffer< gr_complex > _history; /* the preroll while closed */
+  std::vector< gr_complex > _pending;            /* the preroll being passed */
+  size_t _pending_pos;
+  held_t _held;                                  /* tags of dropped samples */
+
+  bool _anchored;
+  uint64_t _anchor_offset; /* of the input sample at _anchor_time */
+  osmosdr::time_spec_t _anchor_time;
+};
+
+#endif // OSMOSDR_SQUELCH_GATE_CC_H
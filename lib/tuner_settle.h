@@ -0,0 +1,57 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef OSMOSDR_TUNER_SETTLE_H
+#define OSMOSDR_TUNER_SETTLE_H
+
+#include <string>
+
+/*
+ * Typical time from a retune until the tuner delivers usable samples
+ * again, in seconds. It covers the PLL lock and the filters settling,
+ * not the samples still buffered on the way to the host.
+ */
+inline double tuner_settle_time( const std::string &tuner )
+{
+  static const struct {
+    const char *tuner;
+    double settle;
+  } table[] = {
+    { "E4000",    2e-3 },
+    { "FC0012",   2e-3 },
+    { "FC0013",   2e-3 },
+    { "FC2580",   2e-3 },
+    { "R820T",    5e-3 },
+    { "R828D",    5e-3 },
+    { "MAX2837",  1e-3 }, /* HackRF, the RFFC5071 mixer locks faster */
+    { "LMS6002D", 1e-3 }, /* bladeRF 1 */
+    { "LMS7002M", 1e-3 },
+    { "AD9361",   5e-4 }, /* bladeRF 2 */
+  };
+
+  for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+    if ( tuner == table[i].tuner )
+      return table[i].settle;
+
+  return 1e-3;
+}
+
+#endif // OSMOSDR_TUNER_SETTLE_H
@@ -27,6 +27,7 @@
 #include "arg_helpers.h"
 
 #include "uhd_sink_c.h"
+#include "driver_registry.h"
 
 using namespace boost::assign;
 
@@ -423,3 +424,6 @@ void uhd_sink_c::set_time_unknown_pps(const osmosdr::time_spec_t &time_spec)
 {
   _snk->set_time_unknown_pps( uhd::time_spec_t( time_spec.get_full_secs(), time_spec.get_frac_secs() ) );
 }
+
+OSMOSDR_REGISTER_SINK( uhd, "uhd", PROBE_USB | PROBE_NETWORK,
+                         make_uhd_sink_c, uhd_sink_c::get_devices() );
@@ -27,6 +27,7 @@
 #include "arg_helpers.h"
 
 #include "uhd_source_c.h"
+#include "driver_registry.h"
 #include "osmosdr/source.h"
 
 using namespace boost::assign;
@@ -455,3 +456,6 @@ void uhd_source_c::set_time_unknown_pps(const osmosdr::time_spec_t &time_spec)
 {
   _src->set_time_unknown_pps( uhd::time_spec_t( time_spec.get_full_secs(), time_spec.get_frac_secs() ) );
 }
+
+OSMOSDR_REGISTER_SOURCE( uhd, "uhd", PROBE_USB | PROBE_NETWORK,
+                         make_uhd_source_c, uhd_source_c::get_devices() );
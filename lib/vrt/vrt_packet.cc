@@ -0,0 +1,258 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cmath>
+
+#include <arpa/inet.h>
+
+#include "vrt_packet.h"
+
+/* context indicator field 0 bits we know about */
+#define CIF0_CHANGE           (1u << 31)
+#define CIF0_RF_FREQ          (1u << 27)
+#define CIF0_SAMPLE_RATE      (1u << 21)
+#define CIF0_PAYLOAD_FORMAT   (1u << 15)
+
+/* data item formats of the payload format field */
+#define FMT_SIGNED_FIXED      0x00
+#define FMT_IEEE754_SINGLE    0x0e
+#define FMT_COMPLEX_CARTESIAN 1
+
+/* sizes in words of the context fields in front of the payload format,
+ * indexed by their CIF0 bit */
+static const unsigned cif0_words[32] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2,  /* 15: payload format */
+  1, 2, 1, 1, 2, 2, 1, 1, 1, 2, 2, 2, 2, 2, 1, 0   /* 16 ... 31 */
+};
+
+static uint64_t get_u64( const uint32_t *p )
+{
+  return (uint64_t(ntohl(p[0])) << 32) | ntohl(p[1]);
+}
+
+static void put_u64( uint32_t *p, uint64_t val )
+{
+  p[0] = htonl( uint32_t(val >> 32) );
+  p[1] = htonl( uint32_t(val) );
+}
+
+/* 64 bit fixed point with 20 fractional bits, as used for Hz */
+static double get_fixed20( const uint32_t *p )
+{
+  return double( int64_t( get_u64( p ) ) ) / (1 << 20);
+}
+
+static void put_fixed20( uint32_t *p, double val )
+{
+  put_u64( p, uint64_t( int64_t( llround( val * (1 << 20) ) ) ) );
+}
+
+bool vrt_parse( const void *buf, size_t len, vrt_packet &pkt )
+{
+  const uint32_t *words = (const uint32_t *)buf;
+
+  if ( len < 4 )
+    return false;
+
+  uint32_t hdr = ntohl( words[0] );
+  size_t size = hdr & 0xffff;
+
+  if ( size < 1 || size * 4 > len )
+    return false;
+
+  pkt.type = hdr >> 28;
+  pkt.count = (hdr >> 16) & 0xf;
+  pkt.tsi = (hdr >> 22) & 0x3;
+  pkt.tsf = (hdr >> 20) & 0x3;
+
+  if ( pkt.type != VRT_PKT_DATA && pkt.type != VRT_PKT_DATA_SID &&
+       pkt.type != VRT_PKT_CONTEXT )
+    return false;
+
+  size_t pos = 1;
+
+  pkt.has_sid = ( pkt.type != VRT_PKT_DATA );
+  pkt.sid = 0;
+  if ( pkt.has_sid )
+    pkt.sid = ntohl( words[pos++] );
+
+  if ( hdr & (1u << 27) ) /* class id */
+    pos += 2;
+
+  pkt.secs = 0;
+  if ( pkt.tsi != VRT_TSI_NONE )
+    pkt.secs = ntohl( words[pos++] );
+
+  pkt.frac = 0;
+  if ( pkt.tsf != VRT_TSF_NONE ) {
+    pkt.frac = pos + 2 <= size ? get_u64( words + pos ) : 0;
+    pos += 2;
+  }
+
+  /* the trailer bit is only defined for data packets */
+  size_t trailer = ( pkt.type != VRT_PKT_CONTEXT && (hdr & (1u << 26)) ) ? 1 : 0;
+
+  if ( pos + trailer > size )
+    return false;
+
+  pkt.payload = words + pos;
+  pkt.payload_words = size - pos - trailer;
+
+  return true;
+}
+
+bool vrt_parse_context( const vrt_packet &pkt, vrt_context &ctx )
+{
+  if ( pkt.type != VRT_PKT_CONTEXT || pkt.payload_words < 1 )
+    return false;
+
+  const uint32_t *p = pkt.payload;
+  const uint32_t *end = pkt.payload + pkt.payload_words;
+  uint32_t cif0 = ntohl( *p++ );
+
+  /* walk the fields in order of their indicator bits, down to the
+   * payload format, everything after it is of no interest */
+  for ( int bit = 30; bit >= 15; bit-- ) {
+    if ( ! (cif0 & (1u << bit)) )
+      continue;
+
+    if ( p + cif0_words[bit] > end )
+      return false;
+
+    if ( bit == 27 ) {
+      ctx.has_freq = true;
+      ctx.freq = get_fixed20( p );
+    } else if ( bit == 21 ) {
+      ctx.has_rate = true;
+      ctx.rate = get_fixed20( p );
+    } else if ( bit == 15 ) {
+      uint32_t fmt = ntohl( p[0] );
+      unsigned type = (fmt >> 29) & 0x3;
+      unsigned item = (fmt >> 24) & 0x1f;
+      unsigned bits = (fmt & 0x3f) + 1;
+
+      if ( type != FMT_COMPLEX_CARTESIAN )
+        return false;
+
+      if ( item == FMT_SIGNED_FIXED && bits == 16 )
+        ctx.format = SAMPLE_FORMAT_SC16;
+      else if ( item == FMT_SIGNED_FIXED && bits == 8 )
+        ctx.format = SAMPLE_FORMAT_SC8;
+      else if ( item == FMT_IEEE754_SINGLE && bits == 32 )
+        ctx.format = SAMPLE_FORMAT_CF32;
+      else
+        return false;
+
+      ctx.has_format = true;
+    }
+
+    p += cif0_words[bit];
+  }
+
+  return true;
+}
+
+static uint32_t make_header( unsigned type, unsigned count, size_t words )
+{
+  return (type << 28) |
+         (VRT_TSI_UTC << 22) |
+         (VRT_TSF_PICOSECONDS << 20) |
+         ((count & 0xf) << 16) |
+         uint32_t(words);
+}
+
+size_t vrt_pack_data_header( uint32_t *buf, uint32_t sid, unsigned count,
+                             uint32_t secs, uint64_t ps,
+                             sample_format fmt, size_t num_samples )
+{
+  size_t payload = (num_samples * sample_format_size( fmt ) + 3) / 4;
+  size_t words = VRT_DATA_HEADER_WORDS + payload;
+
+  buf[0] = htonl( make_header( VRT_PKT_DATA_SID, count, words ) );
+  buf[1] = htonl( sid );
+  buf[2] = htonl( secs );
+  put_u64( buf + 3, ps );
+
+  return words;
+}
+
+size_t vrt_pack_context( uint32_t *buf, uint32_t sid, unsigned count,
+                         uint32_t secs, uint64_t ps, const vrt_context &ctx )
+{
+  size_t pos = VRT_DATA_HEADER_WORDS;
+  uint32_t cif0 = CIF0_CHANGE;
+
+  pos++; /* cif0 goes here */
+
+  if ( ctx.has_freq ) {
+    cif0 |= CIF0_RF_FREQ;
+    put_fixed20( buf + pos, ctx.freq );
+    pos += 2;
+  }
+
+  if ( ctx.has_rate ) {
+    cif0 |= CIF0_SAMPLE_RATE;
+    put_fixed20( buf + pos, ctx.rate );
+    pos += 2;
+  }
+
+  if ( ctx.has_format ) {
+    unsigned item = FMT_SIGNED_FIXED;
+    unsigned bits = 8 * sample_format_size( ctx.format ) / 2;
+
+    if ( SAMPLE_FORMAT_CF32 == ctx.format )
+      item = FMT_IEEE754_SINGLE;
+
+    cif0 |= CIF0_PAYLOAD_FORMAT;
+    buf[pos++] = htonl( (FMT_COMPLEX_CARTESIAN << 29) | (item << 24) |
+                        ((bits - 1) << 6) | (bits - 1) );
+    buf[pos++] = 0; /* no repeats, vector size 1 */
+  }
+
+  buf[0] = htonl( make_header( VRT_PKT_CONTEXT, count, pos ) );
+  buf[1] = htonl( sid );
+  buf[2] = htonl( secs );
+  put_u64( buf + 3, ps );
+  buf[VRT_DATA_HEADER_WORDS] = htonl( cif0 );
+
+  return pos;
+}
+
+void vrt_swap_payload( void *buf, sample_format fmt, size_t num_samples )
+{
+  switch ( fmt ) {
+  case SAMPLE_FORMAT_SC16: {
+    uint16_t *p = (uint16_t *)buf;
+    for ( size_t i = 0; i < 2 * num_samples; i++ )
+      p[i] = ntohs( p[i] );
+    break;
+  }
+  case SAMPLE_FORMAT_CF32: {
+    uint32_t *p = (uint32_t *)buf;
+    for ( size_t i = 0; i < 2 * num_samples; i++ )
+      p[i] = ntohl( p[i] );
+    break;
+  }
+  default:
+    break; /* bytes need no swapping */
+  }
+}
@@ -0,0 +1,99 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef VRT_PACKET_H
+#define VRT_PACKET_H
+
+#include <string>
+
+#include <stdint.h>
+
+#include "sample_format.h"
+
+/*
+ * Minimal VITA-49.0 (VRT) packet support: IF data packets carrying complex
+ * samples and IF context packets carrying frequency, sample rate and
+ * payload format. All words are big-endian on the wire.
+ */
+
+#define VRT_PKT_DATA          0x0 /* IF data, no stream id */
+#define VRT_PKT_DATA_SID      0x1 /* IF data with stream id */
+#define VRT_PKT_CONTEXT       0x4 /* IF context */
+
+#define VRT_TSI_NONE          0
+#define VRT_TSI_UTC           1
+#define VRT_TSF_NONE          0
+#define VRT_TSF_SAMPLES       1
+#define VRT_TSF_PICOSECONDS   2
+
+/* header, stream id, integer and fractional timestamp */
+#define VRT_DATA_HEADER_WORDS 5
+
+#define VRT_MAX_PACKET_WORDS  0xffff
+
+struct vrt_packet
+{
+  unsigned type;
+  unsigned count;          /* modulo 16 sequence number */
+  bool has_sid;
+  uint32_t sid;
+  unsigned tsi;
+  unsigned tsf;
+  uint32_t secs;
+  uint64_t frac;           /* picoseconds or sample count, see tsf */
+  const uint32_t *payload; /* still in network byte order */
+  size_t payload_words;
+};
+
+struct vrt_context
+{
+  vrt_context() :
+    has_freq(false), freq(0), has_rate(false), rate(0),
+    has_format(false), format(SAMPLE_FORMAT_SC16) {}
+
+  bool has_freq;
+  double freq;
+  bool has_rate;
+  double rate;
+  bool has_format;
+  sample_format format;
+};
+
+/* returns false for truncated or unsupported packets */
+bool vrt_parse( const void *buf, size_t len, vrt_packet &pkt );
+
+/* returns false if the packet is no context packet or its format is unknown */
+bool vrt_parse_context( const vrt_packet &pkt, vrt_context &ctx );
+
+/* writes the header of a data packet with num_samples in front of the
+ * payload, returns the total packet size in words */
+size_t vrt_pack_data_header( uint32_t *buf, uint32_t sid, unsigned count,
+                             uint32_t secs, uint64_t ps,
+                             sample_format fmt, size_t num_samples );
+
+/* writes a whole context packet, returns its size in words */
+size_t vrt_pack_context( uint32_t *buf, uint32_t sid, unsigned count,
+                         uint32_t secs, uint64_t ps, const vrt_context &ctx );
+
+/* converts between host and network byte order in place */
+void vrt_swap_payload( void *buf, sample_format fmt, size_t num_samples );
+
+#endif // VRT_PACKET_H
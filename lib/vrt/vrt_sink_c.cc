@@ -0,0 +1,443 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+#include <sys/time.h>
+
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <gnuradio/io_signature.h>
+
+#include "vrt_sink_c.h"
+#include "driver_registry.h"
+
+#include "arg_helpers.h"
+
+#define DEFAULT_MTU       1500
+#define DEFAULT_BATCH     32
+#define DEFAULT_SNDBUF    (4 << 20)
+#define IP_UDP_OVERHEAD   28
+
+vrt_sink_c_sptr make_vrt_sink_c(const std::string &args)
+{
+  return gnuradio::get_initial_sptr(new vrt_sink_c(args));
+}
+
+vrt_sink_c::vrt_sink_c(const std::string &args) :
+  gr::sync_block("vrt_sink_c",
+                 args_to_io_signature(args),
+                 gr::io_signature::make(0, 0, 0)),
+  _nchan(1),
+  _sid(0),
+  _fmt(SAMPLE_FORMAT_SC16),
+  _mtu(DEFAULT_MTU),
+  _spp(0),
+  _queued(0),
+  _anchor_item(0),
+  _last_item(0),
+  _anchor_secs(0),
+  _anchor_frac(0),
+  _rate(0),
+  _freq(0),
+  _ctx_changed(true),
+  _ctx_interval(1.0),
+  _next_ctx_item(0),
+  _send_errors(0)
+{
+  dict_t dict = params_to_dict(args);
+
+  std::string addr;
+  if (dict.count("vrt"))
+    addr = dict["vrt"];
+  else if (dict.count("udp"))
+    addr = dict["udp"];
+
+  if (addr.empty() || addr.find(':') == std::string::npos)
+    throw std::runtime_error("Destination must be given as vrt=host:port.");
+
+  if (dict.count("nchan"))
+    _nchan = boost::lexical_cast< size_t >( dict["nchan"] );
+
+  if (dict.count("stream"))
+    _sid = boost::lexical_cast< uint32_t >( dict["stream"] );
+
+  if (dict.count("format"))
+    _fmt = parse_sample_format( dict["format"] );
+
+  if (dict.count("rate"))
+    _rate = boost::lexical_cast< double >( dict["rate"] );
+
+  if (dict.count("freq"))
+    _freq = boost::lexical_cast< double >( dict["freq"] );
+
+  if (dict.count("mtu"))
+    _mtu = boost::lexical_cast< size_t >( dict["mtu"] );
+
+  if (dict.count("context"))
+    _ctx_interval = boost::lexical_cast< double >( dict["context"] );
+
+  size_t batch = DEFAULT_BATCH;
+  if (dict.count("batch"))
+    batch = std::max( size_t(1), boost::lexical_cast< size_t >( dict["batch"] ) );
+
+  int sndbuf = DEFAULT_SNDBUF;
+  if (dict.count("sndbuf"))
+    sndbuf = boost::lexical_cast< int >( dict["sndbuf"] );
+
+  /* an even number of samples always fills whole words */
+  size_t max_words = std::min( size_t(VRT_MAX_PACKET_WORDS),
+                               _mtu > IP_UDP_OVERHEAD ? (_mtu - IP_UDP_OVERHEAD) / 4 : 0 );
+  if ( max_words > VRT_DATA_HEADER_WORDS )
+    _spp = ((max_words - VRT_DATA_HEADER_WORDS) * 4 / sample_format_size( _fmt )) & ~size_t(1);
+
+  if ( _spp < 2 )
+    throw std::runtime_error("MTU too small for VITA-49 packets.");
+
+  size_t pkt_size = max_words * 4;
+  _packets.resize( pkt_size * batch );
+  _bufs.resize( batch );
+  _lens.resize( batch );
+  for ( size_t i = 0; i < batch; i++ )
+    _bufs[i] = &_packets[i * pkt_size];
+
+  _data_count.resize( _nchan, 0 );
+  _ctx_count.resize( _nchan, 0 );
+
+  _socket.reset( new vrt_socket( addr, false, sndbuf ) );
+
+  set_output_multiple( _spp );
+
+  std::cerr << "Sending VITA-49 to " << addr << " (" << _spp
+            << " samples per packet)" << std::endl;
+}
+
+vrt_sink_c::~vrt_sink_c()
+{
+  if ( _send_errors )
+    std::cerr << "VITA-49: " << _send_errors << " send errors" << std::endl;
+}
+
+bool vrt_sink_c::start()
+{
+  struct timeval tv;
+  gettimeofday( &tv, NULL );
+
+  boost::mutex::scoped_lock lock( _lock );
+
+  reanchor( nitems_read(0), tv.tv_sec, tv.tv_usec * 1e-6 );
+  _last_item = nitems_read(0);
+  _ctx_changed = true;
+
+  return true;
+}
+
+void vrt_sink_c::reanchor( uint64_t item, uint32_t secs, double frac )
+{
+  _anchor_item = item;
+  _anchor_secs = secs;
+  _anchor_frac = frac;
+}
+
+void vrt_sink_c::timestamp( uint64_t item, uint32_t &secs, uint64_t &ps )
+{
+  double frac = _anchor_frac;
+
+  if ( _rate > 0 )
+    frac += double( int64_t( item - _anchor_item ) ) / _rate;
+
+  double whole = floor( frac );
+
+  secs = _anchor_secs + int64_t( whole );
+  ps = uint64_t( llround( (frac - whole) * 1e12 ) );
+
+  if ( ps >= 1000000000000ULL ) {
+    ps -= 1000000000000ULL;
+    secs++;
+  }
+}
+
+/* keep the timestamps continuous across rate changes */
+void vrt_sink_c::change_rate( uint64_t item, double rate )
+{
+  if ( rate == _rate )
+    return;
+
+  uint32_t secs;
+  uint64_t ps;
+  timestamp( item, secs, ps );
+  reanchor( item, secs, ps * 1e-12 );
+
+  _rate = rate;
+  _ctx_changed = true;
+}
+
+char *vrt_sink_c::next_packet()
+{
+  if ( _queued == _bufs.size() )
+    flush();
+
+  return _bufs[_queued++];
+}
+
+void vrt_sink_c::flush()
+{
+  if ( ! _queued )
+    return;
+
+  if ( ! _socket->send( &_bufs[0], &_lens[0], _queued ) ) {
+    _send_errors++;
+    std::cerr << "S" << std::flush;
+  }
+
+  _queued = 0;
+}
+
+void vrt_sink_c::send_context()
+{
+  vrt_context ctx;
+  uint32_t secs;
+  uint64_t ps;
+
+  ctx.has_freq = true;
+  ctx.freq = _freq;
+  ctx.has_rate = _rate > 0;
+  ctx.rate = _rate;
+  ctx.has_format = true;
+  ctx.format = _fmt;
+
+  timestamp( _last_item, secs, ps );
+
+  for ( size_t chan = 0; chan < _nchan; chan++ ) {
+    uint32_t *buf = (uint32_t *)next_packet();
+    size_t words = vrt_pack_context( buf, _sid + chan, _ctx_count[chan]++,
+                                     secs, ps, ctx );
+    _lens[_queued - 1] = words * 4;
+  }
+
+  _ctx_changed = false;
+  _next_ctx_item = _last_item + uint64_t( _ctx_interval * std::max( _rate, 1.0 ) );
+}
+
+int vrt_sink_c::work( int noutput_items,
+                      gr_vector_const_void_star &input_items,
+                      gr_vector_void_star &output_items )
+{
+  boost::mutex::scoped_lock lock( _lock );
+
+  uint64_t first = nitems_read(0);
+
+  std::vector< gr::tag_t > tags;
+  get_tags_in_range( tags, 0, first, first + noutput_items );
+  std::sort( tags.begin(), tags.end(), gr::tag_t::offset_compare );
+
+  std::vector< gr::tag_t >::iterator tag = tags.begin();
+
+  for ( int done = 0; done < noutput_items; done += _spp ) {
+    size_t len = std::min( size_t(noutput_items - done), _spp );
+
+    _last_item = first + done;
+
+    /* tags inside the packet apply to all of it */
+    for ( ; tag != tags.end() && tag->offset < _last_item + len; ++tag ) {
+      if ( pmt::eq( tag->key, pmt::mp("rx_time") ) && pmt::is_tuple( tag->value ) &&
+           pmt::length( tag->value ) == 2 ) {
+        reanchor( tag->offset,
+                  pmt::to_uint64( pmt::tuple_ref( tag->value, 0 ) ),
+                  pmt::to_double( pmt::tuple_ref( tag->value, 1 ) ) );
+      } else if ( pmt::eq( tag->key, pmt::mp("rx_rate") ) && pmt::is_number( tag->value ) ) {
+        change_rate( tag->offset, pmt::to_double( tag->value ) );
+      } else if ( pmt::eq( tag->key, pmt::mp("rx_freq") ) && pmt::is_number( tag->value ) ) {
+        _freq = pmt::to_double( tag->value );
+        _ctx_changed = true;
+      }
+    }
+
+    if ( _ctx_changed || _last_item >= _next_ctx_item )
+      send_context();
+
+    uint32_t secs;
+    uint64_t ps;
+    timestamp( _last_item, secs, ps );
+
+    for ( size_t chan = 0; chan < _nchan; chan++ ) {
+      const gr_complex *in = (const gr_complex *)input_items[chan] + done;
+      uint32_t *buf = (uint32_t *)next_packet();
+
+      size_t words = vrt_pack_data_header( buf, _sid + chan, _data_count[chan]++,
+                                           secs, ps, _fmt, len );
+
+      uint32_t *payload = buf + VRT_DATA_HEADER_WORDS;
+      payload[words - VRT_DATA_HEADER_WORDS - 1] = 0; /* padding of odd sc8 packets */
+
+      sample_format_pack( _fmt, in, payload, len );
+      vrt_swap_payload( payload, _fmt, len );
+
+      _lens[_queued - 1] = words * 4;
+    }
+  }
+
+  flush();
+
+  _last_item = first + noutput_items;
+
+  return noutput_items;
+}
+
+std::string vrt_sink_c::name()
+{
+  return "VITA-49 Transmitter";
+}
+
+std::vector<std::string> vrt_sink_c::get_devices( bool fake )
+{
+  std::vector<std::string> devices;
+
+  if ( fake )
+  {
+    std::string args = "vrt=127.0.0.1:49152,rate=1e6,freq=100e6";
+    args += ",label='VITA-49 Transmitter'";
+    devices.push_back( args );
+  }
+
+  return devices;
+}
+
+size_t vrt_sink_c::get_num_channels( void )
+{
+  return _nchan;
+}
+
+osmosdr::meta_range_t vrt_sink_c::get_sample_rates( void )
+{
+  osmosdr::meta_range_t range;
+
+  range += osmosdr::range_t( 1, 1e9 ); /* the network is the limit */
+
+  return range;
+}
+
+double vrt_sink_c::set_sample_rate( double rate )
+{
+  boost::mutex::scoped_lock lock( _lock );
+
+  change_rate( _last_item, rate );
+
+  return _rate;
+}
+
+double vrt_sink_c::get_sample_rate( void )
+{
+  boost::mutex::scoped_lock lock( _lock );
+
+  return _rate;
+}
+
+osmosdr::freq_range_t vrt_sink_c::get_freq_range( size_t chan )
+{
+  return osmosdr::freq_range_t( 0, 1e12 );
+}
+
+double vrt_sink_c::set_center_freq( double freq, size_t chan )
+{
+  boost::mutex::scoped_lock lock( _lock );
+
+  if ( freq != _freq ) {
+    _freq = freq;
+    _ctx_changed = true;
+  }
+
+  return _freq;
+}
+
+double vrt_sink_c::get_center_freq( size_t chan )
+{
+  boost::mutex::scoped_lock lock( _lock );
+
+  return _freq;
+}
+
+double vrt_sink_c::set_freq_corr( double ppm, size_t chan )
+{
+  return get_freq_corr( chan );
+}
+
+double vrt_sink_c::get_freq_corr( size_t chan )
+{
+  return 0;
+}
+
+std::vector<std::string> vrt_sink_c::get_gain_names( size_t chan )
+{
+  return std::vector< std::string >();
+}
+
+osmosdr::gain_range_t vrt_sink_c::get_gain_range( size_t chan )
+{
+  return osmosdr::gain_range_t();
+}
+
+osmosdr::gain_range_t vrt_sink_c::get_gain_range( const std::string & name, size_t chan )
+{
+  return get_gain_range( chan );
+}
+
+double vrt_sink_c::set_gain( double gain, size_t chan )
+{
+  return get_gain( chan );
+}
+
+double vrt_sink_c::set_gain( double gain, const std::string & name, size_t chan )
+{
+  return set_gain( gain, chan );
+}
+
+double vrt_sink_c::get_gain( size_t chan )
+{
+  return 0;
+}
+
+double vrt_sink_c::get_gain( const std::string & name, size_t chan )
+{
+  return get_gain( chan );
+}
+
+std::vector< std::string > vrt_sink_c::get_antennas( size_t chan )
+{
+  return std::vector< std::string >();
+}
+
+std::string vrt_sink_c::set_antenna( const std::string & antenna, size_t chan )
+{
+  return get_antenna( chan );
+}
+
+std::string vrt_sink_c::get_antenna( size_t chan )
+{
+  return "";
+}
+
+OSMOSDR_REGISTER_SINK( vrt, "vrt udp", PROBE_SOFTWARE,
+                         make_vrt_sink_c, vrt_sink_c::get_devices( fake ) );
@@ -0,0 +1,132 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef VRT_SINK_C_H
+#define VRT_SINK_C_H
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <gnuradio/sync_block.h>
+
+#include "sink_iface.h"
+#include "vrt_packet.h"
+#include "vrt_socket.h"
+
+class vrt_sink_c;
+
+typedef boost::shared_ptr< vrt_sink_c > vrt_sink_c_sptr;
+
+vrt_sink_c_sptr make_vrt_sink_c( const std::string & args = "" );
+
+/*!
+ * Sends the input as VITA-49 IF data packets over UDP, one stream id per
+ * channel, timestamped in UTC. The timestamps follow the system clock from
+ * the start and the "rx_time" tags of the first input once they appear.
+ * Context packets with the frequency, rate and payload format are sent on
+ * every change and once per context interval.
+ */
+class vrt_sink_c :
+    public gr::sync_block,
+    public sink_iface
+{
+private:
+  friend vrt_sink_c_sptr make_vrt_sink_c(const std::string &args);
+
+  vrt_sink_c(const std::string &args);
+
+public:
+  ~vrt_sink_c();
+
+  bool start();
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  std::string name();
+
+  static std::vector< std::string > get_devices( bool fake = false );
+
+  size_t get_num_channels( void );
+
+  osmosdr::meta_range_t get_sample_rates( void );
+  double set_sample_rate( double rate );
+  double get_sample_rate( void );
+
+  osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
+  double set_center_freq( double freq, size_t chan = 0 );
+  double get_center_freq( size_t chan = 0 );
+  double set_freq_corr( double ppm, size_t chan = 0 );
+  double get_freq_corr( size_t chan = 0 );
+
+  std::vector<std::string> get_gain_names( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( const std::string & name, size_t chan = 0 );
+  double set_gain( double gain, size_t chan = 0 );
+  double set_gain( double gain, const std::string & name, size_t chan = 0 );
+  double get_gain( size_t chan = 0 );
+  double get_gain( const std::string & name, size_t chan = 0 );
+
+  std::vector< std::string > get_antennas( size_t chan = 0 );
+  std::string set_antenna( const std::string & antenna, size_t chan = 0 );
+  std::string get_antenna( size_t chan = 0 );
+
+private:
+  void timestamp( uint64_t item, uint32_t &secs, uint64_t &ps );
+  void reanchor( uint64_t item, uint32_t secs, double frac );
+  void change_rate( uint64_t item, double rate );
+  void send_context();
+  char *next_packet();
+  void flush();
+
+  boost::scoped_ptr< vrt_socket > _socket;
+
+  size_t _nchan;
+  uint32_t _sid;
+  sample_format _fmt;
+  size_t _mtu;
+  size_t _spp;              /* samples per packet */
+
+  std::vector< char > _packets;
+  std::vector< char * > _bufs;
+  std::vector< size_t > _lens;
+  size_t _queued;
+
+  std::vector< unsigned > _data_count;
+  std::vector< unsigned > _ctx_count;
+
+  /* the timestamp of sample _anchor_item */
+  uint64_t _anchor_item;
+  uint64_t _last_item;
+  uint32_t _anchor_secs;
+  double _anchor_frac;
+
+  boost::mutex _lock;
+  double _rate;
+  double _freq;
+  bool _ctx_changed;
+  double _ctx_interval;     /* seconds */
+  uint64_t _next_ctx_item;
+  uint64_t _send_errors;
+};
+
+#endif // VRT_SINK_C_H
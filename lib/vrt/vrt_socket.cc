@@ -0,0 +1,189 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include "vrt_socket.h"
+
+vrt_socket::vrt_socket( const std::string &addr, bool receiver, int bufsize ) :
+  _fd(-1)
+{
+  std::string host, port = addr;
+
+  size_t colon = addr.rfind( ':' );
+  if ( colon != std::string::npos ) {
+    host = addr.substr( 0, colon );
+    port = addr.substr( colon + 1 );
+  }
+
+  if ( ! receiver && host.empty() )
+    host = "127.0.0.1";
+
+  memset( &_peer, 0, sizeof(_peer) );
+  _peer.sin_family = AF_INET;
+  _peer.sin_port = htons( boost::lexical_cast< unsigned short >( port ) );
+  _peer.sin_addr.s_addr = htonl( INADDR_ANY );
+
+  if ( ! host.empty() ) {
+    struct addrinfo hints, *res = NULL;
+    memset( &hints, 0, sizeof(hints) );
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    if ( getaddrinfo( host.c_str(), NULL, &hints, &res ) != 0 || ! res )
+      throw std::runtime_error( "Unknown host '" + host + "'." );
+
+    _peer.sin_addr = ((struct sockaddr_in *)res->ai_addr)->sin_addr;
+    freeaddrinfo( res );
+  }
+
+  if ( (_fd = socket( AF_INET, SOCK_DGRAM, 0 )) < 0 )
+    throw std::runtime_error( "Could not create UDP socket." );
+
+  int opt = 1;
+  setsockopt( _fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt) );
+
+  /* the kernel may cap this, losing packets is still better reported
+   * than silently tolerated */
+  setsockopt( _fd, SOL_SOCKET, receiver ? SO_RCVBUF : SO_SNDBUF,
+              &bufsize, sizeof(bufsize) );
+
+  if ( ! receiver )
+    return;
+
+  bool multicast = IN_MULTICAST( ntohl( _peer.sin_addr.s_addr ) );
+
+  struct sockaddr_in local = _peer;
+  if ( multicast )
+    local.sin_addr.s_addr = htonl( INADDR_ANY );
+
+  if ( bind( _fd, (struct sockaddr *)&local, sizeof(local) ) < 0 ) {
+    std::string err = strerror( errno );
+    close( _fd );
+    throw std::runtime_error( "Could not bind UDP socket to " + addr + ": " + err );
+  }
+
+  if ( multicast ) {
+    struct ip_mreq mreq;
+    mreq.imr_multiaddr = _peer.sin_addr;
+    mreq.imr_interface.s_addr = htonl( INADDR_ANY );
+
+    if ( setsockopt( _fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq) ) < 0 ) {
+      close( _fd );
+      throw std::runtime_error( "Could not join multicast group " + host + "." );
+    }
+  }
+}
+
+vrt_socket::~vrt_socket()
+{
+  close( _fd );
+}
+
+size_t vrt_socket::recv( char *buf, size_t mtu, size_t count, size_t *lens, int timeout_ms )
+{
+  struct pollfd pfd;
+  pfd.fd = _fd;
+  pfd.events = POLLIN;
+
+  if ( poll( &pfd, 1, timeout_ms ) <= 0 )
+    return 0;
+
+#ifdef HAVE_RECVMMSG
+  std::vector< struct mmsghdr > msgs( count );
+  std::vector< struct iovec > iovs( count );
+
+  for ( size_t i = 0; i < count; i++ ) {
+    iovs[i].iov_base = buf + i * mtu;
+    iovs[i].iov_len = mtu;
+    memset( &msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr) );
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int ret = recvmmsg( _fd, &msgs[0], count, MSG_DONTWAIT, NULL );
+  if ( ret < 0 )
+    return 0;
+
+  for ( int i = 0; i < ret; i++ )
+    lens[i] = msgs[i].msg_len;
+
+  return ret;
+#else
+  size_t num = 0;
+
+  while ( num < count ) {
+    ssize_t len = ::recv( _fd, buf + num * mtu, mtu, MSG_DONTWAIT );
+    if ( len < 0 )
+      break;
+
+    lens[num++] = len;
+  }
+
+  return num;
+#endif
+}
+
+bool vrt_socket::send( char * const *bufs, const size_t *lens, size_t count )
+{
+#ifdef HAVE_SENDMMSG
+  std::vector< struct mmsghdr > msgs( count );
+  std::vector< struct iovec > iovs( count );
+
+  for ( size_t i = 0; i < count; i++ ) {
+    iovs[i].iov_base = bufs[i];
+    iovs[i].iov_len = lens[i];
+    memset( &msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr) );
+    msgs[i].msg_hdr.msg_name = &_peer;
+    msgs[i].msg_hdr.msg_namelen = sizeof(_peer);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  size_t sent = 0;
+  while ( sent < count ) {
+    int ret = sendmmsg( _fd, &msgs[sent], count - sent, 0 );
+    if ( ret <= 0 )
+      return false;
+
+    sent += ret;
+  }
+#else
+  for ( size_t i = 0; i < count; i++ )
+    if ( sendto( _fd, bufs[i], lens[i], 0,
+                 (struct sockaddr *)&_peer, sizeof(_peer) ) < 0 )
+      return false;
+#endif
+
+  return true;
+}
@@ -0,0 +1,59 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef VRT_SOCKET_H
+#define VRT_SOCKET_H
+
+#include <string>
+#include <vector>
+
+#include <netinet/in.h>
+
+/*!
+ * UDP socket moving datagrams in batches, through recvmmsg()/sendmmsg()
+ * where available to save a system call per packet.
+ */
+class vrt_socket
+{
+public:
+  /*!
+   * A receiving socket binds to "[host:]port", joining the group if host
+   * is a multicast address. A sending socket sends to "host:port".
+   */
+  vrt_socket( const std::string &addr, bool receiver, int bufsize );
+  ~vrt_socket();
+
+  /*!
+   * Receives up to count datagrams of at most mtu bytes into consecutive
+   * slots of buf, storing their lengths. Waits at most timeout_ms for the
+   * first one, returns the number received.
+   */
+  size_t recv( char *buf, size_t mtu, size_t count, size_t *lens, int timeout_ms );
+
+  /*! Sends count datagrams, returns false if some could not be sent. */
+  bool send( char * const *bufs, const size_t *lens, size_t count );
+
+private:
+  int _fd;
+  struct sockaddr_in _peer;
+};
+
+#endif // VRT_SOCKET_H
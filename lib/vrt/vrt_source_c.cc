@@ -0,0 +1,467 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <gnuradio/io_signature.h>
+
+#include "vrt_source_c.h"
+#include "driver_registry.h"
+
+#include "arg_helpers.h"
+
+#define DEFAULT_PORT    "49152"
+#define DEFAULT_MTU     9000    /* fits jumbo frames */
+#define DEFAULT_BATCH   32      /* datagrams per system call */
+#define DEFAULT_BUFFER  (1 << 20)
+#define DEFAULT_RCVBUF  (8 << 20)
+
+vrt_source_c_sptr make_vrt_source_c(const std::string &args)
+{
+  return gnuradio::get_initial_sptr(new vrt_source_c(args));
+}
+
+static size_t parse_nchan( const std::string &args )
+{
+  dict_t dict = params_to_dict(args);
+
+  if (dict.count("nchan"))
+    return boost::lexical_cast< size_t >( dict["nchan"] );
+
+  return 1;
+}
+
+vrt_source_c::vrt_source_c(const std::string &args) :
+  gr::sync_block("vrt_source_c",
+                 gr::io_signature::make(0, 0, 0),
+                 args_to_io_signature(args)),
+  _running(false),
+  _mtu(DEFAULT_MTU),
+  _batch(DEFAULT_BATCH),
+  _any_sid(true),
+  _sid(0),
+  _fmt(SAMPLE_FORMAT_SC16),
+  _rate(0),
+  _freq(0),
+  _lost_packets(0),
+  _malformed(0)
+{
+  dict_t dict = params_to_dict(args);
+
+  std::string addr = DEFAULT_PORT;
+  if (dict.count("vrt") && dict["vrt"].length())
+    addr = dict["vrt"];
+  else if (dict.count("udp") && dict["udp"].length())
+    addr = dict["udp"];
+
+  size_t nchan = parse_nchan( args );
+  if ( nchan < 1 )
+    throw std::runtime_error("Number of channels must be at least 1.");
+
+  /* without explicit stream ids a single channel follows the first one seen */
+  if (dict.count("stream")) {
+    _sid = boost::lexical_cast< uint32_t >( dict["stream"] );
+    _any_sid = false;
+  } else if ( nchan > 1 ) {
+    _any_sid = false;
+  }
+
+  if (dict.count("format"))
+    _fmt = parse_sample_format( dict["format"] );
+
+  if (dict.count("rate"))
+    _rate = boost::lexical_cast< double >( dict["rate"] );
+
+  if (dict.count("freq"))
+    _freq = boost::lexical_cast< double >( dict["freq"] );
+
+  if (dict.count("mtu"))
+    _mtu = boost::lexical_cast< size_t >( dict["mtu"] );
+
+  _mtu = (_mtu + 3) & ~size_t(3); /* keep the packets word aligned */
+
+  if (dict.count("batch"))
+    _batch = std::max( size_t(1), boost::lexical_cast< size_t >( dict["batch"] ) );
+
+  size_t buffer = DEFAULT_BUFFER;
+  if (dict.count("buffer"))
+    buffer = boost::lexical_cast< size_t >( dict["buffer"] );
+
+  int rcvbuf = DEFAULT_RCVBUF;
+  if (dict.count("rcvbuf"))
+    rcvbuf = boost::lexical_cast< int >( dict["rcvbuf"] );
+
+  _chans.resize( nchan );
+  for ( size_t i = 0; i < nchan; i++ )
+    _chans[i].fifo.set_capacity( buffer );
+
+  _scratch.resize( _mtu / 2 ); /* enough for the smallest sample format */
+
+  _socket.reset( new vrt_socket( addr, true, rcvbuf ) );
+
+  std::cerr << "Receiving VITA-49 on " << addr << " (" << nchan
+            << " channel" << (nchan > 1 ? "s" : "") << ")" << std::endl;
+}
+
+vrt_source_c::~vrt_source_c()
+{
+  if ( _lost_packets || _malformed )
+    std::cerr << "VITA-49: " << _lost_packets << " packets lost, "
+              << _malformed << " malformed" << std::endl;
+}
+
+bool vrt_source_c::start()
+{
+  for ( size_t i = 0; i < _chans.size(); i++ ) {
+    size_t capacity = _chans[i].fifo.capacity();
+    _chans[i] = channel();
+    _chans[i].fifo.set_capacity( capacity );
+  }
+
+  _running = true;
+  _thread = gr::thread::thread( boost::bind(&vrt_source_c::receive_task, this) );
+
+  return true;
+}
+
+bool vrt_source_c::stop()
+{
+  _running = false;
+
+  if ( _thread.joinable() )
+    _thread.join();
+
+  _samp_avail.notify_all();
+
+  return true;
+}
+
+void vrt_source_c::receive_task()
+{
+  std::vector< char > buf( _mtu * _batch );
+  std::vector< size_t > lens( _batch );
+
+  while ( _running ) {
+    size_t num = _socket->recv( &buf[0], _mtu, _batch, &lens[0], 100 );
+    if ( ! num )
+      continue;
+
+    {
+      boost::mutex::scoped_lock lock( _lock );
+
+      for ( size_t i = 0; i < num; i++ )
+        handle_packet( &buf[i * _mtu], lens[i] );
+    }
+
+    _samp_avail.notify_one();
+  }
+}
+
+void vrt_source_c::queue_tag( channel &ch, const char *key, const pmt::pmt_t &value )
+{
+  gr::tag_t tag;
+
+  tag.offset = ch.pushed;
+  tag.key = pmt::intern( key );
+  tag.value = value;
+
+  ch.tags.push_back( tag );
+}
+
+/* called with _lock held */
+void vrt_source_c::handle_packet( char *buf, size_t len )
+{
+  vrt_packet pkt;
+
+  if ( ! vrt_parse( buf, len, pkt ) ) {
+    _malformed++;
+    return;
+  }
+
+  if ( _any_sid && pkt.has_sid ) {
+    _sid = pkt.sid;
+    _any_sid = false;
+  }
+
+  size_t chan = 0;
+  if ( ! _any_sid ) {
+    if ( ! pkt.has_sid || pkt.sid - _sid >= _chans.size() )
+      return; /* somebody else's stream */
+
+    chan = pkt.sid - _sid;
+  }
+
+  channel &ch = _chans[chan];
+
+  if ( VRT_PKT_CONTEXT == pkt.type ) {
+    vrt_context ctx;
+
+    if ( ! vrt_parse_context( pkt, ctx ) ) {
+      _malformed++;
+      return;
+    }
+
+    if ( ctx.has_freq && ctx.freq != _freq ) {
+      _freq = ctx.freq;
+      queue_tag( ch, "rx_freq", pmt::from_double( _freq ) );
+    }
+
+    if ( ctx.has_rate && ctx.rate != _rate ) {
+      _rate = ctx.rate;
+      queue_tag( ch, "rx_rate", pmt::from_double( _rate ) );
+      ch.time_valid = false;
+      ch.retag = true;
+    }
+
+    if ( ctx.has_format )
+      _fmt = ctx.format;
+
+    return;
+  }
+
+  /* data and context packets are counted separately */
+  if ( ch.seq_valid && pkt.count != ch.next_seq ) {
+    _lost_packets += (pkt.count - ch.next_seq) & 0xf;
+    std::cerr << "D" << std::flush;
+    ch.retag = true;
+  }
+
+  ch.seq_valid = true;
+  ch.next_seq = (pkt.count + 1) & 0xf;
+
+  size_t num = std::min( pkt.payload_words * 4 / sample_format_size( _fmt ),
+                         _scratch.size() );
+
+  bool has_time = ( pkt.tsi != VRT_TSI_NONE );
+  double frac = 0;
+
+  if ( VRT_TSF_PICOSECONDS == pkt.tsf )
+    frac = pkt.frac * 1e-12;
+  else if ( VRT_TSF_SAMPLES == pkt.tsf && _rate > 0 )
+    frac = pkt.frac / _rate;
+
+  /* the timestamps also reveal losses of multiples of 16 packets */
+  if ( has_time && _rate > 0 ) {
+    if ( ch.time_valid && ! ch.retag ) {
+      double diff = (double(pkt.secs) - double(ch.next_secs)) + (frac - ch.next_frac);
+
+      if ( fabs( diff ) * _rate > 0.5 ) {
+        std::cerr << "D" << std::flush;
+        ch.retag = true;
+      }
+    }
+
+    double next = frac + num / _rate;
+    double whole = floor( next );
+
+    ch.next_secs = pkt.secs + uint32_t( whole );
+    ch.next_frac = next - whole;
+    ch.time_valid = true;
+  }
+
+  if ( ch.fifo.capacity() - ch.fifo.size() < num ) {
+    std::cerr << "O" << std::flush;
+    ch.retag = true;
+    return;
+  }
+
+  if ( ch.retag && has_time )
+    queue_tag( ch, "rx_time", pmt::make_tuple( pmt::from_uint64( pkt.secs ),
+                                               pmt::from_double( frac ) ) );
+  ch.retag = false;
+
+  /* the receive buffer is ours, swap in place */
+  vrt_swap_payload( (void *)pkt.payload, _fmt, num );
+  sample_format_unpack( _fmt, pkt.payload, &_scratch[0], num );
+
+  ch.fifo.insert( ch.fifo.end(), _scratch.begin(), _scratch.begin() + num );
+  ch.pushed += num;
+}
+
+int vrt_source_c::work( int noutput_items,
+                        gr_vector_const_void_star &input_items,
+                        gr_vector_void_star &output_items )
+{
+  boost::unique_lock< boost::mutex > lock( _lock );
+
+  size_t avail = noutput_items;
+  for ( size_t i = 0; i < _chans.size(); i++ )
+    avail = std::min( avail, _chans[i].fifo.size() );
+
+  if ( ! avail && _running ) {
+    _samp_avail.timed_wait( lock, boost::posix_time::milliseconds(100) );
+
+    avail = noutput_items;
+    for ( size_t i = 0; i < _chans.size(); i++ )
+      avail = std::min( avail, _chans[i].fifo.size() );
+  }
+
+  for ( size_t i = 0; i < _chans.size(); i++ ) {
+    channel &ch = _chans[i];
+    gr_complex *out = (gr_complex *)output_items[i];
+
+    std::copy( ch.fifo.begin(), ch.fifo.begin() + avail, out );
+    ch.fifo.erase_begin( avail );
+
+    uint64_t end = nitems_written(i) + avail;
+
+    while ( ! ch.tags.empty() && ch.tags.front().offset < end ) {
+      gr::tag_t tag = ch.tags.front();
+      tag.offset = std::max( tag.offset, nitems_written(i) );
+      add_item_tag( i, tag );
+      ch.tags.pop_front();
+    }
+  }
+
+  return avail;
+}
+
+std::string vrt_source_c::name()
+{
+  return "VITA-49 Receiver";
+}
+
+std::vector<std::string> vrt_source_c::get_devices( bool fake )
+{
+  std::vector<std::string> devices;
+
+  if ( fake )
+  {
+    std::string args = "vrt=" DEFAULT_PORT;
+    args += ",label='VITA-49 Receiver'";
+    devices.push_back( args );
+  }
+
+  return devices;
+}
+
+size_t vrt_source_c::get_num_channels( void )
+{
+  return _chans.size();
+}
+
+osmosdr::meta_range_t vrt_source_c::get_sample_rates( void )
+{
+  osmosdr::meta_range_t range;
+
+  range += osmosdr::range_t( get_sample_rate() );
+
+  return range;
+}
+
+/* the sender owns the stream, context packets tell us what it does */
+double vrt_source_c::set_sample_rate( double rate )
+{
+  return get_sample_rate();
+}
+
+double vrt_source_c::get_sample_rate( void )
+{
+  boost::mutex::scoped_lock lock( _lock );
+
+  return _rate;
+}
+
+osmosdr::freq_range_t vrt_source_c::get_freq_range( size_t chan )
+{
+  return osmosdr::freq_range_t( get_center_freq( chan ) );
+}
+
+double vrt_source_c::set_center_freq( double freq, size_t chan )
+{
+  return get_center_freq( chan );
+}
+
+double vrt_source_c::get_center_freq( size_t chan )
+{
+  boost::mutex::scoped_lock lock( _lock );
+
+  return _freq;
+}
+
+double vrt_source_c::set_freq_corr( double ppm, size_t chan )
+{
+  return get_freq_corr( chan );
+}
+
+double vrt_source_c::get_freq_corr( size_t chan )
+{
+  return 0;
+}
+
+std::vector<std::string> vrt_source_c::get_gain_names( size_t chan )
+{
+  return std::vector< std::string >();
+}
+
+osmosdr::gain_range_t vrt_source_c::get_gain_range( size_t chan )
+{
+  return osmosdr::gain_range_t();
+}
+
+osmosdr::gain_range_t vrt_source_c::get_gain_range( const std::string & name, size_t chan )
+{
+  return get_gain_range( chan );
+}
+
+double vrt_source_c::set_gain( double gain, size_t chan )
+{
+  return get_gain( chan );
+}
+
+double vrt_source_c::set_gain( double gain, const std::string & name, size_t chan )
+{
+  return set_gain( gain, chan );
+}
+
+double vrt_source_c::get_gain( size_t chan )
+{
+  return 0;
+}
+
+double vrt_source_c::get_gain( const std::string & name, size_t chan )
+{
+  return get_gain( chan );
+}
+
+std::vector< std::string > vrt_source_c::get_antennas( size_t chan )
+{
+  return std::vector< std::string >();
+}
+
+std::string vrt_source_c::set_antenna( const std::string & antenna, size_t chan )
+{
+  return get_antenna( chan );
+}
+
+std::string vrt_source_c::get_antenna( size_t chan )
+{
+  return "";
+}
+
+OSMOSDR_REGISTER_SOURCE( vrt, "vrt udp", PROBE_SOFTWARE,
+                         make_vrt_source_c, vrt_source_c::get_devices( fake ) );
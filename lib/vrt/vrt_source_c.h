@@ -0,0 +1,145 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef VRT_SOURCE_C_H
+#define VRT_SOURCE_C_H
+
+#include <deque>
+
+#include <boost/circular_buffer.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <gnuradio/sync_block.h>
+#include <gnuradio/thread/thread.h>
+
+#include "source_iface.h"
+#include "vrt_packet.h"
+#include "vrt_socket.h"
+
+class vrt_source_c;
+
+typedef boost::shared_ptr< vrt_source_c > vrt_source_c_sptr;
+
+vrt_source_c_sptr make_vrt_source_c( const std::string & args = "" );
+
+/*!
+ * Receives VITA-49 IF data packets over UDP, one stream id per channel.
+ *
+ * Packet timestamps are reported as "rx_time" tags on the first sample
+ * and after every gap, which is detected from the sequence count and the
+ * timestamps. Context packets update the frequency, sample rate and
+ * payload format and are reported as "rx_freq" and "rx_rate" tags.
+ */
+class vrt_source_c :
+    public gr::sync_block,
+    public source_iface
+{
+private:
+  friend vrt_source_c_sptr make_vrt_source_c(const std::string &args);
+
+  vrt_source_c(const std::string &args);
+
+public:
+  ~vrt_source_c();
+
+  bool start();
+  bool stop();
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  std::string name();
+
+  static std::vector< std::string > get_devices( bool fake = false );
+
+  size_t get_num_channels( void );
+
+  osmosdr::meta_range_t get_sample_rates( void );
+  double set_sample_rate( double rate );
+  double get_sample_rate( void );
+
+  osmosdr::freq_range_t get_freq_range( size_t chan = 0 );
+  double set_center_freq( double freq, size_t chan = 0 );
+  double get_center_freq( size_t chan = 0 );
+  double set_freq_corr( double ppm, size_t chan = 0 );
+  double get_freq_corr( size_t chan = 0 );
+
+  std::vector<std::string> get_gain_names( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( size_t chan = 0 );
+  osmosdr::gain_range_t get_gain_range( const std::string & name, size_t chan = 0 );
+  double set_gain( double gain, size_t chan = 0 );
+  double set_gain( double gain, const std::string & name, size_t chan = 0 );
+  double get_gain( size_t chan = 0 );
+  double get_gain( const std::string & name, size_t chan = 0 );
+
+  std::vector< std::string > get_antennas( size_t chan = 0 );
+  std::string set_antenna( const std::string & antenna, size_t chan = 0 );
+  std::string get_antenna( size_t chan = 0 );
+
+private:
+  struct channel
+  {
+    channel() :
+      fifo(1), pushed(0), seq_valid(false), next_seq(0),
+      time_valid(false), next_secs(0), next_frac(0), retag(true) {}
+
+    boost::circular_buffer< gr_complex > fifo;
+    std::deque< gr::tag_t > tags;
+    uint64_t pushed;       /* samples ever queued */
+
+    bool seq_valid;
+    unsigned next_seq;
+    bool time_valid;
+    uint32_t next_secs;    /* expected timestamp of the next packet */
+    double next_frac;
+    bool retag;            /* tag rx_time on the next packet */
+  };
+
+  void receive_task();
+  void handle_packet( char *buf, size_t len );
+  void queue_tag( channel &ch, const char *key, const pmt::pmt_t &value );
+
+  boost::scoped_ptr< vrt_socket > _socket;
+  gr::thread::thread _thread;
+  volatile bool _running;
+
+  size_t _mtu;
+  size_t _batch;
+  bool _any_sid;
+  uint32_t _sid;
+
+  boost::mutex _lock;
+  boost::condition_variable _samp_avail;
+  std::vector< channel > _chans;
+  std::vector< gr_complex > _scratch;
+
+  sample_format _fmt;
+  double _rate;
+  double _freq;
+
+  uint64_t _lost_packets;
+  uint64_t _malformed;
+};
+
+#endif // VRT_SOURCE_C_H
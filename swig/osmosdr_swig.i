@@ -12,6 +12,8 @@
 
 %{
 #include "osmosdr/device.h"
+#include "osmosdr/channel_settings.h"
+#include "osmosdr/hop.h"
 #include "osmosdr/source.h"
 #include "osmosdr/sink.h"
 %}
@@ -47,6 +49,11 @@
 
 %include <osmosdr/time_spec.h>
 
+%include <osmosdr/channel_settings.h>
+
+%include <osmosdr/hop.h>
+%template(hop_schedule_t) std::vector<osmosdr::hop_t>;
+
 %extend osmosdr::time_spec_t{
     osmosdr::time_spec_t __add__(const osmosdr::time_spec_t &what)
     {
@@ -70,6 +77,15 @@ BASE_NAME = BASE_NAME.make;
 %}
 %enddef
 
+// futures have no python counterpart, the synchronous setters are used there
+%ignore osmosdr::source::set_sample_rate_async;
+%ignore osmosdr::source::set_center_freq_async;
+%ignore osmosdr::source::set_freq_corr_async;
+%ignore osmosdr::source::set_gain_async;
+%ignore osmosdr::source::set_if_gain_async;
+%ignore osmosdr::source::set_bb_gain_async;
+%ignore osmosdr::source::set_bandwidth_async;
+
 %include "osmosdr/source.h"
 %include "osmosdr/sink.h"
 